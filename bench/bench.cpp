@@ -0,0 +1,480 @@
+// ************************************************************************** //
+//                                  bench                                     //
+//                                                                            //
+//           Замер скорости calculateBody при различном порядке обращений     //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Для каждого способа обращения и каждого режима вычислений (POSITION,       //
+// STATE) заранее формируется набор моментов времени, после чего измеряется   //
+// время вызовов calculateBody. Способы обращения:                            //
+//    - sequential:     монотонный проход по выпуску (8 моментов на блок);    //
+//    - random:         равномерно распределённые моменты по всему выпуску;   //
+//    - strided:        монотонный проход с шагом ~7.3 блока;                 //
+//    - back_and_forth: поочерёдные обращения по обе стороны от границы двух  //
+//                      соседних блоков;                                      //
+//    - all_bodies:     все тела (1-13, кроме SSB) относительно SSB на каждый //
+//                      момент монотонного прохода.                           //
+//                                                                            //
+// Результаты выводятся в формате JSON (для отслеживания изменений от         //
+// выпуска к выпуску библиотеки): нс/вызов (минимум и среднее по повторам),   //
+// вызовов/сек. и счётчики кэша блоков контекста.                             //
+//                                                                            //
+// С параметром --threads дополнительно измеряется масштабирование            //
+// calculateBodySeriesParallel (Луна относительно Земли, случайные моменты,   //
+// --calls моментов в ряду) на 1, 2, 4, ... потоках до указанного             //
+// количества: нс/момент и ускорение относительно одного потока.              //
+//                                                                            //
+// Использование:                                                             //
+//    dephem_bench <бинарный файл> [параметры]                                //
+//                                                                            //
+// Параметры:                                                                 //
+//    --access stream|mmap|memory  способ доступа к файлу (dph::Access);      //
+//    --isa N                      набор инструкций (dph::InstructionSet);    //
+//    --cache N                    объём кэша блоков контекста (байт);        //
+//    --prefetch N                 упреждающая загрузка N блоков;             //
+//    --calls N                    количество вызовов в одном замере (1e5);   //
+//    --repeat N                   количество повторов замера (5);            //
+//    --seed N                     начальное значение генератора (1);         //
+//    --threads N                  замер параллельного ряда до N потоков;     //
+//    --output <файл>              файл результата (стандартный вывод).       //
+//                                                                            //
+// ************************************************************************** //
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "dephem/EphemerisRelease.hpp"
+#include "common.hpp"
+
+// Способы обращения.
+enum Pattern
+{
+	SEQUENTIAL,
+	RANDOM,
+	STRIDED,
+	BACK_AND_FORTH,
+	ALL_BODIES,
+	PATTERNS_COUNT
+};
+
+static const char* const PATTERN_NAMES[PATTERNS_COUNT] =
+	{ "sequential", "random", "strided", "back_and_forth", "all_bodies" };
+
+// Обращение: момент времени и искомое тело.
+struct Call
+{
+	double		JED;
+	unsigned	target;
+	unsigned	center;
+};
+
+// Результат замера.
+struct Result
+{
+	unsigned	pattern;
+	unsigned	calculationType;
+	size_t		callsCount;
+	double		minTime;		// Минимальное время замера (сек.).
+	double		totalTime;		// Суммарное время всех замеров (сек.).
+	uint64_t	cacheHits;		// Счётчики кэша последнего замера.
+	uint64_t	cacheMisses;
+	uint64_t	cacheEvictions;
+	double		checksum;
+};
+
+// Результат замера параллельного ряда.
+struct ScalingResult
+{
+	unsigned	threadsCount;
+	double		minTime;		// Минимальное время замера (сек.).
+	double		checksum;
+};
+
+// Генератор псевдослучайных чисел (xorshift32). Последовательность не зависит
+// от стандартной библиотеки, что позволяет сравнивать результаты разных
+// платформ.
+class Random
+{
+public:
+
+	explicit Random(uint32_t seed) : m_state(seed == 0 ? 1 : seed) {}
+
+	// Равномерно распределённое число из [0 : 1).
+	double next()
+	{
+		double high = nextInt();
+		double low = nextInt();
+
+		return (high + low / 4294967296.0) / 4294967296.0;
+	}
+
+private:
+
+	uint32_t nextInt()
+	{
+		m_state ^= m_state << 13;
+		m_state ^= m_state >> 17;
+		m_state ^= m_state << 5;
+
+		return m_state;
+	}
+
+	uint32_t m_state;
+};
+
+// Формирование набора обращений "calls" размера "callsCount".
+static void makeCalls(const dph::EphemerisRelease& release, unsigned pattern,
+	size_t callsCount, uint32_t seed, std::vector<Call>& calls)
+{
+	calls.resize(callsCount);
+
+	double startDate = release.startDate();
+	double endDate = release.endDate();
+	double blockSpan = release.blockTimeSpan();
+	size_t blocksCount = static_cast<size_t>((endDate - startDate) / blockSpan + 0.5);
+
+	double timeSpan = endDate - startDate;
+
+	Random random(seed);
+
+	for (size_t i = 0; i < callsCount; ++i)
+	{
+		Call& call = calls[i];
+
+		call.target = dph::Body::MOON;
+		call.center = dph::Body::EARTH;
+
+		switch (pattern)
+		{
+		case SEQUENTIAL:
+			call.JED = startDate + std::fmod((i + 0.5) * blockSpan / 8, timeSpan);
+			break;
+
+		case RANDOM:
+			call.JED = startDate + random.next() * timeSpan;
+			break;
+
+		case STRIDED:
+			call.JED = startDate + std::fmod((i + 0.5) * blockSpan * 7.3, timeSpan);
+			break;
+
+		case BACK_AND_FORTH:
+		{
+			// 16 обращений на каждую границу, затем - следующая граница:
+			size_t boundariesCount = blocksCount > 1 ? blocksCount - 1 : 1;
+			double boundary = startDate + blockSpan * (1 + (i / 16) % boundariesCount);
+			double offset = blockSpan * (0.001 + 0.01 * random.next());
+
+			call.JED = i % 2 == 0 ? boundary - offset : boundary + offset;
+
+			if (call.JED > endDate)
+			{
+				call.JED = endDate;
+			}
+
+			break;
+		}
+
+		case ALL_BODIES:
+		{
+			// Тела 1-13 без SSB (12) - 12 обращений на момент времени:
+			size_t epochIndex = i / 12;
+			unsigned body = static_cast<unsigned>(i % 12) + 1;
+
+			call.JED = startDate + std::fmod((epochIndex + 0.5) * blockSpan / 8, timeSpan);
+			call.target = body < dph::Body::SSBARY ? body : body + 1;
+			call.center = dph::Body::SSBARY;
+			break;
+		}
+		}
+	}
+}
+
+// Замер одного способа обращения в режиме "calculationType".
+static Result measure(dph::EphemerisRelease& release, unsigned pattern,
+	unsigned calculationType, const std::vector<Call>& calls, unsigned repeat)
+{
+	Result result;
+	result.pattern = pattern;
+	result.calculationType = calculationType;
+	result.callsCount = calls.size();
+	result.minTime = 0;
+	result.totalTime = 0;
+	result.cacheHits = 0;
+	result.cacheMisses = 0;
+	result.cacheEvictions = 0;
+	result.checksum = 0;
+
+	double state[6] = { 0 };
+
+	for (unsigned r = 0; r < repeat; ++r)
+	{
+		release.resetCacheCounters();
+
+		double startTime = currentTime();
+
+		for (size_t i = 0; i < calls.size(); ++i)
+		{
+			release.calculateBody(calculationType, calls[i].target, calls[i].center,
+				calls[i].JED, state);
+
+			result.checksum += state[0];
+		}
+
+		double elapsed = currentTime() - startTime;
+
+		result.minTime = r == 0 || elapsed < result.minTime ? elapsed : result.minTime;
+		result.totalTime += elapsed;
+		result.cacheHits = release.cacheHits();
+		result.cacheMisses = release.cacheMisses();
+		result.cacheEvictions = release.cacheEvictions();
+	}
+
+	return result;
+}
+
+// Замер calculateBodySeriesParallel на "threadsCount" потоках для моментов
+// времени "JEDs".
+static ScalingResult measureParallel(const dph::EphemerisRelease& release,
+	const std::vector<double>& JEDs, unsigned threadsCount, unsigned repeat)
+{
+	ScalingResult result;
+	result.threadsCount = threadsCount;
+	result.minTime = 0;
+	result.checksum = 0;
+
+	std::vector<double> positions(JEDs.size() * 3);
+
+	for (unsigned r = 0; r < repeat; ++r)
+	{
+		double startTime = currentTime();
+
+		release.calculateBodySeriesParallel(dph::Calculate::POSITION, dph::Body::MOON,
+			dph::Body::EARTH, &JEDs[0], JEDs.size(), &positions[0], threadsCount);
+
+		double elapsed = currentTime() - startTime;
+
+		result.minTime = r == 0 || elapsed < result.minTime ? elapsed : result.minTime;
+	}
+
+	for (size_t i = 0; i < positions.size(); i += 3)
+	{
+		result.checksum += positions[i];
+	}
+
+	return result;
+}
+
+// Запись строки "text" в JSON-формате (с экранированием).
+static void printJsonString(std::FILE* file, const std::string& text)
+{
+	std::fputc('"', file);
+
+	for (size_t i = 0; i < text.size(); ++i)
+	{
+		char c = text[i];
+
+		if (c == '"' || c == '\\')
+		{
+			std::fputc('\\', file);
+			std::fputc(c, file);
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			std::fprintf(file, "\\u%04x", static_cast<unsigned>(c));
+		}
+		else
+		{
+			std::fputc(c, file);
+		}
+	}
+
+	std::fputc('"', file);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::printf("usage: %s <binary file> [--access stream|mmap|memory] [--isa N]"
+			" [--cache bytes] [--prefetch N] [--calls N] [--repeat N] [--seed N]"
+			" [--threads N] [--output file]\n",
+			argv[0]);
+
+		return 2;
+	}
+
+	dph::ReleaseOptions options;
+
+	size_t callsCount = 100000;
+	unsigned repeat = 5;
+	uint32_t seed = 1;
+	unsigned maxThreadsCount = 0;
+	std::string outputPath;
+
+	for (int i = 2; i + 1 < argc; i += 2)
+	{
+		std::string name = argv[i];
+		std::string value = argv[i + 1];
+
+		if (parseReleaseOption(name, value, options))
+		{
+			continue;
+		}
+		else if (name == "--calls")
+		{
+			callsCount = static_cast<size_t>(std::atof(value.c_str()));
+			callsCount = callsCount == 0 ? 1 : callsCount;
+		}
+		else if (name == "--repeat")
+		{
+			repeat = static_cast<unsigned>(std::atoi(value.c_str()));
+			repeat = repeat == 0 ? 1 : repeat;
+		}
+		else if (name == "--seed")
+		{
+			seed = static_cast<uint32_t>(std::strtoul(value.c_str(), NULL, 10));
+		}
+		else if (name == "--threads")
+		{
+			maxThreadsCount = static_cast<unsigned>(std::atoi(value.c_str()));
+		}
+		else if (name == "--output")
+		{
+			outputPath = value;
+		}
+		else
+		{
+			std::printf("unknown option: %s\n", name.c_str());
+
+			return 2;
+		}
+	}
+
+	dph::EphemerisRelease release(argv[1], options);
+
+	if (release.isReady() == false)
+	{
+		std::printf("cannot open ephemeris file: %s\n", argv[1]);
+
+		return 2;
+	}
+
+	std::vector<Result> results;
+	std::vector<Call> calls;
+
+	for (unsigned pattern = 0; pattern < PATTERNS_COUNT; ++pattern)
+	{
+		makeCalls(release, pattern, callsCount, seed, calls);
+
+		results.push_back(measure(release, pattern, dph::Calculate::POSITION, calls, repeat));
+		results.push_back(measure(release, pattern, dph::Calculate::STATE, calls, repeat));
+	}
+
+	// Масштабирование параллельного ряда (1, 2, 4, ... потоков):
+	std::vector<ScalingResult> scaling;
+
+	if (maxThreadsCount != 0)
+	{
+		makeCalls(release, RANDOM, callsCount, seed, calls);
+
+		std::vector<double> JEDs(calls.size());
+
+		for (size_t i = 0; i < calls.size(); ++i)
+		{
+			JEDs[i] = calls[i].JED;
+		}
+
+		for (unsigned threadsCount = 1; ; threadsCount *= 2)
+		{
+			if (threadsCount > maxThreadsCount)
+			{
+				threadsCount = maxThreadsCount;
+			}
+
+			scaling.push_back(measureParallel(release, JEDs, threadsCount, repeat));
+
+			if (threadsCount == maxThreadsCount)
+			{
+				break;
+			}
+		}
+	}
+
+	std::FILE* file = outputPath.empty() ? stdout : std::fopen(outputPath.c_str(), "w");
+
+	if (file == NULL)
+	{
+		std::printf("cannot open output file: %s\n", outputPath.c_str());
+
+		return 2;
+	}
+
+	std::fprintf(file, "{\n");
+	std::fprintf(file, "  \"file\": ");
+	printJsonString(file, argv[1]);
+	std::fprintf(file, ",\n");
+	std::fprintf(file, "  \"release_index\": %u,\n", release.releaseIndex());
+	std::fprintf(file, "  \"access_mode\": %u,\n", release.accessMode());
+	std::fprintf(file, "  \"instruction_set\": %u,\n", release.instructionSet());
+	std::fprintf(file, "  \"cache_blocks\": %lu,\n", (unsigned long)release.cacheBlocksCount());
+	std::fprintf(file, "  \"calls\": %lu,\n", (unsigned long)callsCount);
+	std::fprintf(file, "  \"repeat\": %u,\n", repeat);
+	std::fprintf(file, "  \"seed\": %lu,\n", (unsigned long)seed);
+	std::fprintf(file, "  \"results\": [\n");
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const Result& r = results[i];
+
+		double minNs = r.minTime * 1e9 / r.callsCount;
+		double meanNs = r.totalTime * 1e9 / repeat / r.callsCount;
+
+		std::fprintf(file, "    {\"pattern\": \"%s\", \"mode\": \"%s\", "
+			"\"ns_per_call_min\": %.2f, \"ns_per_call_mean\": %.2f, "
+			"\"calls_per_sec\": %.0f, \"cache_hits\": %lu, \"cache_misses\": %lu, "
+			"\"cache_evictions\": %lu, \"checksum\": %.17g}%s\n",
+			PATTERN_NAMES[r.pattern],
+			r.calculationType == dph::Calculate::POSITION ? "POSITION" : "STATE",
+			minNs, meanNs, minNs > 0 ? 1e9 / minNs : 0.0,
+			(unsigned long)r.cacheHits, (unsigned long)r.cacheMisses,
+			(unsigned long)r.cacheEvictions, r.checksum,
+			i + 1 < results.size() ? "," : "");
+	}
+
+	std::fprintf(file, "  ]%s\n", scaling.empty() ? "" : ",");
+
+	if (scaling.empty() == false)
+	{
+		std::fprintf(file, "  \"hardware_threads\": %u,\n",
+			dph::Thread::hardwareConcurrency());
+		std::fprintf(file, "  \"scaling\": [\n");
+
+		for (size_t i = 0; i < scaling.size(); ++i)
+		{
+			const ScalingResult& s = scaling[i];
+
+			std::fprintf(file, "    {\"threads\": %u, \"ns_per_point_min\": %.2f, "
+				"\"speedup\": %.2f, \"checksum\": %.17g}%s\n",
+				s.threadsCount, s.minTime * 1e9 / callsCount,
+				s.minTime > 0 ? scaling[0].minTime / s.minTime : 0.0, s.checksum,
+				i + 1 < scaling.size() ? "," : "");
+		}
+
+		std::fprintf(file, "  ]\n");
+	}
+
+	std::fprintf(file, "}\n");
+
+	if (file != stdout)
+	{
+		std::fclose(file);
+	}
+
+	return 0;
+}
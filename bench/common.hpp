@@ -0,0 +1,73 @@
+#ifndef DEPHEM_BENCH_COMMON_HPP
+#define DEPHEM_BENCH_COMMON_HPP
+
+// ************************************************************************** //
+//                 Общие функции инструментов сверки и замеров                //
+// ************************************************************************** //
+
+#include <cstdlib>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "dephem/help.hpp"
+
+// Монотонное время в секундах.
+static double currentTime()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	return double(counter.QuadPart) / double(frequency.QuadPart);
+#else
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + now.tv_nsec * 1e-9;
+#endif
+}
+
+// Разбор параметра командной строки, соответствующего полю
+// dph::ReleaseOptions ("--access", "--isa", "--cache", "--prefetch").
+// Возвращает false, если параметр не относится к настройкам выпуска.
+static bool parseReleaseOption(const std::string& name, const std::string& value,
+	dph::ReleaseOptions& options)
+{
+	if (name == "--access")
+	{
+		options.accessMode = value == "mmap" ? dph::Access::MMAP :
+			value == "memory" ? dph::Access::MEMORY : dph::Access::STREAM;
+	}
+	else if (name == "--isa")
+	{
+		options.instructionSet = static_cast<unsigned>(std::atoi(value.c_str()));
+	}
+	else if (name == "--cache")
+	{
+		options.cacheSize_bytes = static_cast<size_t>(std::atof(value.c_str()));
+	}
+	else if (name == "--prefetch")
+	{
+		options.prefetchBlocksCount = static_cast<unsigned>(std::atoi(value.c_str()));
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+#endif // DEPHEM_BENCH_COMMON_HPP
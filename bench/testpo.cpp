@@ -0,0 +1,312 @@
+// ************************************************************************** //
+//                                  testpo                                    //
+//                                                                            //
+//       Сверка вычислений с testpo-файлом выпуска и замер производительности //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Каждая строка testpo-файла (после "EOT") прогоняется через                 //
+// calculateBody / calculateOther. Результат сравнивается с эталонным         //
+// значением JPL в единицах testpo-файла:                                     //
+//    - тела (1-13):        а.е., а.е./сут.;                                  //
+//    - нутации, либрации:  рад., рад./сут.;                                  //
+//    - угл. скорости мантии Луны: рад./сут., рад./сут.^2;                    //
+//    - TT-TDB:             сек., сек./сут.                                   //
+//                                                                            //
+// Отчёт: максимальная ошибка по каждому элементу, количество превышений      //
+// допуска, затем скорость прогона всех строк (вызовов/сек., нс/вызов) и      //
+// количество переходов между блоками (промахов кэша контекста).              //
+//                                                                            //
+// Код возврата: 0 - все строки в допуске, 1 - есть превышения, 2 - ошибка    //
+// открытия файлов или неверные параметры.                                    //
+//                                                                            //
+// Использование:                                                             //
+//    dephem_testpo <бинарный файл> <testpo-файл> [параметры]                 //
+//                                                                            //
+// Параметры:                                                                 //
+//    --access stream|mmap|memory  способ доступа к файлу (dph::Access);      //
+//    --isa N                      набор инструкций (dph::InstructionSet);    //
+//    --cache N                    объём кэша блоков контекста (байт);        //
+//    --prefetch N                 упреждающая загрузка N блоков;             //
+//    --repeat N                   количество прогонов для замера (1);        //
+//    --tolerance X                допуск (1e-13, как в testeph.f JPL).       //
+//                                                                            //
+// ************************************************************************** //
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "dephem/EphemerisRelease.hpp"
+#include "common.hpp"
+
+// Строка testpo-файла.
+struct TestLine
+{
+	double		JED;		// Момент времени.
+	unsigned	target;		// Искомый элемент (1-17, см. dph::Body и dph::Other).
+	unsigned	center;		// Центральное тело (для тел).
+	unsigned	component;	// Номер компоненты (от нуля).
+	double		expected;	// Эталонное значение.
+};
+
+// Чтение строк testpo-файла. Возвращает false, если файл не удалось открыть.
+static bool readTestpo(const char* filePath, std::vector<TestLine>& lines)
+{
+	std::FILE* file = std::fopen(filePath, "r");
+
+	if (file == NULL)
+	{
+		return false;
+	}
+
+	char buffer[512];
+
+	bool isData = false;
+
+	while (std::fgets(buffer, sizeof(buffer), file) != NULL)
+	{
+		if (isData == false)
+		{
+			isData = std::strncmp(buffer, "EOT", 3) == 0;
+			continue;
+		}
+
+		// Формат строки: DENUM дата JED искомый центр компонента значение.
+		unsigned denum, target, center, component;
+		char date[32];
+		double JED, expected;
+
+		if (std::sscanf(buffer, "%u %31s %lf %u %u %u %lf", &denum, date, &JED, &target,
+			&center, &component, &expected) != 7)
+		{
+			continue;
+		}
+
+		if (target == 0 || target > 17 || component == 0 || component > 6)
+		{
+			continue;
+		}
+
+		TestLine line = { JED, target, center, component - 1, expected };
+
+		lines.push_back(line);
+	}
+
+	std::fclose(file);
+
+	return true;
+}
+
+// Вычисление значения строки в единицах testpo-файла. Возвращает false, если
+// строка не может быть вычислена по данному выпуску.
+static bool calculateLine(const dph::EphemerisRelease& release, const TestLine& line,
+	double& value)
+{
+	if (line.JED < release.startDate() || line.JED > release.endDate())
+	{
+		return false;
+	}
+
+	double result[6] = { NAN, NAN, NAN, NAN, NAN, NAN };
+
+	if (line.target <= 13)
+	{
+		if (line.center == 0 || line.center > 13)
+		{
+			return false;
+		}
+
+		release.calculateBody(dph::Calculate::STATE, line.target, line.center, line.JED,
+			result);
+	}
+	else
+	{
+		release.calculateOther(dph::Calculate::STATE, line.target, line.JED, result);
+	}
+
+	// Количество компонент элемента и перевод единиц:
+	unsigned componentsCount = line.target == dph::Other::EARTH_NUTATIONS ? 2 :
+		line.target == dph::Other::TTmTDB ? 1 : 3;
+
+	if (line.component >= 2 * componentsCount)
+	{
+		return false;
+	}
+
+	value = result[line.component];
+
+	if (line.target <= 13)
+	{
+		// км -> а.е., км/сек. -> а.е./сут.:
+		value /= release.constant("AU");
+
+		if (line.component >= 3)
+		{
+			value *= 86400;
+		}
+	}
+	else if (line.component >= componentsCount)
+	{
+		// Производные: в сутки вместо секунды.
+		value *= 86400;
+	}
+
+	return value == value;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		std::printf("usage: %s <binary file> <testpo file> [--access stream|mmap|memory]"
+			" [--isa N] [--cache bytes] [--prefetch N] [--repeat N] [--tolerance X]\n", argv[0]);
+
+		return 2;
+	}
+
+	dph::ReleaseOptions options;
+
+	unsigned repeat = 1;
+	double tolerance = 1e-13;
+
+	for (int i = 3; i + 1 < argc; i += 2)
+	{
+		std::string name = argv[i];
+		std::string value = argv[i + 1];
+
+		if (parseReleaseOption(name, value, options))
+		{
+			continue;
+		}
+		else if (name == "--repeat")
+		{
+			repeat = static_cast<unsigned>(std::atoi(value.c_str()));
+			repeat = repeat == 0 ? 1 : repeat;
+		}
+		else if (name == "--tolerance")
+		{
+			tolerance = std::atof(value.c_str());
+		}
+		else
+		{
+			std::printf("unknown option: %s\n", name.c_str());
+
+			return 2;
+		}
+	}
+
+	dph::EphemerisRelease release(argv[1], options);
+
+	if (release.isReady() == false)
+	{
+		std::printf("cannot open ephemeris file: %s\n", argv[1]);
+
+		return 2;
+	}
+
+	std::vector<TestLine> lines;
+
+	if (readTestpo(argv[2], lines) == false)
+	{
+		std::printf("cannot open testpo file: %s\n", argv[2]);
+
+		return 2;
+	}
+
+	std::printf("release:         DE%u\n", release.releaseIndex());
+	std::printf("access mode:     %u\n", release.accessMode());
+	std::printf("instruction set: %u\n", release.instructionSet());
+	std::printf("cache blocks:    %lu\n", (unsigned long)release.cacheBlocksCount());
+
+	// ------------------------------- Точность -------------------------------- //
+
+	double maxError[18] = { 0 };
+	size_t checked[18] = { 0 };
+	size_t failed[18] = { 0 };
+	size_t skipped = 0;
+
+	for (size_t i = 0; i < lines.size(); ++i)
+	{
+		double value = 0;
+
+		if (calculateLine(release, lines[i], value) == false)
+		{
+			++skipped;
+			continue;
+		}
+
+		double error = std::fabs(value - lines[i].expected);
+
+		unsigned target = lines[i].target;
+
+		++checked[target];
+
+		if (error > maxError[target])
+		{
+			maxError[target] = error;
+		}
+
+		if (error > tolerance)
+		{
+			++failed[target];
+		}
+	}
+
+	size_t failedTotal = 0;
+
+	std::printf("\n%-8s %10s %10s %14s\n", "target", "lines", "failed", "max error");
+
+	for (unsigned target = 1; target <= 17; ++target)
+	{
+		if (checked[target] != 0)
+		{
+			std::printf("%-8u %10lu %10lu %14.3e\n", target, (unsigned long)checked[target],
+				(unsigned long)failed[target], maxError[target]);
+
+			failedTotal += failed[target];
+		}
+	}
+
+	std::printf("skipped lines:   %lu (out of release range or unsupported)\n",
+		(unsigned long)skipped);
+
+	// ---------------------------- Производительность ------------------------- //
+
+	release.resetCacheCounters();
+
+	size_t callsCount = 0;
+	double checksum = 0;
+
+	double startTime = currentTime();
+
+	for (unsigned r = 0; r < repeat; ++r)
+	{
+		for (size_t i = 0; i < lines.size(); ++i)
+		{
+			double value = 0;
+
+			if (calculateLine(release, lines[i], value))
+			{
+				checksum += value;
+				++callsCount;
+			}
+		}
+	}
+
+	double elapsed = currentTime() - startTime;
+
+	std::printf("\ncalls:           %lu\n", (unsigned long)callsCount);
+	std::printf("calls/sec:       %.0f\n", elapsed > 0 ? callsCount / elapsed : 0.0);
+	std::printf("ns/call:         %.1f\n", callsCount > 0 ? elapsed * 1e9 / callsCount : 0.0);
+	std::printf("block hits:      %lu\n", (unsigned long)release.cacheHits());
+	std::printf("block misses:    %lu\n", (unsigned long)release.cacheMisses());
+	std::printf("checksum:        %.17g\n", checksum);
+
+	std::printf("\nresult:          %s\n", failedTotal == 0 ? "PASSED" : "FAILED");
+
+	return failedTotal == 0 ? 0 : 1;
+}
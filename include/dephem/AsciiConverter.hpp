@@ -0,0 +1,1047 @@
+#ifndef DEPHEM_ASCII_CONVERTER_HPP
+#define DEPHEM_ASCII_CONVERTER_HPP
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "BinaryWriter.hpp"
+#include "Thread.hpp"
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                              AsciiConverter                                //
+//                                                                            //
+//         Преобразование эфемерид формата ASCII в бинарный формат            //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс для получения бинарного файла эфемерид (читаемого    //
+// dph::EphemerisRelease) из файлов ASCII, распространяемых JPL:              //
+//    - header.XXX  - заголовок выпуска (группы 1010, 1030, 1040, 1041,       //
+//                    1050);                                                  //
+//    - ascpYYYY.XXX - блоки коэффициентов.                                   //
+//                                                                            //
+// Файлы с коэффициентами передаются в хронологическом порядке. Повторяющиеся //
+// на стыке файлов блоки пропускаются, блоки вне промежутка выпуска           //
+// (группа 1030) игнорируются. Пропуск блока считается ошибкой.               //
+//                                                                            //
+// Файлы с коэффициентами разбираются параллельно (dph::Thread) пакетами по   //
+// количеству потоков, после чего блоки пакета записываются по порядку. Файл  //
+// читается частями по READ_BUFFER_SIZE байт (текст файла целиком в памяти не //
+// хранится), в памяти одновременно находятся только блоки одного пакета.     //
+//                                                                            //
+// Числа разбираются без iostreams и независимо от локали (см.                //
+// parseDouble(...)), экспонента может обозначаться как 'D', так и 'E'.       //
+//                                                                            //
+// ************************************************************************** //
+class AsciiConverter
+{
+public:
+
+	// Записать в файл "binaryFilePath" выпуск, заданный заголовком
+	// "headerFilePath" и файлами коэффициентов "dataFilePaths" (в
+	// хронологическом порядке). Файлы коэффициентов разбираются
+	// "threadsCount" потоками (0 - по количеству логических процессоров).
+	// Возвращает false при ошибке чтения, разбора или записи.
+	static bool convert(const std::string& headerFilePath,
+		const std::vector<std::string>& dataFilePaths, const std::string& binaryFilePath,
+			unsigned threadsCount = 0);
+
+	// Разобрать число с плавающей точкой (в т.ч. в формате Fortran:
+	// "0.123D+04") начиная с "text". В "end" записывается указатель на символ
+	// после числа (или "text", если число не разобрано).
+	// ---------------------
+	// Результат округлён корректно и не зависит от локали:
+	//	1. Если мантисса без учёта незначащих нулей не превышает 2^53, а
+	//	   порядок - 22 по модулю, то результат вычисляется одним умножением
+	//	   (делением).
+	//	2. Иначе, если в мантиссе не более 19 значащих цифр, а порядок -
+	//	   в пределах таблицы POWERS_OF_FIVE, - алгоритмом Эйзеля-Лемира (см.
+	//	   computeDouble(...)).
+	//	3. Иначе (и для субнормальных чисел) - strtod с десятичным
+	//	   разделителем текущей локали.
+	static double parseDouble(const char* text, const char** end);
+
+private:
+	AsciiConverter(); // Запрет на создание объекта типа AsciiConverter.
+
+	// Результат разбора одного файла коэффициентов.
+	struct DataFile
+	{
+		const std::string*	path;			// Путь к файлу.
+		size_t				ncoeff;			// Количество коэффициентов в блоке.
+		std::vector<double>	coefficients;	// Блоки подряд (по ncoeff).
+		bool				isParsed;		// Разбор выполнен успешно?
+	};
+
+	// Размер буфера чтения файла коэффициентов (байт).
+	static const size_t READ_BUFFER_SIZE = 1 << 20;
+
+	// Порядки первой и последней степеней пяти в POWERS_OF_FIVE.
+	static const int POWERS_OF_FIVE_MIN = -64;
+	static const int POWERS_OF_FIVE_MAX = 64;
+
+	// Степени пяти 5^q (q от POWERS_OF_FIVE_MIN до POWERS_OF_FIVE_MAX),
+	// нормализованные к 128 битам (старший бит - единица), по 32 бита от
+	// старших к младшим. Для q < 0 значение округлено вверх.
+	static const uint32_t POWERS_OF_FIVE[POWERS_OF_FIVE_MAX - POWERS_OF_FIVE_MIN + 1][4];
+
+	// Вычислить "mantissa" * 10^"exponent" (мантисса не равна нулю) с
+	// корректным округлением алгоритмом Эйзеля-Лемира: 128-битное
+	// произведение нормализованной мантиссы на 5^exponent (POWERS_OF_FIVE)
+	// содержит достаточно бит для округления. Возвращает false, если порядок
+	// вне таблицы или результат субнормальный или бесконечный.
+	static bool computeDouble(uint64_t mantissa, int exponent, double& result);
+
+	// Произведение "a" * "b" (128 бит): старшие 64 бита - в "high", младшие -
+	// в "low".
+	static void multiply(uint64_t a, uint64_t b, uint64_t& high, uint64_t& low);
+
+	// Прочитать файл "filePath" целиком в "content" (с завершающим нулём).
+	// Используется для заголовка.
+	static bool readFile(const std::string& filePath, std::vector<char>& content);
+
+	// Разобрать заголовок "content" и заполнить поля "writer". В "ncoeff"
+	// записывается значение NCOEFF из заголовка.
+	static bool parseHeader(const std::vector<char>& content, BinaryWriter& writer,
+		size_t& ncoeff);
+
+	// Разобрать файл коэффициентов (выполняется в потоке, "dataFile" -
+	// указатель на DataFile).
+	static void parseDataFile(void* dataFile);
+
+	// Разобрать полные строки "text" файла коэффициентов "file". В
+	// "remaining" - количество ещё не прочитанных коэффициентов текущей
+	// записи (0 - ожидается строка "номер_блока ncoeff"). Возвращает false
+	// при ошибке разбора.
+	static bool parseDataLines(const char* text, DataFile& file, size_t& remaining);
+
+	// Перейти к началу следующей строки.
+	static const char* nextLine(const char* text);
+
+	// Пропустить пробельные символы (включая переводы строк).
+	static const char* skipSpaces(const char* text);
+
+	// Найти строку "GROUP   NNNN" и вернуть указатель на следующую за ней
+	// строку (NULL, если группа не найдена).
+	static const char* findGroup(const char* text, const char* groupIndex);
+};
+
+} // namespace dph
+
+const uint32_t dph::AsciiConverter::POWERS_OF_FIVE[
+	POWERS_OF_FIVE_MAX - POWERS_OF_FIVE_MIN + 1][4] = {
+	{ 0xA87FEA27, 0xA539E9A5, 0x3F2398D7, 0x47B36224 },	// 5^-64
+	{ 0xD29FE4B1, 0x8E88640E, 0x8EEC7F0D, 0x19A03AAD },	// 5^-63
+	{ 0x83A3EEEE, 0xF9153E89, 0x1953CF68, 0x300424AC },	// 5^-62
+	{ 0xA48CEAAA, 0xB75A8E2B, 0x5FA8C342, 0x3C052DD7 },	// 5^-61
+	{ 0xCDB02555, 0x653131B6, 0x3792F412, 0xCB06794D },	// 5^-60
+	{ 0x808E1755, 0x5F3EBF11, 0xE2BBD88B, 0xBEE40BD0 },	// 5^-59
+	{ 0xA0B19D2A, 0xB70E6ED6, 0x5B6ACEAE, 0xAE9D0EC4 },	// 5^-58
+	{ 0xC8DE0475, 0x64D20A8B, 0xF245825A, 0x5A445275 },	// 5^-57
+	{ 0xFB158592, 0xBE068D2E, 0xEED6E2F0, 0xF0D56712 },	// 5^-56
+	{ 0x9CED737B, 0xB6C4183D, 0x55464DD6, 0x9685606B },	// 5^-55
+	{ 0xC428D05A, 0xA4751E4C, 0xAA97E14C, 0x3C26B886 },	// 5^-54
+	{ 0xF5330471, 0x4D9265DF, 0xD53DD99F, 0x4B3066A8 },	// 5^-53
+	{ 0x993FE2C6, 0xD07B7FAB, 0xE546A803, 0x8EFE4029 },	// 5^-52
+	{ 0xBF8FDB78, 0x849A5F96, 0xDE985204, 0x72BDD033 },	// 5^-51
+	{ 0xEF73D256, 0xA5C0F77C, 0x963E6685, 0x8F6D4440 },	// 5^-50
+	{ 0x95A86376, 0x27989AAD, 0xDDE70013, 0x79A44AA8 },	// 5^-49
+	{ 0xBB127C53, 0xB17EC159, 0x5560C018, 0x580D5D52 },	// 5^-48
+	{ 0xE9D71B68, 0x9DDE71AF, 0xAAB8F01E, 0x6E10B4A6 },	// 5^-47
+	{ 0x92267121, 0x62AB070D, 0xCAB39613, 0x04CA70E8 },	// 5^-46
+	{ 0xB6B00D69, 0xBB55C8D1, 0x3D607B97, 0xC5FD0D22 },	// 5^-45
+	{ 0xE45C10C4, 0x2A2B3B05, 0x8CB89A7D, 0xB77C506A },	// 5^-44
+	{ 0x8EB98A7A, 0x9A5B04E3, 0x77F3608E, 0x92ADB242 },	// 5^-43
+	{ 0xB267ED19, 0x40F1C61C, 0x55F038B2, 0x37591ED3 },	// 5^-42
+	{ 0xDF01E85F, 0x912E37A3, 0x6B6C46DE, 0xC52F6688 },	// 5^-41
+	{ 0x8B61313B, 0xBABCE2C6, 0x2323AC4B, 0x3B3DA015 },	// 5^-40
+	{ 0xAE397D8A, 0xA96C1B77, 0xABEC975E, 0x0A0D081A },	// 5^-39
+	{ 0xD9C7DCED, 0x53C72255, 0x96E7BD35, 0x8C904A21 },	// 5^-38
+	{ 0x881CEA14, 0x545C7575, 0x7E50D641, 0x77DA2E54 },	// 5^-37
+	{ 0xAA242499, 0x697392D2, 0xDDE50BD1, 0xD5D0B9E9 },	// 5^-36
+	{ 0xD4AD2DBF, 0xC3D07787, 0x955E4EC6, 0x4B44E864 },	// 5^-35
+	{ 0x84EC3C97, 0xDA624AB4, 0xBD5AF13B, 0xEF0B113E },	// 5^-34
+	{ 0xA6274BBD, 0xD0FADD61, 0xECB1AD8A, 0xEACDD58E },	// 5^-33
+	{ 0xCFB11EAD, 0x453994BA, 0x67DE18ED, 0xA5814AF2 },	// 5^-32
+	{ 0x81CEB32C, 0x4B43FCF4, 0x80EACF94, 0x8770CED7 },	// 5^-31
+	{ 0xA2425FF7, 0x5E14FC31, 0xA1258379, 0xA94D028D },	// 5^-30
+	{ 0xCAD2F7F5, 0x359A3B3E, 0x096EE458, 0x13A04330 },	// 5^-29
+	{ 0xFD87B5F2, 0x8300CA0D, 0x8BCA9D6E, 0x188853FC },	// 5^-28
+	{ 0x9E74D1B7, 0x91E07E48, 0x775EA264, 0xCF55347E },	// 5^-27
+	{ 0xC6120625, 0x76589DDA, 0x95364AFE, 0x032A819E },	// 5^-26
+	{ 0xF79687AE, 0xD3EEC551, 0x3A83DDBD, 0x83F52205 },	// 5^-25
+	{ 0x9ABE14CD, 0x44753B52, 0xC4926A96, 0x72793543 },	// 5^-24
+	{ 0xC16D9A00, 0x95928A27, 0x75B7053C, 0x0F178294 },	// 5^-23
+	{ 0xF1C90080, 0xBAF72CB1, 0x5324C68B, 0x12DD6339 },	// 5^-22
+	{ 0x971DA050, 0x74DA7BEE, 0xD3F6FC16, 0xEBCA5E04 },	// 5^-21
+	{ 0xBCE50864, 0x92111AEA, 0x88F4BB1C, 0xA6BCF585 },	// 5^-20
+	{ 0xEC1E4A7D, 0xB69561A5, 0x2B31E9E3, 0xD06C32E6 },	// 5^-19
+	{ 0x9392EE8E, 0x921D5D07, 0x3AFF322E, 0x62439FD0 },	// 5^-18
+	{ 0xB877AA32, 0x36A4B449, 0x09BEFEB9, 0xFAD487C3 },	// 5^-17
+	{ 0xE69594BE, 0xC44DE15B, 0x4C2EBE68, 0x7989A9B4 },	// 5^-16
+	{ 0x901D7CF7, 0x3AB0ACD9, 0x0F9D3701, 0x4BF60A11 },	// 5^-15
+	{ 0xB424DC35, 0x095CD80F, 0x538484C1, 0x9EF38C95 },	// 5^-14
+	{ 0xE12E1342, 0x4BB40E13, 0x2865A5F2, 0x06B06FBA },	// 5^-13
+	{ 0x8CBCCC09, 0x6F5088CB, 0xF93F87B7, 0x442E45D4 },	// 5^-12
+	{ 0xAFEBFF0B, 0xCB24AAFE, 0xF78F69A5, 0x1539D749 },	// 5^-11
+	{ 0xDBE6FECE, 0xBDEDD5BE, 0xB573440E, 0x5A884D1C },	// 5^-10
+	{ 0x89705F41, 0x36B4A597, 0x31680A88, 0xF8953031 },	// 5^-9
+	{ 0xABCC7711, 0x8461CEFC, 0xFDC20D2B, 0x36BA7C3E },	// 5^-8
+	{ 0xD6BF94D5, 0xE57A42BC, 0x3D329076, 0x04691B4D },	// 5^-7
+	{ 0x8637BD05, 0xAF6C69B5, 0xA63F9A49, 0xC2C1B110 },	// 5^-6
+	{ 0xA7C5AC47, 0x1B478423, 0x0FCF80DC, 0x33721D54 },	// 5^-5
+	{ 0xD1B71758, 0xE219652B, 0xD3C36113, 0x404EA4A9 },	// 5^-4
+	{ 0x83126E97, 0x8D4FDF3B, 0x645A1CAC, 0x083126EA },	// 5^-3
+	{ 0xA3D70A3D, 0x70A3D70A, 0x3D70A3D7, 0x0A3D70A4 },	// 5^-2
+	{ 0xCCCCCCCC, 0xCCCCCCCC, 0xCCCCCCCC, 0xCCCCCCCD },	// 5^-1
+	{ 0x80000000, 0x00000000, 0x00000000, 0x00000000 },	// 5^0
+	{ 0xA0000000, 0x00000000, 0x00000000, 0x00000000 },	// 5^1
+	{ 0xC8000000, 0x00000000, 0x00000000, 0x00000000 },	// 5^2
+	{ 0xFA000000, 0x00000000, 0x00000000, 0x00000000 },	// 5^3
+	{ 0x9C400000, 0x00000000, 0x00000000, 0x00000000 },	// 5^4
+	{ 0xC3500000, 0x00000000, 0x00000000, 0x00000000 },	// 5^5
+	{ 0xF4240000, 0x00000000, 0x00000000, 0x00000000 },	// 5^6
+	{ 0x98968000, 0x00000000, 0x00000000, 0x00000000 },	// 5^7
+	{ 0xBEBC2000, 0x00000000, 0x00000000, 0x00000000 },	// 5^8
+	{ 0xEE6B2800, 0x00000000, 0x00000000, 0x00000000 },	// 5^9
+	{ 0x9502F900, 0x00000000, 0x00000000, 0x00000000 },	// 5^10
+	{ 0xBA43B740, 0x00000000, 0x00000000, 0x00000000 },	// 5^11
+	{ 0xE8D4A510, 0x00000000, 0x00000000, 0x00000000 },	// 5^12
+	{ 0x9184E72A, 0x00000000, 0x00000000, 0x00000000 },	// 5^13
+	{ 0xB5E620F4, 0x80000000, 0x00000000, 0x00000000 },	// 5^14
+	{ 0xE35FA931, 0xA0000000, 0x00000000, 0x00000000 },	// 5^15
+	{ 0x8E1BC9BF, 0x04000000, 0x00000000, 0x00000000 },	// 5^16
+	{ 0xB1A2BC2E, 0xC5000000, 0x00000000, 0x00000000 },	// 5^17
+	{ 0xDE0B6B3A, 0x76400000, 0x00000000, 0x00000000 },	// 5^18
+	{ 0x8AC72304, 0x89E80000, 0x00000000, 0x00000000 },	// 5^19
+	{ 0xAD78EBC5, 0xAC620000, 0x00000000, 0x00000000 },	// 5^20
+	{ 0xD8D726B7, 0x177A8000, 0x00000000, 0x00000000 },	// 5^21
+	{ 0x87867832, 0x6EAC9000, 0x00000000, 0x00000000 },	// 5^22
+	{ 0xA968163F, 0x0A57B400, 0x00000000, 0x00000000 },	// 5^23
+	{ 0xD3C21BCE, 0xCCEDA100, 0x00000000, 0x00000000 },	// 5^24
+	{ 0x84595161, 0x401484A0, 0x00000000, 0x00000000 },	// 5^25
+	{ 0xA56FA5B9, 0x9019A5C8, 0x00000000, 0x00000000 },	// 5^26
+	{ 0xCECB8F27, 0xF4200F3A, 0x00000000, 0x00000000 },	// 5^27
+	{ 0x813F3978, 0xF8940984, 0x40000000, 0x00000000 },	// 5^28
+	{ 0xA18F07D7, 0x36B90BE5, 0x50000000, 0x00000000 },	// 5^29
+	{ 0xC9F2C9CD, 0x04674EDE, 0xA4000000, 0x00000000 },	// 5^30
+	{ 0xFC6F7C40, 0x45812296, 0x4D000000, 0x00000000 },	// 5^31
+	{ 0x9DC5ADA8, 0x2B70B59D, 0xF0200000, 0x00000000 },	// 5^32
+	{ 0xC5371912, 0x364CE305, 0x6C280000, 0x00000000 },	// 5^33
+	{ 0xF684DF56, 0xC3E01BC6, 0xC7320000, 0x00000000 },	// 5^34
+	{ 0x9A130B96, 0x3A6C115C, 0x3C7F4000, 0x00000000 },	// 5^35
+	{ 0xC097CE7B, 0xC90715B3, 0x4B9F1000, 0x00000000 },	// 5^36
+	{ 0xF0BDC21A, 0xBB48DB20, 0x1E86D400, 0x00000000 },	// 5^37
+	{ 0x96769950, 0xB50D88F4, 0x13144480, 0x00000000 },	// 5^38
+	{ 0xBC143FA4, 0xE250EB31, 0x17D955A0, 0x00000000 },	// 5^39
+	{ 0xEB194F8E, 0x1AE525FD, 0x5DCFAB08, 0x00000000 },	// 5^40
+	{ 0x92EFD1B8, 0xD0CF37BE, 0x5AA1CAE5, 0x00000000 },	// 5^41
+	{ 0xB7ABC627, 0x050305AD, 0xF14A3D9E, 0x40000000 },	// 5^42
+	{ 0xE596B7B0, 0xC643C719, 0x6D9CCD05, 0xD0000000 },	// 5^43
+	{ 0x8F7E32CE, 0x7BEA5C6F, 0xE4820023, 0xA2000000 },	// 5^44
+	{ 0xB35DBF82, 0x1AE4F38B, 0xDDA2802C, 0x8A800000 },	// 5^45
+	{ 0xE0352F62, 0xA19E306E, 0xD50B2037, 0xAD200000 },	// 5^46
+	{ 0x8C213D9D, 0xA502DE45, 0x4526F422, 0xCC340000 },	// 5^47
+	{ 0xAF298D05, 0x0E4395D6, 0x9670B12B, 0x7F410000 },	// 5^48
+	{ 0xDAF3F046, 0x51D47B4C, 0x3C0CDD76, 0x5F114000 },	// 5^49
+	{ 0x88D8762B, 0xF324CD0F, 0xA5880A69, 0xFB6AC800 },	// 5^50
+	{ 0xAB0E93B6, 0xEFEE0053, 0x8EEA0D04, 0x7A457A00 },	// 5^51
+	{ 0xD5D238A4, 0xABE98068, 0x72A49045, 0x98D6D880 },	// 5^52
+	{ 0x85A36366, 0xEB71F041, 0x47A6DA2B, 0x7F864750 },	// 5^53
+	{ 0xA70C3C40, 0xA64E6C51, 0x999090B6, 0x5F67D924 },	// 5^54
+	{ 0xD0CF4B50, 0xCFE20765, 0xFFF4B4E3, 0xF741CF6D },	// 5^55
+	{ 0x82818F12, 0x81ED449F, 0xBFF8F10E, 0x7A8921A4 },	// 5^56
+	{ 0xA321F2D7, 0x226895C7, 0xAFF72D52, 0x192B6A0D },	// 5^57
+	{ 0xCBEA6F8C, 0xEB02BB39, 0x9BF4F8A6, 0x9F764490 },	// 5^58
+	{ 0xFEE50B70, 0x25C36A08, 0x02F236D0, 0x4753D5B4 },	// 5^59
+	{ 0x9F4F2726, 0x179A2245, 0x01D76242, 0x2C946590 },	// 5^60
+	{ 0xC722F0EF, 0x9D80AAD6, 0x424D3AD2, 0xB7B97EF5 },	// 5^61
+	{ 0xF8EBAD2B, 0x84E0D58B, 0xD2E08987, 0x65A7DEB2 },	// 5^62
+	{ 0x9B934C3B, 0x330C8577, 0x63CC55F4, 0x9F88EB2F },	// 5^63
+	{ 0xC2781F49, 0xFFCFA6D5, 0x3CBF6B71, 0xC76B25FB }	// 5^64
+};
+
+bool dph::AsciiConverter::convert(const std::string& headerFilePath,
+	const std::vector<std::string>& dataFilePaths, const std::string& binaryFilePath,
+		unsigned threadsCount)
+{
+	// ---------------------------------- Заголовок ----------------------------------- //
+
+	std::vector<char> headerContent;
+
+	BinaryWriter writer;
+
+	size_t ncoeff = 0;
+
+	if (readFile(headerFilePath, headerContent) == false)
+	{
+		return false;
+	}
+	else if (parseHeader(headerContent, writer, ncoeff) == false)
+	{
+		return false;
+	}
+	else if (dataFilePaths.empty())
+	{
+		return false;
+	}
+
+	if (writer.open(binaryFilePath) == false)
+	{
+		return false;
+	}
+
+	// Количество коэффициентов блока, записываемых в файл (по ключам):
+	size_t payloadCount = writer.payloadCoeffCount();
+
+	if (payloadCount > ncoeff)
+	{
+		writer.close();
+		std::remove(binaryFilePath.c_str());
+
+		return false;
+	}
+
+	// ------------------------------------ Блоки ------------------------------------- //
+
+	if (threadsCount == 0)
+	{
+		threadsCount = Thread::hardwareConcurrency();
+	}
+
+	// Дата начала следующего записываемого блока:
+	size_t blocksCount = size_t((writer.endDate - writer.startDate) / writer.blockTimeSpan);
+	size_t blocksWritten = 0;
+
+	bool isCorrect = true;
+
+	for (size_t first = 0; first < dataFilePaths.size() && isCorrect; first += threadsCount)
+	{
+		// Пакет файлов:
+		size_t batchSize = dataFilePaths.size() - first < threadsCount ?
+			dataFilePaths.size() - first : threadsCount;
+
+		std::vector<DataFile> batch(batchSize);
+		Thread* threads = new Thread[batchSize];
+
+		for (size_t i = 0; i < batchSize; ++i)
+		{
+			batch[i].path = &dataFilePaths[first + i];
+			batch[i].ncoeff = ncoeff;
+			batch[i].isParsed = false;
+		}
+
+		// Первый файл пакета разбирается в текущем потоке:
+		for (size_t i = 1; i < batchSize; ++i)
+		{
+			if (threads[i].start(parseDataFile, &batch[i]) == false)
+			{
+				parseDataFile(&batch[i]);
+			}
+		}
+
+		parseDataFile(&batch[0]);
+
+		for (size_t i = 0; i < batchSize; ++i)
+		{
+			threads[i].join();
+		}
+
+		delete[] threads;
+
+		// Запись блоков пакета по порядку:
+		for (size_t i = 0; i < batchSize && isCorrect; ++i)
+		{
+			if (batch[i].isParsed == false)
+			{
+				isCorrect = false;
+				break;
+			}
+
+			const std::vector<double>& coefficients = batch[i].coefficients;
+
+			for (size_t offset = 0; offset < coefficients.size(); offset += ncoeff)
+			{
+				const double* block = &coefficients[offset];
+
+				// Ожидаемая дата начала блока:
+				double blockStartDate = writer.startDate + blocksWritten * writer.blockTimeSpan;
+
+				if (blocksWritten == blocksCount || block[0] < blockStartDate)
+				{
+					// Повтор на стыке файлов или блок вне промежутка выпуска.
+					continue;
+				}
+				else if (block[0] > blockStartDate)
+				{
+					// Пропущен блок.
+					isCorrect = false;
+					break;
+				}
+
+				writer.writeBlock(block);
+
+				++blocksWritten;
+			}
+
+			// Память пакета освобождается по мере записи:
+			std::vector<double>().swap(batch[i].coefficients);	// SWAP TRICK
+		}
+	}
+
+	if (writer.close() == false || isCorrect == false)
+	{
+		std::remove(binaryFilePath.c_str());
+
+		return false;
+	}
+
+	return true;
+}
+
+double dph::AsciiConverter::parseDouble(const char* text, const char** end)
+{
+	// Степени десяти, представимые в double точно:
+	static const double POWERS_OF_TEN[23] = {
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	const char* position = text;
+
+	while (*position == ' ' || *position == '\t')
+	{
+		++position;
+	}
+
+	const char* numberStart = position;
+
+	bool isNegative = false;
+
+	if (*position == '-' || *position == '+')
+	{
+		isNegative = *position == '-';
+		++position;
+	}
+
+	// Мантисса (не более 19 значащих цифр) и её десятичный порядок:
+	uint64_t mantissa = 0;
+	int digitsCount = 0;
+	int exponent = 0;
+	bool isExact = true;
+	bool hasDigits = false;
+
+	for (; *position >= '0' && *position <= '9'; ++position)
+	{
+		hasDigits = true;
+
+		if (digitsCount < 19)
+		{
+			mantissa = mantissa * 10 + (*position - '0');
+			digitsCount += mantissa != 0 ? 1 : 0;
+		}
+		else
+		{
+			++exponent;
+			isExact = isExact && *position == '0';
+		}
+	}
+
+	if (*position == '.')
+	{
+		for (++position; *position >= '0' && *position <= '9'; ++position)
+		{
+			hasDigits = true;
+
+			if (digitsCount < 19)
+			{
+				mantissa = mantissa * 10 + (*position - '0');
+				digitsCount += mantissa != 0 ? 1 : 0;
+				--exponent;
+			}
+			else
+			{
+				isExact = isExact && *position == '0';
+			}
+		}
+	}
+
+	if (hasDigits == false)
+	{
+		*end = text;
+
+		return 0.0;
+	}
+
+	// Порядок (D, d, E, e):
+	if (*position == 'D' || *position == 'd' || *position == 'E' || *position == 'e')
+	{
+		const char* exponentPosition = position + 1;
+
+		bool isExponentNegative = false;
+
+		if (*exponentPosition == '-' || *exponentPosition == '+')
+		{
+			isExponentNegative = *exponentPosition == '-';
+			++exponentPosition;
+		}
+
+		if (*exponentPosition >= '0' && *exponentPosition <= '9')
+		{
+			int exponentValue = 0;
+
+			for (; *exponentPosition >= '0' && *exponentPosition <= '9'; ++exponentPosition)
+			{
+				if (exponentValue < 10000)
+				{
+					exponentValue = exponentValue * 10 + (*exponentPosition - '0');
+				}
+			}
+
+			exponent += isExponentNegative ? -exponentValue : exponentValue;
+			position = exponentPosition;
+		}
+	}
+
+	*end = position;
+
+	// Незначащие нули мантиссы:
+	while (mantissa != 0 && mantissa % 10 == 0)
+	{
+		mantissa /= 10;
+		++exponent;
+	}
+
+	double result = 0.0;
+
+	if (mantissa == 0)
+	{
+		result = 0.0;
+	}
+	else if (isExact && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+	{
+		// Оба операнда точны, результат округляется один раз:
+		result = static_cast<double>(mantissa);
+		result = exponent < 0 ? result / POWERS_OF_TEN[-exponent] :
+			result * POWERS_OF_TEN[exponent];
+	}
+	else if (isExact == false || computeDouble(mantissa, exponent, result) == false)
+	{
+		// Общий случай: strtod по копии числа с заменой 'D' на 'E' и точки на
+		// десятичный разделитель текущей локали:
+		std::string buffer(numberStart, position);
+
+		char decimalPoint = std::localeconv()->decimal_point[0];
+
+		for (size_t i = 0; i < buffer.size(); ++i)
+		{
+			if (buffer[i] == 'D' || buffer[i] == 'd')
+			{
+				buffer[i] = 'E';
+			}
+			else if (buffer[i] == '.')
+			{
+				buffer[i] = decimalPoint;
+			}
+		}
+
+		return std::strtod(buffer.c_str(), NULL);
+	}
+
+	return isNegative ? -result : result;
+}
+
+bool dph::AsciiConverter::computeDouble(uint64_t mantissa, int exponent,
+	double& result)
+{
+	if (exponent < POWERS_OF_FIVE_MIN || exponent > POWERS_OF_FIVE_MAX)
+	{
+		return false;
+	}
+
+	// Нормализация мантиссы (старший бит - единица):
+	int leadingZeros = 0;
+
+	for (int shift = 32; shift > 0; shift /= 2)
+	{
+		if ((mantissa >> (64 - shift)) == 0)
+		{
+			mantissa <<= shift;
+			leadingZeros += shift;
+		}
+	}
+
+	const uint32_t* power = POWERS_OF_FIVE[exponent - POWERS_OF_FIVE_MIN];
+
+	uint64_t powerHigh = (uint64_t(power[0]) << 32) | power[1];
+	uint64_t powerLow = (uint64_t(power[2]) << 32) | power[3];
+
+	// Старшие 55 бит произведения (53 бита значения, бит округления и бит
+	// нормализации). Если младшие биты старшей части - все единицы, то
+	// учитывается младшая часть степени:
+	uint64_t high = 0;
+	uint64_t low = 0;
+
+	multiply(mantissa, powerHigh, high, low);
+
+	if ((high & 0x1FF) == 0x1FF)
+	{
+		uint64_t secondHigh = 0;
+		uint64_t secondLow = 0;
+
+		multiply(mantissa, powerLow, secondHigh, secondLow);
+
+		low += secondHigh;
+
+		if (secondHigh > low)
+		{
+			++high;
+		}
+	}
+
+	unsigned upperBit = static_cast<unsigned>(high >> 63);
+
+	uint64_t significand = high >> (upperBit + 9);
+
+	// Двоичный порядок со смещением: floor(exponent * log2(10)) + 63 (через
+	// 217706 / 2^16, деление с округлением вниз):
+	int scaledExponent = 217706 * exponent;
+	int binaryExponent = (scaledExponent >= 0 ? scaledExponent >> 16 :
+		-((-scaledExponent + 65535) >> 16)) + 63 + static_cast<int>(upperBit) -
+			leadingZeros + 1023;
+
+	if (binaryExponent <= 0)
+	{
+		return false;
+	}
+
+	// Значение ровно посередине между соседними (возможно только при точном
+	// произведении, т.е. при небольших порядках) округляется к чётному:
+	if (low <= 1 && exponent >= -4 && exponent <= 23 && (significand & 3) == 1 &&
+		(significand << (upperBit + 9)) == high)
+	{
+		significand &= ~uint64_t(1);
+	}
+
+	significand += significand & 1;
+	significand >>= 1;
+
+	if (significand >= (uint64_t(2) << 52))
+	{
+		significand = uint64_t(1) << 52;
+		++binaryExponent;
+	}
+
+	significand &= ~(uint64_t(1) << 52);
+
+	if (binaryExponent >= 0x7FF)
+	{
+		return false;
+	}
+
+	uint64_t bits = significand | (uint64_t(binaryExponent) << 52);
+
+	std::memcpy(&result, &bits, sizeof(double));
+
+	return true;
+}
+
+void dph::AsciiConverter::multiply(uint64_t a, uint64_t b, uint64_t& high,
+	uint64_t& low)
+{
+	uint64_t aLow = a & 0xFFFFFFFF;
+	uint64_t aHigh = a >> 32;
+	uint64_t bLow = b & 0xFFFFFFFF;
+	uint64_t bHigh = b >> 32;
+
+	uint64_t lowLow = aLow * bLow;
+	uint64_t lowHigh = aLow * bHigh;
+	uint64_t highLow = aHigh * bLow;
+
+	uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFF) + (highLow & 0xFFFFFFFF);
+
+	low = (middle << 32) | (lowLow & 0xFFFFFFFF);
+	high = aHigh * bHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+}
+
+bool dph::AsciiConverter::readFile(const std::string& filePath, std::vector<char>& content)
+{
+	std::FILE* file = std::fopen(filePath.c_str(), "rb");
+
+	if (file == NULL)
+	{
+		return false;
+	}
+
+	content.clear();
+
+	char buffer[1 << 16];
+
+	size_t count = 0;
+
+	while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		content.insert(content.end(), buffer, buffer + count);
+	}
+
+	bool isRead = std::ferror(file) == 0;
+
+	std::fclose(file);
+
+	content.push_back('\0');
+
+	return isRead;
+}
+
+bool dph::AsciiConverter::parseHeader(const std::vector<char>& content,
+	BinaryWriter& writer, size_t& ncoeff)
+{
+	const char* text = &content[0];
+
+	// NCOEFF (первая строка: "KSIZE= NNNN    NCOEFF= NNNN"):
+	const char* ncoeffPosition = std::strstr(text, "NCOEFF=");
+
+	if (ncoeffPosition == NULL)
+	{
+		return false;
+	}
+
+	ncoeff = std::strtoul(ncoeffPosition + 7, NULL, 10);
+
+	// Группа 1010: строки информации о выпуске.
+	const char* position = findGroup(text, "1010");
+
+	if (position == NULL)
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < 3; ++i)
+	{
+		// Пропуск пустых строк:
+		while (*position == '\n' || *position == '\r')
+		{
+			++position;
+		}
+
+		const char* lineEnd = position;
+
+		while (*lineEnd != '\0' && *lineEnd != '\n' && *lineEnd != '\r')
+		{
+			++lineEnd;
+		}
+
+		// Строка без завершающих пробелов:
+		const char* textEnd = lineEnd;
+
+		while (textEnd > position && textEnd[-1] == ' ')
+		{
+			--textEnd;
+		}
+
+		writer.releaseLabel[i].assign(position, textEnd);
+
+		position = lineEnd;
+	}
+
+	// Группа 1030: даты начала и окончания выпуска, протяжённость блока.
+	position = findGroup(text, "1030");
+
+	if (position == NULL)
+	{
+		return false;
+	}
+
+	writer.startDate = parseDouble(skipSpaces(position), &position);
+	writer.endDate = parseDouble(skipSpaces(position), &position);
+	writer.blockTimeSpan = parseDouble(skipSpaces(position), &position);
+
+	// Группа 1040: имена констант.
+	position = findGroup(text, "1040");
+
+	if (position == NULL)
+	{
+		return false;
+	}
+
+	position = skipSpaces(position);
+
+	size_t constantsCount = std::strtoul(position, NULL, 10);
+
+	position = nextLine(position);
+
+	for (size_t i = 0; i < constantsCount; ++i)
+	{
+		position = skipSpaces(position);
+
+		const char* nameEnd = position;
+
+		while (*nameEnd != '\0' && *nameEnd != ' ' && *nameEnd != '\n' && *nameEnd != '\r')
+		{
+			++nameEnd;
+		}
+
+		if (nameEnd == position)
+		{
+			return false;
+		}
+
+		writer.constantsNames.push_back(std::string(position, nameEnd));
+
+		position = nameEnd;
+	}
+
+	// Группа 1041: значения констант.
+	position = findGroup(text, "1041");
+
+	if (position == NULL)
+	{
+		return false;
+	}
+
+	position = skipSpaces(position);
+
+	if (std::strtoul(position, NULL, 10) != constantsCount)
+	{
+		return false;
+	}
+
+	position = nextLine(position);
+
+	for (size_t i = 0; i < constantsCount; ++i)
+	{
+		const char* valueEnd = position;
+
+		double value = parseDouble(skipSpaces(position), &valueEnd);
+
+		if (valueEnd == skipSpaces(position))
+		{
+			return false;
+		}
+
+		writer.constantsValues.push_back(value);
+
+		position = valueEnd;
+
+		// Значения AU, EMRAT и DENUM дублируются в заголовке бинарного файла:
+		const std::string& name = writer.constantsNames[i];
+
+		if (name == "AU")
+		{
+			writer.au = value;
+		}
+		else if (name == "EMRAT")
+		{
+			writer.emrat = value;
+		}
+		else if (name == "DENUM")
+		{
+			writer.releaseIndex = static_cast<uint32_t>(value);
+		}
+	}
+
+	// Группа 1050: ключи (три строки по 13 или 15 значений).
+	position = findGroup(text, "1050");
+
+	if (position == NULL)
+	{
+		return false;
+	}
+
+	for (size_t row = 0; row < 3; ++row)
+	{
+		position = skipSpaces(position);
+
+		const char* lineEnd = nextLine(position);
+
+		for (size_t item = 0; item < 15; ++item)
+		{
+			position = skipSpaces(position);
+
+			if (position >= lineEnd || *position < '0' || *position > '9')
+			{
+				break;
+			}
+
+			char* valueEnd = NULL;
+
+			writer.inputKeys[item][row] = static_cast<uint32_t>(
+				std::strtoul(position, &valueEnd, 10));
+
+			position = valueEnd;
+		}
+
+		position = lineEnd;
+	}
+
+	return writer.startDate < writer.endDate && writer.blockTimeSpan > 0 && ncoeff > 2;
+}
+
+void dph::AsciiConverter::parseDataFile(void* dataFile)
+{
+	DataFile& file = *static_cast<DataFile*>(dataFile);
+
+	std::FILE* stream = std::fopen(file.path->c_str(), "rb");
+
+	if (stream == NULL)
+	{
+		return;
+	}
+
+	// Файл читается частями. Разбираются только полные строки (числа не
+	// переносятся), неполная строка переносится в начало буфера:
+	std::vector<char> buffer(READ_BUFFER_SIZE + 1);
+
+	size_t filled = 0;
+	size_t remaining = 0;
+
+	bool isCorrect = true;
+	bool isEnd = false;
+
+	while (isCorrect && isEnd == false)
+	{
+		size_t count = std::fread(&buffer[filled], 1, READ_BUFFER_SIZE - filled, stream);
+
+		filled += count;
+		isEnd = count == 0;
+
+		// Граница разбора - после последнего перевода строки (в конце файла
+		// разбирается всё):
+		size_t parsedSize = filled;
+
+		while (isEnd == false && parsedSize > 0 && buffer[parsedSize - 1] != '\n')
+		{
+			--parsedSize;
+		}
+
+		// Строка длиннее буфера:
+		if (parsedSize == 0 && filled == READ_BUFFER_SIZE)
+		{
+			isCorrect = false;
+
+			break;
+		}
+
+		char nextChar = buffer[parsedSize];
+		buffer[parsedSize] = '\0';
+
+		isCorrect = parseDataLines(&buffer[0], file, remaining);
+
+		buffer[parsedSize] = nextChar;
+
+		std::memmove(&buffer[0], &buffer[parsedSize], filled - parsedSize);
+		filled -= parsedSize;
+	}
+
+	file.isParsed = isCorrect && std::ferror(stream) == 0 && remaining == 0;
+
+	std::fclose(stream);
+}
+
+bool dph::AsciiConverter::parseDataLines(const char* text, DataFile& file,
+	size_t& remaining)
+{
+	// Записи: строка "номер_блока ncoeff", затем ncoeff значений по три в
+	// строке (последняя строка дополнена нулями).
+	for (const char* position = skipSpaces(text); *position != '\0';
+		position = skipSpaces(position))
+	{
+		if (remaining == 0)
+		{
+			char* valueEnd = NULL;
+
+			std::strtoul(position, &valueEnd, 10);
+
+			size_t recordCoeffCount = std::strtoul(valueEnd, &valueEnd, 10);
+
+			if (recordCoeffCount != file.ncoeff)
+			{
+				return false;
+			}
+
+			file.coefficients.resize(file.coefficients.size() + file.ncoeff);
+
+			remaining = file.ncoeff;
+			position = nextLine(valueEnd);
+
+			continue;
+		}
+
+		// Значения строки (дополняющие нули в конце последней строки записи
+		// пропускаются):
+		const char* lineEnd = nextLine(position);
+
+		while (remaining != 0)
+		{
+			const char* numberStart = skipSpaces(position);
+
+			if (numberStart >= lineEnd)
+			{
+				break;
+			}
+
+			file.coefficients[file.coefficients.size() - remaining] =
+				parseDouble(numberStart, &position);
+
+			if (position == numberStart)
+			{
+				return false;
+			}
+
+			--remaining;
+		}
+
+		position = lineEnd;
+	}
+
+	return true;
+}
+
+const char* dph::AsciiConverter::nextLine(const char* text)
+{
+	while (*text != '\0' && *text != '\n')
+	{
+		++text;
+	}
+
+	return *text == '\n' ? text + 1 : text;
+}
+
+const char* dph::AsciiConverter::skipSpaces(const char* text)
+{
+	while (*text == ' ' || *text == '\t' || *text == '\n' || *text == '\r')
+	{
+		++text;
+	}
+
+	return text;
+}
+
+const char* dph::AsciiConverter::findGroup(const char* text, const char* groupIndex)
+{
+	for (const char* position = std::strstr(text, "GROUP"); position != NULL;
+		position = std::strstr(position + 5, "GROUP"))
+	{
+		const char* indexPosition = skipSpaces(position + 5);
+
+		if (std::strncmp(indexPosition, groupIndex, 4) == 0)
+		{
+			return nextLine(indexPosition);
+		}
+	}
+
+	return NULL;
+}
+
+#endif // DEPHEM_ASCII_CONVERTER_HPP
@@ -0,0 +1,390 @@
+#ifndef DEPHEM_BINARY_WRITER_HPP
+#define DEPHEM_BINARY_WRITER_HPP
+
+#include <fstream>
+#include <cstring>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                               BinaryWriter                                 //
+//                                                                            //
+//             Запись файла эфемерид в бинарном формате JPL                   //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс для создания бинарных файлов эфемерид, которые       //
+// читает dph::EphemerisRelease. Используется dph::ReleaseTrimmer и           //
+// dph::AsciiConverter.                                                       //
+//                                                                            //
+// Порядок работы:                                                            //
+//    1. Заполнить открытые поля (строки заголовка, даты, ключи, константы).  //
+//    2. Вызвать open(...) - запись заголовка и блока констант.               //
+//    3. Вызвать writeBlock(...) для каждого блока коэффициентов по порядку.  //
+//    4. Вызвать close() - проверка количества записанных блоков.             //
+//                                                                            //
+// Размер записи файла определяется ключами (ncoeff). Заголовок и значения    //
+// констант должны умещаться в одну запись. Если запись для них мала, то в    //
+// свободную ячейку ключей добавляется элемент-заполнитель с нулевыми         //
+// коэффициентами. Ячейки выбираются в порядке FILLER_ITEMS: сначала либрации //
+// и угловая скорость мантии Луны (12, 13), затем нутации (11) и TT-TDB (14), //
+// затем остальные. Индекс ячейки заполнителя записывается в файл последней   //
+// константой FILLER_CONSTANT, по ней dph::EphemerisRelease не считает        //
+// заполнитель хранящимся в файле элементом.                                  //
+//                                                                            //
+// Объект не копируется.                                                      //
+//                                                                            //
+// ************************************************************************** //
+class BinaryWriter
+{
+public:
+
+	// Конструктор по умолчанию.
+	BinaryWriter();
+
+	// Деструктор (закрытие файла без проверки).
+	~BinaryWriter();
+
+	// Создать файл по пути "binaryFilePath" и записать в него заголовок и
+	// блок констант. Возвращает false, если значения полей некорректны или
+	// файл не удалось создать.
+	bool open(const std::string& binaryFilePath);
+
+	// Записать очередной блок коэффициентов. Массив "coeffArray" содержит
+	// payloadCoeffCount() значений: даты блока и коэффициенты элементов по
+	// ключам, заданным до open(...) (без элемента-заполнителя).
+	bool writeBlock(const double* coeffArray);
+
+	// Закрыть файл. Возвращает true, если записаны все блоки выпуска и
+	// запись прошла без ошибок.
+	bool close();
+
+	// Количество коэффициентов в блоке без элемента-заполнителя.
+	uint32_t payloadCoeffCount() const;
+
+	// Количество коэффициентов в записи файла (ncoeff).
+	uint32_t coeffCount() const;
+
+	// Итоговые ключи (с элементом-заполнителем, если он потребовался).
+	const uint32_t (&keys() const)[15][3];
+
+	// Количество компонент базового элемента "baseItemIndex".
+	static unsigned componentsCount(unsigned baseItemIndex);
+
+	// Количество коэффициентов в блоке (ncoeff) для ключей "keys".
+	static uint32_t coeffCount(const uint32_t (&keys)[15][3]);
+
+	// Имя константы с индексом ячейки ключей элемента-заполнителя
+	// (зарезервировано, в "constantsNames" не указывается).
+	static const char FILLER_CONSTANT[];
+
+// ------------------------- Значения заголовка ----------------------------- //
+
+	std::string		releaseLabel[3];	// Строки информации о выпуске.
+	uint32_t		releaseIndex;		// Номер выпуска (DENUM).
+	double			startDate;			// Дата начала выпуска (JED).
+	double			endDate;			// Дата окончания выпуска (JED).
+	double			blockTimeSpan;		// Временная протяжённость блока.
+	double			au;					// Астрономическая единица (км).
+	double			emrat;				// Отношение массы Земли к массе Луны.
+	uint32_t		inputKeys[15][3];	// Ключи элементов (без заполнителя).
+
+	std::vector<std::string>	constantsNames;		// Имена констант.
+	std::vector<double>			constantsValues;	// Значения констант.
+
+private:
+
+	// Запрет на копирование.
+	BinaryWriter(const BinaryWriter&);
+	BinaryWriter& operator=(const BinaryWriter&);
+
+	// Ячейки ключей для элемента-заполнителя в порядке предпочтения.
+	static const unsigned FILLER_ITEMS[15];
+
+	// Размеры полей заголовка (см. dph::EphemerisRelease).
+	static const size_t RLS_LABEL_SIZE = 84;
+	static const size_t CNAME_SIZE = 6;
+	static const size_t CCOUNT_MAX_OLD = 400;
+	static const size_t CCOUNT_MAX_NEW = 1000;
+
+	// Размер заголовка в байтах для "constantsCount" констант.
+	static size_t headerSize(size_t constantsCount);
+
+	// Требуемое количество коэффициентов в записи (заголовок и значения
+	// "constantsCount" констант).
+	static size_t requiredCoeffCount(size_t constantsCount);
+
+	// Записать строку "text", дополненную пробелами до "size" символов.
+	void writePadded(const std::string& text, size_t size);
+
+	std::ofstream	m_stream;			// Поток записи файла.
+	uint32_t		m_keys[15][3];		// Итоговые ключи.
+	uint32_t		m_payloadCount;		// Коэффициентов в блоке без заполнителя.
+	uint32_t		m_ncoeff;			// Коэффициентов в записи.
+	size_t			m_blocksCount;		// Ожидаемое количество блоков.
+	size_t			m_blocksWritten;	// Записано блоков.
+};
+
+} // namespace dph
+
+const unsigned dph::BinaryWriter::FILLER_ITEMS[15] =
+	{ 12, 13, 11, 14, 8, 7, 6, 5, 4, 3, 1, 0, 10, 9, 2 };
+
+const char dph::BinaryWriter::FILLER_CONSTANT[] = "FILLER";
+
+dph::BinaryWriter::BinaryWriter()
+	: releaseIndex(0), startDate(0.0), endDate(0.0), blockTimeSpan(0.0), au(0.0),
+	emrat(0.0), m_payloadCount(0), m_ncoeff(0), m_blocksCount(0), m_blocksWritten(0)
+{
+	std::memset(inputKeys, 0, sizeof(inputKeys));
+	std::memset(m_keys, 0, sizeof(m_keys));
+}
+
+dph::BinaryWriter::~BinaryWriter()
+{
+	m_stream.close();
+}
+
+bool dph::BinaryWriter::open(const std::string& binaryFilePath)
+{
+	m_stream.close();
+	m_stream.clear();
+
+	size_t constantsCount = constantsNames.size();
+
+	// Условия недопустимые для записи:
+	if (startDate >= endDate || blockTimeSpan <= 0)
+	{
+		return false;
+	}
+	else if (constantsCount != constantsValues.size() || constantsCount > CCOUNT_MAX_NEW)
+	{
+		return false;
+	}
+
+	std::memcpy(m_keys, inputKeys, sizeof(m_keys));
+
+	m_payloadCount = coeffCount(m_keys);
+	m_ncoeff = m_payloadCount;
+	m_blocksCount = size_t((endDate - startDate) / blockTimeSpan);
+	m_blocksWritten = 0;
+
+	if (m_blocksCount == 0)
+	{
+		return false;
+	}
+
+	// Константы файла (с константой заполнителя, если он потребуется):
+	std::vector<std::string> names(constantsNames);
+	std::vector<double> values(constantsValues);
+
+	// Элемент-заполнитель (запись рассчитывается с его константой):
+	if (m_ncoeff < requiredCoeffCount(constantsCount))
+	{
+		if (constantsCount == CCOUNT_MAX_NEW)
+		{
+			return false;
+		}
+
+		++constantsCount;
+
+		size_t deficit = requiredCoeffCount(constantsCount) - m_ncoeff;
+
+		bool isFillerAdded = false;
+
+		for (size_t i = 0; i < 15 && isFillerAdded == false; ++i)
+		{
+			unsigned item = FILLER_ITEMS[i];
+
+			if (m_keys[item][1] != 0 && m_keys[item][2] != 0)
+			{
+				continue;
+			}
+
+			// Два коэффициента на компоненту, количество подынтервалов - по
+			// недостающему количеству коэффициентов:
+			uint32_t granuleSize = 2 * componentsCount(item);
+
+			m_keys[item][0] = m_ncoeff + 1;
+			m_keys[item][1] = 2;
+			m_keys[item][2] = static_cast<uint32_t>((deficit + granuleSize - 1) / granuleSize);
+
+			m_ncoeff += m_keys[item][2] * granuleSize;
+
+			names.push_back(FILLER_CONSTANT);
+			values.push_back(item);
+
+			isFillerAdded = true;
+		}
+
+		if (isFillerAdded == false)
+		{
+			return false;
+		}
+	}
+
+	m_stream.open(binaryFilePath.c_str(), std::ios::binary | std::ios::trunc);
+
+	if (m_stream.is_open() == false)
+	{
+		return false;
+	}
+
+	// ------------------------------ Запись заголовка ------------------------------ //
+
+	uint32_t ncon = static_cast<uint32_t>(constantsCount);
+
+	for (size_t i = 0; i < 3; ++i)
+	{
+		writePadded(releaseLabel[i], RLS_LABEL_SIZE);
+	}
+
+	for (size_t i = 0; i < CCOUNT_MAX_OLD; ++i)
+	{
+		writePadded(i < constantsCount ? names[i] : std::string(), CNAME_SIZE);
+	}
+
+	m_stream.write((const char*)&startDate, 8);
+	m_stream.write((const char*)&endDate, 8);
+	m_stream.write((const char*)&blockTimeSpan, 8);
+	m_stream.write((const char*)&ncon, 4);
+	m_stream.write((const char*)&au, 8);
+	m_stream.write((const char*)&emrat, 8);
+	m_stream.write((const char*)&m_keys, (12 * 3) * 4);
+	m_stream.write((const char*)&releaseIndex, 4);
+	m_stream.write((const char*)&m_keys[12], (3) * 4);
+
+	for (size_t i = CCOUNT_MAX_OLD; i < constantsCount; ++i)
+	{
+		writePadded(names[i], CNAME_SIZE);
+	}
+
+	m_stream.write((const char*)&m_keys[13], (3 * 2) * 4);
+
+	// Дополнение записи нулями:
+	std::vector<char> zeros(m_ncoeff * 8 - headerSize(constantsCount), 0);
+
+	if (zeros.empty() == false)
+	{
+		m_stream.write(&zeros[0], zeros.size());
+	}
+
+	// ------------------------- Запись значений констант --------------------------- //
+
+	std::vector<double> constantsRecord(m_ncoeff, 0.0);
+
+	for (size_t i = 0; i < constantsCount; ++i)
+	{
+		constantsRecord[i] = values[i];
+	}
+
+	m_stream.write((const char*)&constantsRecord[0], m_ncoeff * 8);
+
+	return m_stream.good();
+}
+
+bool dph::BinaryWriter::writeBlock(const double* coeffArray)
+{
+	if (m_stream.is_open() == false || coeffArray == NULL)
+	{
+		return false;
+	}
+
+	m_stream.write((const char*)coeffArray, m_payloadCount * 8);
+
+	// Коэффициенты элемента-заполнителя:
+	if (m_ncoeff > m_payloadCount)
+	{
+		std::vector<double> filler(m_ncoeff - m_payloadCount, 0.0);
+
+		m_stream.write((const char*)&filler[0], filler.size() * 8);
+	}
+
+	++m_blocksWritten;
+
+	return m_stream.good();
+}
+
+bool dph::BinaryWriter::close()
+{
+	if (m_stream.is_open() == false)
+	{
+		return false;
+	}
+
+	m_stream.flush();
+
+	bool isCorrect = m_stream.good() && m_blocksWritten == m_blocksCount;
+
+	m_stream.close();
+
+	return isCorrect;
+}
+
+uint32_t dph::BinaryWriter::payloadCoeffCount() const
+{
+	return m_payloadCount;
+}
+
+uint32_t dph::BinaryWriter::coeffCount() const
+{
+	return m_ncoeff;
+}
+
+const uint32_t (&dph::BinaryWriter::keys() const)[15][3]
+{
+	return m_keys;
+}
+
+size_t dph::BinaryWriter::headerSize(size_t constantsCount)
+{
+	size_t size = RLS_LABEL_SIZE * 3 + CNAME_SIZE * CCOUNT_MAX_OLD + 8 * 3 + 4 +
+		8 * 2 + 4 * 3 * 12 + 4 + 4 * 3 + 4 * 3 * 2;
+
+	if (constantsCount > CCOUNT_MAX_OLD)
+	{
+		size += (constantsCount - CCOUNT_MAX_OLD) * CNAME_SIZE;
+	}
+
+	return size;
+}
+
+size_t dph::BinaryWriter::requiredCoeffCount(size_t constantsCount)
+{
+	size_t requiredCount = (headerSize(constantsCount) + 7) / 8;
+
+	return constantsCount > requiredCount ? constantsCount : requiredCount;
+}
+
+unsigned dph::BinaryWriter::componentsCount(unsigned baseItemIndex)
+{
+	return baseItemIndex == 11 ? 2 : baseItemIndex == 14 ? 1 : 3;
+}
+
+uint32_t dph::BinaryWriter::coeffCount(const uint32_t (&keys)[15][3])
+{
+	// См. dph::EphemerisRelease::readAndPackData().
+	uint32_t ncoeff = 2;
+
+	for (unsigned i = 0; i < 15; ++i)
+	{
+		ncoeff += componentsCount(i) * keys[i][1] * keys[i][2];
+	}
+
+	return ncoeff;
+}
+
+void dph::BinaryWriter::writePadded(const std::string& text, size_t size)
+{
+	std::string padded = text.substr(0, size);
+
+	padded.resize(size, ' ');
+
+	m_stream.write(padded.c_str(), size);
+}
+
+#endif // DEPHEM_BINARY_WRITER_HPP
@@ -0,0 +1,239 @@
+#ifndef DEPHEM_CALCULATION_CONTEXT_HPP
+#define DEPHEM_CALCULATION_CONTEXT_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <stdint.h>
+#include <vector>
+
+#include "ReadAhead.hpp"
+#include "Statistics.hpp"
+
+namespace dph
+{
+
+class EphemerisRelease;
+
+// ************************************************************************** //
+//                            CalculationContext                              //
+//                                                                            //
+//                  Изменяемое состояние процесса вычислений                  //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Объект данного класса хранит всё, что изменяется в ходе вычислений:        //
+// буффер блока коэффициентов, номер текущего блока, значения полиномов и     //
+// (при доступе Access::STREAM) собственный поток чтения файла.               //
+//                                                                            //
+// Сам объект dph::EphemerisRelease после открытия не изменяется. Поэтому     //
+// для вычислений из нескольких потоков над одним выпуском достаточно         //
+// передавать в методы calculateBody/calculateOther отдельный контекст для    //
+// каждого потока. Синхронизация между потоками при этом не требуется.        //
+//                                                                            //
+// Контекст привязывается к выпуску при первом использовании. При передаче    //
+// контекста другому выпуску он переинициализируется. Привязка относится к    //
+// состоянию выпуска, а не к адресу объекта: после открытия, копирования,     //
+// перемещения или очистки выпуска (в т.ч. нового выпуска по адресу           //
+// уничтоженного) контекст также переинициализируется.                        //
+//                                                                            //
+// При доступе Access::STREAM каждый контекст открывает свой поток чтения     //
+// файла. При доступе Access::MMAP (Access::MEMORY) все контексты читают      //
+// коэффициенты из общего отображения (загруженного в память файла) и         //
+// дескрипторов не занимают.                                                  //
+//                                                                            //
+// При доступе Access::STREAM контекст хранит кэш из нескольких блоков (объём //
+// задаётся dph::ReleaseOptions::cacheSize_bytes, но не менее двух блоков:    //
+// видимое положение использует блок момента наблюдения и блок момента        //
+// излучения). Вытеснение блоков выполняется по алгоритму CLOCK (приближение  //
+// LRU). Счётчики кэша учитывают только переходы к блоку, отличному от        //
+// текущего: попадание - блок найден в кэше, промах - блок прочитан из файла  //
+// (при доступе Access::MMAP и Access::MEMORY каждый переход считается        //
+// промахом), вытеснение - блок удалён из кэша.                               //
+//                                                                            //
+// При упреждающей загрузке (dph::ReleaseOptions::prefetchBlocksCount)        //
+// контекст отслеживает направление обхода блоков: если очередной блок        //
+// следует за текущим (или предшествует ему), ОС запрашивается загрузка       //
+// следующих в том же направлении блоков.                                     //
+//                                                                            //
+// Прочие счётчики (чтение, интерполяции, время) собираются только при        //
+// определённом DEPHEM_ENABLE_STATS, см. dph::Statistics.                     //
+//                                                                            //
+// Объект не копируется.                                                      //
+//                                                                            //
+// ************************************************************************** //
+class CalculationContext
+{
+public:
+
+	// Конструктор по умолчанию (контекст не привязан к выпуску).
+	CalculationContext();
+
+	// Деструктор.
+	~CalculationContext();
+
+	// Отвязать контекст от выпуска и освободить занимаемые ресурсы.
+	void reset();
+
+	// Количество переходов к блоку, найденному в кэше.
+	uint64_t cacheHits() const;
+
+	// Количество переходов к блоку, потребовавших его чтения.
+	uint64_t cacheMisses() const;
+
+	// Количество блоков, вытесненных из кэша.
+	uint64_t cacheEvictions() const;
+
+	// Обнулить счётчики кэша.
+	void resetCacheCounters();
+
+	// Снимок счётчиков контекста (см. dph::Statistics).
+	Statistics statistics() const;
+
+	// Обнулить все счётчики контекста (включая счётчики кэша).
+	void resetStatistics();
+
+private:
+
+	friend class EphemerisRelease;
+
+	// Запрет на копирование.
+	CalculationContext(const CalculationContext&);
+	CalculationContext& operator=(const CalculationContext&);
+
+	const EphemerisRelease* m_owner;	// Выпуск, к которому привязан контекст.
+	uint64_t m_ownerGeneration;			// Поколение выпуска при привязке.
+
+	std::ifstream m_stream;				// Поток чтения файла (Access::STREAM).
+
+	std::vector<double> m_buffer;		// Буффер блока с коэффициентами.
+	std::vector<double> m_poly;			// Значения полиномов.
+	std::vector<double> m_dpoly;		// Значения производных полиномов.
+
+	// Полиномы переиспользуются элементами с тем же нормированным временем
+	// (например, при вычислении нескольких тел на один момент времени):
+	double		m_polyTime;		// Нормированное время вычисленных полиномов.
+	uint32_t	m_polyCount;	// Количество вычисленных полиномов (0 - нет).
+	uint32_t	m_dpolyCount;	// Количество вычисленных производных.
+
+	const double*	m_block;			// Коэффициенты текущего блока.
+	size_t			m_blockIndex;		// Порядковый номер текущего блока.
+
+	// Признаки блоков с проверенными датами, по биту на блок 
+	// (Validation::LAZY).
+	std::vector<unsigned char> m_checkedBlocks;
+
+	// Кэш блоков (Access::STREAM). Ячейка i кэша занимает в m_buffer 
+	// коэффициенты с i * ncoeff.
+	std::vector<size_t>			m_cacheSlotBlocks;	// Номера блоков в ячейках.
+	std::vector<size_t>			m_cacheBlockSlots;	// Ячейки блоков (если ячеек > 2).
+	std::vector<unsigned char>	m_cacheReferenced;	// Признаки обращения (CLOCK).
+	size_t						m_cacheHand;		// "Стрелка" алгоритма CLOCK.
+
+	// Упреждающая загрузка блоков:
+	ReadAhead	m_readAhead;			// Подсказки ОС (Access::STREAM).
+	int			m_prefetchDirection;	// Направление обхода (1, -1, 0 - нет).
+	size_t		m_prefetchEdge;			// Последний запрошенный блок.
+
+	uint64_t m_cacheHits;		// Счётчик попаданий.
+	uint64_t m_cacheMisses;		// Счётчик промахов.
+	uint64_t m_cacheEvictions;	// Счётчик вытеснений.
+
+#ifdef DEPHEM_ENABLE_STATS
+	Statistics m_statistics;	// Прочие счётчики (DEPHEM_ENABLE_STATS).
+#endif
+};
+
+} // namespace dph
+
+dph::CalculationContext::CalculationContext()
+	: m_owner(NULL), m_ownerGeneration(0), m_polyTime(0), m_polyCount(0), 
+	m_dpolyCount(0), m_block(NULL), m_blockIndex(size_t(-1)), m_cacheHand(0), 
+	m_prefetchDirection(0), m_prefetchEdge(0), m_cacheHits(0), m_cacheMisses(0), 
+	m_cacheEvictions(0)
+{
+}
+
+dph::CalculationContext::~CalculationContext()
+{
+	m_stream.close();
+}
+
+void dph::CalculationContext::reset()
+{
+	m_owner = NULL;
+	m_ownerGeneration = 0;
+
+	m_stream.close();
+	m_stream.clear();
+
+	std::vector<double>().swap(m_buffer);	// SWAP TRICK
+	std::vector<double>().swap(m_poly);		// SWAP TRICK
+	std::vector<double>().swap(m_dpoly);	// SWAP TRICK
+	m_polyTime = 0;
+	m_polyCount = 0;
+	m_dpolyCount = 0;
+
+	std::vector<unsigned char>().swap(m_checkedBlocks);	// SWAP TRICK
+
+	std::vector<size_t>().swap(m_cacheSlotBlocks);			// SWAP TRICK
+	std::vector<size_t>().swap(m_cacheBlockSlots);			// SWAP TRICK
+	std::vector<unsigned char>().swap(m_cacheReferenced);	// SWAP TRICK
+	m_cacheHand = 0;
+
+	m_readAhead.close();
+	m_prefetchDirection = 0;
+	m_prefetchEdge = 0;
+
+	m_block = NULL;
+	m_blockIndex = size_t(-1);
+
+	resetStatistics();
+}
+
+uint64_t dph::CalculationContext::cacheHits() const
+{
+	return m_cacheHits;
+}
+
+uint64_t dph::CalculationContext::cacheMisses() const
+{
+	return m_cacheMisses;
+}
+
+uint64_t dph::CalculationContext::cacheEvictions() const
+{
+	return m_cacheEvictions;
+}
+
+void dph::CalculationContext::resetCacheCounters()
+{
+	m_cacheHits = 0;
+	m_cacheMisses = 0;
+	m_cacheEvictions = 0;
+}
+
+dph::Statistics dph::CalculationContext::statistics() const
+{
+#ifdef DEPHEM_ENABLE_STATS
+	Statistics statistics = m_statistics;
+#else
+	Statistics statistics;
+#endif
+
+	statistics.cacheHits = m_cacheHits;
+	statistics.cacheMisses = m_cacheMisses;
+	statistics.cacheEvictions = m_cacheEvictions;
+
+	return statistics;
+}
+
+void dph::CalculationContext::resetStatistics()
+{
+	resetCacheCounters();
+
+#ifdef DEPHEM_ENABLE_STATS
+	m_statistics.reset();
+#endif
+}
+
+#endif // DEPHEM_CALCULATION_CONTEXT_HPP
@@ -0,0 +1,1524 @@
+#ifndef DEPHEM_CHEBYSHEV_HPP
+#define DEPHEM_CHEBYSHEV_HPP
+
+#include <cstddef>
+#include <stdint.h>
+
+#include "help.hpp" // InstructionSet::...
+
+// Векторные ядра доступны только на x86 (GCC/Clang - через атрибут target,
+// MSVC - без ограничений). Отключаются определением DEPHEM_NO_SIMD.
+#if !defined(DEPHEM_NO_SIMD) && (defined(__x86_64__) || defined(__i386__) || \
+	defined(_M_X64) || defined(_M_IX86))
+#if defined(__GNUC__) || defined(__clang__)
+#define DEPHEM_SIMD_X86
+#define DEPHEM_TARGET(isa) __attribute__((target(isa)))
+#elif defined(_MSC_VER)
+#define DEPHEM_SIMD_X86
+#define DEPHEM_TARGET(isa)
+#include <intrin.h>
+#endif
+#endif
+
+#ifdef DEPHEM_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                                 Chebyshev                                  //
+//                                                                            //
+//              Ядра интерполяции полиномами Чебышёва (SIMD)                  //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс с ядрами вычисления сумм рядов Чебышёва для          //
+// dph::EphemerisRelease.                                                     //
+//                                                                            //
+// Для распространённых сочетаний количества коэффициентов (FIXED_CPEC_MIN -  //
+// FIXED_CPEC_MAX) и компонент (1 - 3) есть шаблонные ядра вычисления на один //
+// момент времени с известными при компиляции размерами: циклы                //
+// разворачиваются компилятором, значения полиномов остаются в регистрах. Для //
+// двух и трёх компонент есть версии ядер для наборов инструкций SSE2 и AVX2  //
+// с векторизацией по компонентам элемента (x, y [, z]; при AVX-512           //
+// используется версия AVX2). Ядро выбирается один раз для каждого элемента   //
+// выпуска (см. positionKernel(...) и stateKernel(...)), для остальных        //
+// элементов используются скалярные sumPosition(...) и sumState(...).         //
+//                                                                            //
+// Ядра на пакет моментов времени (positionChunk(...) и stateChunk(...))      //
+// имеют скалярную версию и версии для наборов инструкций SSE2, AVX2 и        //
+// AVX-512 (см. dph::InstructionSet). Версия выбирается во время выполнения   //
+// по возможностям процессора. Векторизация выполняется не по коэффициентам   //
+// (это изменило бы порядок суммирования), а по моментам времени (в ядрах на  //
+// пакет) или по компонентам (в шаблонных ядрах): каждое значение вычисляется //
+// той же последовательностью операций, что и в скалярной версии, поэтому     //
+// результаты всех версий совпадают побитово.                                 //
+//                                                                            //
+// ************************************************************************** //
+class Chebyshev
+{
+public:
+
+	// Лучший набор инструкций, поддерживаемый процессором и ОС.
+	static unsigned detectInstructionSet();
+
+	// Набор инструкций для использования: запрошенный "requested", но не
+	// выше поддерживаемого процессором.
+	static unsigned selectInstructionSet(unsigned requested);
+
+	// Суммы рядов по заранее вычисленным значениям полиномов "poly".
+	// Коэффициенты компоненты i: coeffArray[i * cpec ... i * cpec + cpec - 1].
+	// Результат: componentsCount значений.
+	static void sumPosition(const double* poly, const double* coeffArray,
+		uint32_t cpec, unsigned componentsCount, double* resultArray);
+
+	// Суммы рядов и их производных по значениям полиномов "poly" и их
+	// производных "dpoly". Производные умножаются на "derivativeUnits".
+	// Результат: componentsCount значений и componentsCount производных.
+	static void sumState(const double* poly, const double* dpoly,
+		const double* coeffArray, uint32_t cpec, unsigned componentsCount,
+			double derivativeUnits, double* resultArray);
+
+	// Значения полиномов "poly" с номерами [first : polynomsCount) для
+	// нормированного времени "normalizedTime". Значения с меньшими номерами
+	// (не менее двух: 1 и normalizedTime) должны быть уже вычислены.
+	static void fillPolynoms(double normalizedTime, uint32_t first,
+		uint32_t polynomsCount, double* poly);
+
+	// То же, что и fillPolynoms(...), но для производных полиномов "dpoly"
+	// (first - не менее двух: 0 и 1). Значения полиномов "poly" с номерами
+	// до polynomsCount - 1 должны быть вычислены.
+	static void fillDerivatives(double normalizedTime, uint32_t first,
+		uint32_t polynomsCount, const double* poly, double* dpoly);
+
+	// Интерполяция на пакет моментов времени: для момента e используются
+	// нормированное время normalizedTimes[e] и коэффициенты coeffArrays[e].
+	// Результат для момента e: resultArray[e * componentsCount ...].
+	static void positionChunk(unsigned instructionSet, const double* normalizedTimes,
+		const double* const* coeffArrays, size_t count, uint32_t cpec,
+			unsigned componentsCount, double* resultArray);
+
+	// То же, что и positionChunk(...), но со значениями производных.
+	// Результат для момента e: resultArray[e * componentsCount * 2 ...].
+	static void stateChunk(unsigned instructionSet, const double* normalizedTimes,
+		const double* const* coeffArrays, size_t count, uint32_t cpec,
+			unsigned componentsCount, double derivativeUnits, double* resultArray);
+
+	// Шаблонное ядро вычисления координат элемента на нормированное время
+	// "normalizedTime". Если "isPolyReady" - значения полиномов берутся из
+	// массива "poly", иначе - вычисляются и записываются в него. Коэффициенты
+	// и результат - как в sumPosition(...).
+	typedef void (*PositionKernel)(double normalizedTime, bool isPolyReady,
+		double* poly, const double* coeffArray, double* resultArray);
+
+	// То же, что и PositionKernel, но со значениями производных полиномов
+	// "dpoly" (см. sumState(...)).
+	typedef void (*StateKernel)(double normalizedTime, bool isPolyReady,
+		double* poly, double* dpoly, const double* coeffArray, double derivativeUnits,
+			double* resultArray);
+
+	// Границы количества коэффициентов на компоненту для шаблонных ядер.
+	static const uint32_t FIXED_CPEC_MIN = 3;
+	static const uint32_t FIXED_CPEC_MAX = 18;
+
+	// Шаблонное ядро для "cpec" коэффициентов и "componentsCount" компонент
+	// (версия для набора инструкций не выше "instructionSet") или NULL, если
+	// такого ядра нет.
+	static PositionKernel positionKernel(unsigned instructionSet, uint32_t cpec,
+		unsigned componentsCount);
+	static StateKernel stateKernel(unsigned instructionSet, uint32_t cpec,
+		unsigned componentsCount);
+
+private:
+
+	Chebyshev(); // Запрет на создание объекта типа Chebyshev.
+
+// ............................ Шаблонные ядра .............................. //
+
+	// Значения полиномов "p" (и их производных "dp") для шаблонных ядер.
+	template <uint32_t CPEC>
+	static void fixedPolynoms(double normalizedTime, double* p);
+
+	template <uint32_t CPEC>
+	static void fixedDerivatives(double normalizedTime, double* p, double* dp);
+
+	template <uint32_t CPEC, unsigned COMPONENTS>
+	static void sumPositionFixed(const double* poly, const double* coeffArray,
+		double* resultArray);
+
+	template <uint32_t CPEC, unsigned COMPONENTS>
+	static void sumStateFixed(const double* poly, const double* dpoly,
+		const double* coeffArray, double derivativeUnits, double* resultArray);
+
+	template <uint32_t CPEC, unsigned COMPONENTS>
+	static void positionFixed(double normalizedTime, bool isPolyReady, double* poly,
+		const double* coeffArray, double* resultArray);
+
+	template <uint32_t CPEC, unsigned COMPONENTS>
+	static void stateFixed(double normalizedTime, bool isPolyReady, double* poly,
+		double* dpoly, const double* coeffArray, double derivativeUnits,
+			double* resultArray);
+
+	// Выбор шаблонного ядра по количеству коэффициентов (перебор от CPEC до
+	// FIXED_CPEC_MIN).
+	template <uint32_t CPEC>
+	class FixedKernels
+	{
+	public:
+		static PositionKernel position(unsigned instructionSet, uint32_t cpec,
+			unsigned componentsCount);
+		static StateKernel state(unsigned instructionSet, uint32_t cpec,
+			unsigned componentsCount);
+	};
+
+// ........................... Скалярные версии ............................. //
+
+	static void positionChunk_scalar(const double* normalizedTimes,
+		const double* const* coeffArrays, size_t count, uint32_t cpec,
+			unsigned componentsCount, double* resultArray);
+
+	static void stateChunk_scalar(const double* normalizedTimes,
+		const double* const* coeffArrays, size_t count, uint32_t cpec,
+			unsigned componentsCount, double derivativeUnits, double* resultArray);
+
+#ifdef DEPHEM_SIMD_X86
+
+// ............................ Векторные версии ............................ //
+
+	DEPHEM_TARGET("sse2")
+	static void positionChunk_sse2(const double* normalizedTimes,
+		const double* const* coeffArrays, size_t count, uint32_t cpec,
+			unsigned componentsCount, double* resultArray);
+
+	DEPHEM_TARGET("sse2")
+	static void stateChunk_sse2(const double* normalizedTimes,
+		const double* const* coeffArrays, size_t count, uint32_t cpec,
+			unsigned componentsCount, double derivativeUnits, double* resultArray);
+
+	DEPHEM_TARGET("avx2")
+	static void positionChunk_avx2(const double* normalizedTimes,
+		const double* const* coeffArrays, size_t count, uint32_t cpec,
+			unsigned componentsCount, double* resultArray);
+
+	DEPHEM_TARGET("avx2")
+	static void stateChunk_avx2(const double* normalizedTimes,
+		const double* const* coeffArrays, size_t count, uint32_t cpec,
+			unsigned componentsCount, double derivativeUnits, double* resultArray);
+
+	DEPHEM_TARGET("avx512f")
+	static void positionChunk_avx512(const double* normalizedTimes,
+		const double* const* coeffArrays, size_t count, uint32_t cpec,
+			unsigned componentsCount, double* resultArray);
+
+	DEPHEM_TARGET("avx512f")
+	static void stateChunk_avx512(const double* normalizedTimes,
+		const double* const* coeffArrays, size_t count, uint32_t cpec,
+			unsigned componentsCount, double derivativeUnits, double* resultArray);
+
+	// Шаблонные ядра с векторизацией по компонентам: SSE2 - для двух и трёх
+	// компонент, AVX2 - для трёх.
+	template <uint32_t CPEC, unsigned COMPONENTS>
+	DEPHEM_TARGET("sse2")
+	static void sumPositionFixed_sse2(const double* poly, const double* coeffArray,
+		double* resultArray);
+
+	template <uint32_t CPEC, unsigned COMPONENTS>
+	DEPHEM_TARGET("sse2")
+	static void sumStateFixed_sse2(const double* poly, const double* dpoly,
+		const double* coeffArray, double derivativeUnits, double* resultArray);
+
+	template <uint32_t CPEC, unsigned COMPONENTS>
+	DEPHEM_TARGET("sse2")
+	static void positionFixed_sse2(double normalizedTime, bool isPolyReady,
+		double* poly, const double* coeffArray, double* resultArray);
+
+	template <uint32_t CPEC, unsigned COMPONENTS>
+	DEPHEM_TARGET("sse2")
+	static void stateFixed_sse2(double normalizedTime, bool isPolyReady, double* poly,
+		double* dpoly, const double* coeffArray, double derivativeUnits,
+			double* resultArray);
+
+	template <uint32_t CPEC>
+	DEPHEM_TARGET("avx2")
+	static void sumPositionFixed_avx2(const double* poly, const double* coeffArray,
+		double* resultArray);
+
+	template <uint32_t CPEC>
+	DEPHEM_TARGET("avx2")
+	static void sumStateFixed_avx2(const double* poly, const double* dpoly,
+		const double* coeffArray, double derivativeUnits, double* resultArray);
+
+	template <uint32_t CPEC>
+	DEPHEM_TARGET("avx2")
+	static void positionFixed_avx2(double normalizedTime, bool isPolyReady,
+		double* poly, const double* coeffArray, double* resultArray);
+
+	template <uint32_t CPEC>
+	DEPHEM_TARGET("avx2")
+	static void stateFixed_avx2(double normalizedTime, bool isPolyReady, double* poly,
+		double* dpoly, const double* coeffArray, double derivativeUnits,
+			double* resultArray);
+
+#endif // DEPHEM_SIMD_X86
+};
+
+// Окончание перебора шаблонных ядер.
+template <>
+class Chebyshev::FixedKernels<Chebyshev::FIXED_CPEC_MIN - 1>
+{
+public:
+	static Chebyshev::PositionKernel position(unsigned, uint32_t, unsigned)
+	{
+		return NULL;
+	}
+
+	static Chebyshev::StateKernel state(unsigned, uint32_t, unsigned)
+	{
+		return NULL;
+	}
+};
+
+} // namespace dph
+
+// Слияние умножения и сложения (FMA) изменяет округление, поэтому в ядрах и в
+// рекуррентных формулах полиномов оно запрещено (GCC и Clang разрешают его по
+// умолчанию, если набор инструкций его поддерживает, например, с -mfma или
+// -march=haswell). Clang до 11 версии и MSVC не позволяют сохранить и
+// восстановить этот режим, поэтому после ядер слияние остаётся запрещённым
+// (для MSVC это режим по умолчанию при /fp:precise начиная с Visual Studio
+// 2022).
+#if defined(__clang__) && ((defined(__apple_build_version__) && \
+	__clang_major__ >= 13) || (!defined(__apple_build_version__) && __clang_major__ >= 11))
+#define DEPHEM_CLANG_FLOAT_CONTROL
+#endif
+
+#if defined(DEPHEM_CLANG_FLOAT_CONTROL)
+#pragma float_control(push)
+#pragma clang fp contract(off)
+#elif defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract(off)
+#endif
+
+unsigned dph::Chebyshev::detectInstructionSet()
+{
+#if defined(DEPHEM_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx512f"))	return InstructionSet::AVX512;
+	if (__builtin_cpu_supports("avx2"))		return InstructionSet::AVX2;
+	if (__builtin_cpu_supports("sse2"))		return InstructionSet::SSE2;
+
+	return InstructionSet::SCALAR;
+#elif defined(DEPHEM_SIMD_X86)
+	int info[4];
+
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	bool sse2 = (info[3] & (1 << 26)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+
+	// Состояние регистров YMM (и ZMM) должно сохраняться ОС:
+	unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+	bool osAvx = (xcr0 & 0x6) == 0x6;
+	bool osAvx512 = (xcr0 & 0xE6) == 0xE6;
+
+	bool avx2 = false;
+	bool avx512f = false;
+
+	if (maxLeaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+		avx512f = (info[1] & (1 << 16)) != 0;
+	}
+
+	if (avx512f && osAvx512)	return InstructionSet::AVX512;
+	if (avx2 && osAvx)			return InstructionSet::AVX2;
+	if (sse2)					return InstructionSet::SSE2;
+
+	return InstructionSet::SCALAR;
+#else
+	return InstructionSet::SCALAR;
+#endif
+}
+
+unsigned dph::Chebyshev::selectInstructionSet(unsigned requested)
+{
+	unsigned detected = detectInstructionSet();
+
+	return requested < detected ? requested : detected;
+}
+
+dph::Chebyshev::PositionKernel dph::Chebyshev::positionKernel(unsigned instructionSet,
+	uint32_t cpec, unsigned componentsCount)
+{
+	return FixedKernels<FIXED_CPEC_MAX>::position(instructionSet, cpec, componentsCount);
+}
+
+dph::Chebyshev::StateKernel dph::Chebyshev::stateKernel(unsigned instructionSet,
+	uint32_t cpec, unsigned componentsCount)
+{
+	return FixedKernels<FIXED_CPEC_MAX>::state(instructionSet, cpec, componentsCount);
+}
+
+template <uint32_t CPEC>
+dph::Chebyshev::PositionKernel dph::Chebyshev::FixedKernels<CPEC>::position(
+	unsigned instructionSet, uint32_t cpec, unsigned componentsCount)
+{
+	if (cpec != CPEC)
+	{
+		return FixedKernels<CPEC - 1>::position(instructionSet, cpec, componentsCount);
+	}
+
+#ifdef DEPHEM_SIMD_X86
+	if (componentsCount == 3 && instructionSet >= InstructionSet::AVX2)
+	{
+		return &positionFixed_avx2<CPEC>;
+	}
+	else if (componentsCount == 3 && instructionSet >= InstructionSet::SSE2)
+	{
+		return &positionFixed_sse2<CPEC, 3>;
+	}
+	else if (componentsCount == 2 && instructionSet >= InstructionSet::SSE2)
+	{
+		return &positionFixed_sse2<CPEC, 2>;
+	}
+#else
+	(void)instructionSet;
+#endif
+
+	switch (componentsCount)
+	{
+	case 1: return &positionFixed<CPEC, 1>;
+	case 2: return &positionFixed<CPEC, 2>;
+	case 3: return &positionFixed<CPEC, 3>;
+	default: return NULL;
+	}
+}
+
+template <uint32_t CPEC>
+dph::Chebyshev::StateKernel dph::Chebyshev::FixedKernels<CPEC>::state(
+	unsigned instructionSet, uint32_t cpec, unsigned componentsCount)
+{
+	if (cpec != CPEC)
+	{
+		return FixedKernels<CPEC - 1>::state(instructionSet, cpec, componentsCount);
+	}
+
+#ifdef DEPHEM_SIMD_X86
+	if (componentsCount == 3 && instructionSet >= InstructionSet::AVX2)
+	{
+		return &stateFixed_avx2<CPEC>;
+	}
+	else if (componentsCount == 3 && instructionSet >= InstructionSet::SSE2)
+	{
+		return &stateFixed_sse2<CPEC, 3>;
+	}
+	else if (componentsCount == 2 && instructionSet >= InstructionSet::SSE2)
+	{
+		return &stateFixed_sse2<CPEC, 2>;
+	}
+#else
+	(void)instructionSet;
+#endif
+
+	switch (componentsCount)
+	{
+	case 1: return &stateFixed<CPEC, 1>;
+	case 2: return &stateFixed<CPEC, 2>;
+	case 3: return &stateFixed<CPEC, 3>;
+	default: return NULL;
+	}
+}
+
+template <uint32_t CPEC>
+void dph::Chebyshev::fixedPolynoms(double normalizedTime, double* p)
+{
+	// См. fillPolynoms(...).
+	p[0] = 1;
+	p[1] = normalizedTime;
+
+	for (uint32_t i = 2; i < CPEC; ++i)
+	{
+		p[i] = 2 * normalizedTime * p[i - 1] - p[i - 2];
+	}
+}
+
+template <uint32_t CPEC>
+void dph::Chebyshev::fixedDerivatives(double normalizedTime, double* p, double* dp)
+{
+	// См. fillPolynoms(...) и fillDerivatives(...).
+	 p[0] = 1;
+	 p[1] = normalizedTime;
+	 p[2] = 2 * normalizedTime * normalizedTime - 1;
+	dp[0] = 0;
+	dp[1] = 1;
+	dp[2] = 4 * normalizedTime;
+
+	for (uint32_t i = 3; i < CPEC; ++i)
+	{
+		 p[i] = 2 * normalizedTime *  p[i - 1] -  p[i - 2];
+		dp[i] = 2 * p[i - 1] + 2 * normalizedTime * dp[i - 1] - dp[i - 2];
+	}
+}
+
+template <uint32_t CPEC, unsigned COMPONENTS>
+void dph::Chebyshev::sumPositionFixed(const double* poly, const double* coeffArray,
+	double* resultArray)
+{
+	// См. sumPosition(...).
+	for (unsigned i = 0; i < COMPONENTS; ++i)
+	{
+		double sum = 0;
+
+		for (uint32_t j = 0; j < CPEC; ++j)
+		{
+			sum += poly[j] * coeffArray[i * CPEC + j];
+		}
+
+		resultArray[i] = sum;
+	}
+}
+
+template <uint32_t CPEC, unsigned COMPONENTS>
+void dph::Chebyshev::sumStateFixed(const double* poly, const double* dpoly,
+	const double* coeffArray, double derivativeUnits, double* resultArray)
+{
+	// См. sumState(...).
+	for (unsigned i = 0; i < COMPONENTS; ++i)
+	{
+		double sum = 0;
+		double dsum = 0;
+
+		for (uint32_t j = 0; j < CPEC; ++j)
+		{
+			sum  +=  poly[j] * coeffArray[i * CPEC + j];
+			dsum += dpoly[j] * coeffArray[i * CPEC + j];
+		}
+
+		resultArray[i] = sum;
+		resultArray[i + COMPONENTS] = dsum * derivativeUnits;
+	}
+}
+
+template <uint32_t CPEC, unsigned COMPONENTS>
+void dph::Chebyshev::positionFixed(double normalizedTime, bool isPolyReady, double* poly,
+	const double* coeffArray, double* resultArray)
+{
+	if (isPolyReady)
+	{
+		sumPositionFixed<CPEC, COMPONENTS>(poly, coeffArray, resultArray);
+
+		return;
+	}
+
+	// Значения полиномов. Суммы вычисляются по локальной копии, чтобы
+	// значения оставались в регистрах:
+	double p[CPEC];
+
+	fixedPolynoms<CPEC>(normalizedTime, p);
+
+	sumPositionFixed<CPEC, COMPONENTS>(p, coeffArray, resultArray);
+
+	for (uint32_t i = 0; i < CPEC; ++i)
+	{
+		poly[i] = p[i];
+	}
+}
+
+template <uint32_t CPEC, unsigned COMPONENTS>
+void dph::Chebyshev::stateFixed(double normalizedTime, bool isPolyReady, double* poly,
+	double* dpoly, const double* coeffArray, double derivativeUnits, double* resultArray)
+{
+	if (isPolyReady)
+	{
+		sumStateFixed<CPEC, COMPONENTS>(poly, dpoly, coeffArray, derivativeUnits,
+			resultArray);
+
+		return;
+	}
+
+	// Значения полиномов и их производных:
+	double p[CPEC];
+	double dp[CPEC];
+
+	fixedDerivatives<CPEC>(normalizedTime, p, dp);
+
+	sumStateFixed<CPEC, COMPONENTS>(p, dp, coeffArray, derivativeUnits, resultArray);
+
+	for (uint32_t i = 0; i < CPEC; ++i)
+	{
+		 poly[i] =  p[i];
+		dpoly[i] = dp[i];
+	}
+}
+
+void dph::Chebyshev::positionChunk(unsigned instructionSet, const double* normalizedTimes,
+	const double* const* coeffArrays, size_t count, uint32_t cpec,
+		unsigned componentsCount, double* resultArray)
+{
+	switch (instructionSet)
+	{
+#ifdef DEPHEM_SIMD_X86
+	case InstructionSet::AVX512:
+		positionChunk_avx512(normalizedTimes, coeffArrays, count, cpec, componentsCount,
+			resultArray);
+		break;
+
+	case InstructionSet::AVX2:
+		positionChunk_avx2(normalizedTimes, coeffArrays, count, cpec, componentsCount,
+			resultArray);
+		break;
+
+	case InstructionSet::SSE2:
+		positionChunk_sse2(normalizedTimes, coeffArrays, count, cpec, componentsCount,
+			resultArray);
+		break;
+#endif
+	default:
+		positionChunk_scalar(normalizedTimes, coeffArrays, count, cpec, componentsCount,
+			resultArray);
+	}
+}
+
+void dph::Chebyshev::stateChunk(unsigned instructionSet, const double* normalizedTimes,
+	const double* const* coeffArrays, size_t count, uint32_t cpec,
+		unsigned componentsCount, double derivativeUnits, double* resultArray)
+{
+	switch (instructionSet)
+	{
+#ifdef DEPHEM_SIMD_X86
+	case InstructionSet::AVX512:
+		stateChunk_avx512(normalizedTimes, coeffArrays, count, cpec, componentsCount,
+			derivativeUnits, resultArray);
+		break;
+
+	case InstructionSet::AVX2:
+		stateChunk_avx2(normalizedTimes, coeffArrays, count, cpec, componentsCount,
+			derivativeUnits, resultArray);
+		break;
+
+	case InstructionSet::SSE2:
+		stateChunk_sse2(normalizedTimes, coeffArrays, count, cpec, componentsCount,
+			derivativeUnits, resultArray);
+		break;
+#endif
+	default:
+		stateChunk_scalar(normalizedTimes, coeffArrays, count, cpec, componentsCount,
+			derivativeUnits, resultArray);
+	}
+}
+
+void dph::Chebyshev::fillPolynoms(double normalizedTime, uint32_t first,
+	uint32_t polynomsCount, double* poly)
+{
+	for (uint32_t i = first; i < polynomsCount; ++i)
+	{
+		poly[i] = 2 * normalizedTime * poly[i - 1] - poly[i - 2];
+	}
+}
+
+void dph::Chebyshev::fillDerivatives(double normalizedTime, uint32_t first,
+	uint32_t polynomsCount, const double* poly, double* dpoly)
+{
+	for (uint32_t i = first; i < polynomsCount; ++i)
+	{
+		dpoly[i] = i == 2 ? 4 * normalizedTime :
+			2 * poly[i - 1] + 2 * normalizedTime * dpoly[i - 1] - dpoly[i - 2];
+	}
+}
+
+void dph::Chebyshev::sumPosition(const double* poly, const double* coeffArray,
+	uint32_t cpec, unsigned componentsCount, double* resultArray)
+{
+	for (unsigned i = 0; i < componentsCount; ++i)
+	{
+		resultArray[i] = 0;
+
+		for (uint32_t j = 0; j < cpec; ++j)
+		{
+			resultArray[i] += poly[j] * coeffArray[i * cpec + j];
+		}
+	}
+}
+
+void dph::Chebyshev::sumState(const double* poly, const double* dpoly,
+	const double* coeffArray, uint32_t cpec, unsigned componentsCount,
+		double derivativeUnits, double* resultArray)
+{
+	for (unsigned i = 0; i < componentsCount; ++i)
+	{
+		resultArray[i] = 0;
+		resultArray[i + componentsCount] = 0;
+
+		for (uint32_t j = 0; j < cpec; ++j, ++coeffArray)
+		{
+			resultArray[i]                   +=  poly[j] * *coeffArray;
+			resultArray[i + componentsCount] += dpoly[j] * *coeffArray;
+		}
+
+		resultArray[i + componentsCount] *= derivativeUnits;
+	}
+}
+
+void dph::Chebyshev::positionChunk_scalar(const double* normalizedTimes,
+	const double* const* coeffArrays, size_t count, uint32_t cpec,
+		unsigned componentsCount, double* resultArray)
+{
+	// Цикл по моментам времени - внутренний: для каждого момента хранятся
+	// два последних значения полиномов.
+	const size_t CHUNK_MAX = 64;
+
+	for (size_t first = 0; first < count; first += CHUNK_MAX)
+	{
+		size_t n = count - first < CHUNK_MAX ? count - first : CHUNK_MAX;
+
+		const double* times = normalizedTimes + first;
+		const double* const* coeffs = coeffArrays + first;
+		double* result = resultArray + first * componentsCount;
+
+		double poly[CHUNK_MAX];
+		double prevPoly[CHUNK_MAX];
+
+		for (size_t e = 0; e < n; ++e)
+		{
+			prevPoly[e] = 0;
+				poly[e] = 1;
+
+			for (unsigned i = 0; i < componentsCount; ++i)
+			{
+				result[e * componentsCount + i] = 0;
+			}
+		}
+
+		for (uint32_t j = 0; j < cpec; ++j)
+		{
+			// Переход к полиному j-й степени:
+			if (j == 1)
+			{
+				for (size_t e = 0; e < n; ++e)
+				{
+					prevPoly[e] = poly[e];
+						poly[e] = times[e];
+				}
+			}
+			else if (j > 1)
+			{
+				for (size_t e = 0; e < n; ++e)
+				{
+					double nextPoly = 2 * times[e] * poly[e] - prevPoly[e];
+
+					prevPoly[e] = poly[e];
+						poly[e] = nextPoly;
+				}
+			}
+
+			// Накопление сумм:
+			for (size_t e = 0; e < n; ++e)
+			{
+				for (unsigned i = 0; i < componentsCount; ++i)
+				{
+					result[e * componentsCount + i] += poly[e] * coeffs[e][i * cpec + j];
+				}
+			}
+		}
+	}
+}
+
+void dph::Chebyshev::stateChunk_scalar(const double* normalizedTimes,
+	const double* const* coeffArrays, size_t count, uint32_t cpec,
+		unsigned componentsCount, double derivativeUnits, double* resultArray)
+{
+	// См. positionChunk_scalar(...).
+	const size_t CHUNK_MAX = 64;
+
+	// Количество значений результата для одного момента времени:
+	unsigned valuesCount = componentsCount * 2;
+
+	for (size_t first = 0; first < count; first += CHUNK_MAX)
+	{
+		size_t n = count - first < CHUNK_MAX ? count - first : CHUNK_MAX;
+
+		const double* times = normalizedTimes + first;
+		const double* const* coeffs = coeffArrays + first;
+		double* result = resultArray + first * valuesCount;
+
+		double poly[CHUNK_MAX];
+		double prevPoly[CHUNK_MAX];
+		double dpoly[CHUNK_MAX];
+		double prevDpoly[CHUNK_MAX];
+
+		for (size_t e = 0; e < n; ++e)
+		{
+			prevPoly[e] = 0;
+				poly[e] = 1;
+			prevDpoly[e] = 0;
+				dpoly[e] = 0;
+
+			for (unsigned i = 0; i < valuesCount; ++i)
+			{
+				result[e * valuesCount + i] = 0;
+			}
+		}
+
+		for (uint32_t j = 0; j < cpec; ++j)
+		{
+			// Переход к полиному j-й степени:
+			if (j == 1)
+			{
+				for (size_t e = 0; e < n; ++e)
+				{
+					prevPoly[e] = poly[e];
+						poly[e] = times[e];
+					prevDpoly[e] = dpoly[e];
+						dpoly[e] = 1;
+				}
+			}
+			else if (j == 2)
+			{
+				for (size_t e = 0; e < n; ++e)
+				{
+					prevPoly[e] = poly[e];
+						poly[e] = 2 * times[e] * times[e] - 1;
+					prevDpoly[e] = dpoly[e];
+						dpoly[e] = 4 * times[e];
+				}
+			}
+			else if (j > 2)
+			{
+				for (size_t e = 0; e < n; ++e)
+				{
+					double nextPoly  = 2 * times[e] * poly[e] - prevPoly[e];
+					double nextDpoly = 2 * poly[e] + 2 * times[e] * dpoly[e] - prevDpoly[e];
+
+					prevPoly[e] = poly[e];
+						poly[e] = nextPoly;
+					prevDpoly[e] = dpoly[e];
+						dpoly[e] = nextDpoly;
+				}
+			}
+
+			// Накопление сумм:
+			for (size_t e = 0; e < n; ++e)
+			{
+				double* values = result + e * valuesCount;
+
+				for (unsigned i = 0; i < componentsCount; ++i)
+				{
+					double coeff = coeffs[e][i * cpec + j];
+
+					values[i]                   +=  poly[e] * coeff;
+					values[i + componentsCount] += dpoly[e] * coeff;
+				}
+			}
+		}
+
+		for (size_t e = 0; e < n; ++e)
+		{
+			for (unsigned i = 0; i < componentsCount; ++i)
+			{
+				result[e * valuesCount + componentsCount + i] *= derivativeUnits;
+			}
+		}
+	}
+}
+
+#ifdef DEPHEM_SIMD_X86
+
+// Примечание к векторным версиям.
+// Выражения полиномов записаны в том же порядке операций, что и в скалярных
+// версиях: (2 * t) * T[j - 1] - T[j - 2] и т.д.
+//
+// Каждый элемент регистра соответствует своему моменту времени. Неполный
+// последний пакет дополняется копиями последнего момента, результаты для
+// дополнения отбрасываются.
+
+void dph::Chebyshev::positionChunk_sse2(const double* normalizedTimes,
+	const double* const* coeffArrays, size_t count, uint32_t cpec,
+		unsigned componentsCount, double* resultArray)
+{
+	const size_t LANES = 2;
+
+	for (size_t first = 0; first < count; first += LANES)
+	{
+		// Индексы моментов времени в элементах регистра:
+		size_t e0 = first;
+		size_t e1 = first + 1 < count ? first + 1 : e0;
+
+		const __m128d two = _mm_set1_pd(2.0);
+		__m128d t = _mm_set_pd(normalizedTimes[e1], normalizedTimes[e0]);
+		__m128d twoT = _mm_mul_pd(two, t);
+
+		__m128d prevPoly = _mm_setzero_pd();
+		__m128d poly = _mm_set1_pd(1.0);
+
+		__m128d sums[3] = { _mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd() };
+
+		for (uint32_t j = 0; j < cpec; ++j)
+		{
+			if (j == 1)
+			{
+				prevPoly = poly;
+				poly = t;
+			}
+			else if (j > 1)
+			{
+				__m128d nextPoly = _mm_sub_pd(_mm_mul_pd(twoT, poly), prevPoly);
+				prevPoly = poly;
+				poly = nextPoly;
+			}
+
+			for (unsigned i = 0; i < componentsCount; ++i)
+			{
+				size_t k = i * cpec + j;
+				__m128d c = _mm_set_pd(coeffArrays[e1][k], coeffArrays[e0][k]);
+
+				sums[i] = _mm_add_pd(sums[i], _mm_mul_pd(poly, c));
+			}
+		}
+
+		size_t lanesUsed = count - first < LANES ? count - first : LANES;
+
+		for (unsigned i = 0; i < componentsCount; ++i)
+		{
+			double values[LANES];
+			_mm_storeu_pd(values, sums[i]);
+
+			for (size_t l = 0; l < lanesUsed; ++l)
+			{
+				resultArray[(first + l) * componentsCount + i] = values[l];
+			}
+		}
+	}
+}
+
+void dph::Chebyshev::stateChunk_sse2(const double* normalizedTimes,
+	const double* const* coeffArrays, size_t count, uint32_t cpec,
+		unsigned componentsCount, double derivativeUnits, double* resultArray)
+{
+	const size_t LANES = 2;
+	unsigned valuesCount = componentsCount * 2;
+
+	for (size_t first = 0; first < count; first += LANES)
+	{
+		size_t e0 = first;
+		size_t e1 = first + 1 < count ? first + 1 : e0;
+
+		const __m128d two = _mm_set1_pd(2.0);
+		__m128d t = _mm_set_pd(normalizedTimes[e1], normalizedTimes[e0]);
+		__m128d twoT = _mm_mul_pd(two, t);
+
+		__m128d prevPoly = _mm_setzero_pd();
+		__m128d poly = _mm_set1_pd(1.0);
+		__m128d prevDpoly = _mm_setzero_pd();
+		__m128d dpoly = _mm_setzero_pd();
+
+		__m128d sums[3] = { _mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd() };
+		__m128d dsums[3] = { _mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd() };
+
+		for (uint32_t j = 0; j < cpec; ++j)
+		{
+			if (j == 1)
+			{
+				prevPoly = poly;
+				poly = t;
+				prevDpoly = dpoly;
+				dpoly = _mm_set1_pd(1.0);
+			}
+			else if (j == 2)
+			{
+				prevPoly = poly;
+				poly = _mm_sub_pd(_mm_mul_pd(twoT, t), _mm_set1_pd(1.0));
+				prevDpoly = dpoly;
+				dpoly = _mm_mul_pd(_mm_set1_pd(4.0), t);
+			}
+			else if (j > 2)
+			{
+				__m128d nextPoly = _mm_sub_pd(_mm_mul_pd(twoT, poly), prevPoly);
+				__m128d nextDpoly = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(two, poly),
+					_mm_mul_pd(twoT, dpoly)), prevDpoly);
+
+				prevPoly = poly;
+				poly = nextPoly;
+				prevDpoly = dpoly;
+				dpoly = nextDpoly;
+			}
+
+			for (unsigned i = 0; i < componentsCount; ++i)
+			{
+				size_t k = i * cpec + j;
+				__m128d c = _mm_set_pd(coeffArrays[e1][k], coeffArrays[e0][k]);
+
+				sums[i]  = _mm_add_pd(sums[i],  _mm_mul_pd(poly, c));
+				dsums[i] = _mm_add_pd(dsums[i], _mm_mul_pd(dpoly, c));
+			}
+		}
+
+		size_t lanesUsed = count - first < LANES ? count - first : LANES;
+		__m128d units = _mm_set1_pd(derivativeUnits);
+
+		for (unsigned i = 0; i < componentsCount; ++i)
+		{
+			double values[LANES];
+			double dvalues[LANES];
+			_mm_storeu_pd(values, sums[i]);
+			_mm_storeu_pd(dvalues, _mm_mul_pd(dsums[i], units));
+
+			for (size_t l = 0; l < lanesUsed; ++l)
+			{
+				resultArray[(first + l) * valuesCount + i] = values[l];
+				resultArray[(first + l) * valuesCount + componentsCount + i] = dvalues[l];
+			}
+		}
+	}
+}
+
+void dph::Chebyshev::positionChunk_avx2(const double* normalizedTimes,
+	const double* const* coeffArrays, size_t count, uint32_t cpec,
+		unsigned componentsCount, double* resultArray)
+{
+	const size_t LANES = 4;
+
+	for (size_t first = 0; first < count; first += LANES)
+	{
+		// Индексы моментов времени в элементах регистра:
+		size_t e[LANES];
+		for (size_t l = 0; l < LANES; ++l)
+		{
+			e[l] = first + l < count ? first + l : count - 1;
+		}
+
+		const __m256d two = _mm256_set1_pd(2.0);
+		__m256d t = _mm256_set_pd(normalizedTimes[e[3]], normalizedTimes[e[2]],
+			normalizedTimes[e[1]], normalizedTimes[e[0]]);
+		__m256d twoT = _mm256_mul_pd(two, t);
+
+		__m256d prevPoly = _mm256_setzero_pd();
+		__m256d poly = _mm256_set1_pd(1.0);
+
+		__m256d sums[3] = { _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd() };
+
+		for (uint32_t j = 0; j < cpec; ++j)
+		{
+			if (j == 1)
+			{
+				prevPoly = poly;
+				poly = t;
+			}
+			else if (j > 1)
+			{
+				__m256d nextPoly = _mm256_sub_pd(_mm256_mul_pd(twoT, poly), prevPoly);
+				prevPoly = poly;
+				poly = nextPoly;
+			}
+
+			for (unsigned i = 0; i < componentsCount; ++i)
+			{
+				size_t k = i * cpec + j;
+				__m256d c = _mm256_set_pd(coeffArrays[e[3]][k], coeffArrays[e[2]][k],
+					coeffArrays[e[1]][k], coeffArrays[e[0]][k]);
+
+				sums[i] = _mm256_add_pd(sums[i], _mm256_mul_pd(poly, c));
+			}
+		}
+
+		size_t lanesUsed = count - first < LANES ? count - first : LANES;
+
+		for (unsigned i = 0; i < componentsCount; ++i)
+		{
+			double values[LANES];
+			_mm256_storeu_pd(values, sums[i]);
+
+			for (size_t l = 0; l < lanesUsed; ++l)
+			{
+				resultArray[(first + l) * componentsCount + i] = values[l];
+			}
+		}
+	}
+}
+
+void dph::Chebyshev::stateChunk_avx2(const double* normalizedTimes,
+	const double* const* coeffArrays, size_t count, uint32_t cpec,
+		unsigned componentsCount, double derivativeUnits, double* resultArray)
+{
+	const size_t LANES = 4;
+	unsigned valuesCount = componentsCount * 2;
+
+	for (size_t first = 0; first < count; first += LANES)
+	{
+		size_t e[LANES];
+		for (size_t l = 0; l < LANES; ++l)
+		{
+			e[l] = first + l < count ? first + l : count - 1;
+		}
+
+		const __m256d two = _mm256_set1_pd(2.0);
+		__m256d t = _mm256_set_pd(normalizedTimes[e[3]], normalizedTimes[e[2]],
+			normalizedTimes[e[1]], normalizedTimes[e[0]]);
+		__m256d twoT = _mm256_mul_pd(two, t);
+
+		__m256d prevPoly = _mm256_setzero_pd();
+		__m256d poly = _mm256_set1_pd(1.0);
+		__m256d prevDpoly = _mm256_setzero_pd();
+		__m256d dpoly = _mm256_setzero_pd();
+
+		__m256d sums[3] = { _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd() };
+		__m256d dsums[3] = { _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd() };
+
+		for (uint32_t j = 0; j < cpec; ++j)
+		{
+			if (j == 1)
+			{
+				prevPoly = poly;
+				poly = t;
+				prevDpoly = dpoly;
+				dpoly = _mm256_set1_pd(1.0);
+			}
+			else if (j == 2)
+			{
+				prevPoly = poly;
+				poly = _mm256_sub_pd(_mm256_mul_pd(twoT, t), _mm256_set1_pd(1.0));
+				prevDpoly = dpoly;
+				dpoly = _mm256_mul_pd(_mm256_set1_pd(4.0), t);
+			}
+			else if (j > 2)
+			{
+				__m256d nextPoly = _mm256_sub_pd(_mm256_mul_pd(twoT, poly), prevPoly);
+				__m256d nextDpoly = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(two, poly),
+					_mm256_mul_pd(twoT, dpoly)), prevDpoly);
+
+				prevPoly = poly;
+				poly = nextPoly;
+				prevDpoly = dpoly;
+				dpoly = nextDpoly;
+			}
+
+			for (unsigned i = 0; i < componentsCount; ++i)
+			{
+				size_t k = i * cpec + j;
+				__m256d c = _mm256_set_pd(coeffArrays[e[3]][k], coeffArrays[e[2]][k],
+					coeffArrays[e[1]][k], coeffArrays[e[0]][k]);
+
+				sums[i]  = _mm256_add_pd(sums[i],  _mm256_mul_pd(poly, c));
+				dsums[i] = _mm256_add_pd(dsums[i], _mm256_mul_pd(dpoly, c));
+			}
+		}
+
+		size_t lanesUsed = count - first < LANES ? count - first : LANES;
+		__m256d units = _mm256_set1_pd(derivativeUnits);
+
+		for (unsigned i = 0; i < componentsCount; ++i)
+		{
+			double values[LANES];
+			double dvalues[LANES];
+			_mm256_storeu_pd(values, sums[i]);
+			_mm256_storeu_pd(dvalues, _mm256_mul_pd(dsums[i], units));
+
+			for (size_t l = 0; l < lanesUsed; ++l)
+			{
+				resultArray[(first + l) * valuesCount + i] = values[l];
+				resultArray[(first + l) * valuesCount + componentsCount + i] = dvalues[l];
+			}
+		}
+	}
+}
+
+void dph::Chebyshev::positionChunk_avx512(const double* normalizedTimes,
+	const double* const* coeffArrays, size_t count, uint32_t cpec,
+		unsigned componentsCount, double* resultArray)
+{
+	const size_t LANES = 8;
+
+	for (size_t first = 0; first < count; first += LANES)
+	{
+		// Индексы моментов времени в элементах регистра:
+		size_t e[LANES];
+		for (size_t l = 0; l < LANES; ++l)
+		{
+			e[l] = first + l < count ? first + l : count - 1;
+		}
+
+		const __m512d two = _mm512_set1_pd(2.0);
+		__m512d t = _mm512_set_pd(normalizedTimes[e[7]], normalizedTimes[e[6]],
+			normalizedTimes[e[5]], normalizedTimes[e[4]], normalizedTimes[e[3]],
+			normalizedTimes[e[2]], normalizedTimes[e[1]], normalizedTimes[e[0]]);
+		__m512d twoT = _mm512_mul_pd(two, t);
+
+		__m512d prevPoly = _mm512_setzero_pd();
+		__m512d poly = _mm512_set1_pd(1.0);
+
+		__m512d sums[3] = { _mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd() };
+
+		for (uint32_t j = 0; j < cpec; ++j)
+		{
+			if (j == 1)
+			{
+				prevPoly = poly;
+				poly = t;
+			}
+			else if (j > 1)
+			{
+				__m512d nextPoly = _mm512_sub_pd(_mm512_mul_pd(twoT, poly), prevPoly);
+				prevPoly = poly;
+				poly = nextPoly;
+			}
+
+			for (unsigned i = 0; i < componentsCount; ++i)
+			{
+				size_t k = i * cpec + j;
+				__m512d c = _mm512_set_pd(coeffArrays[e[7]][k], coeffArrays[e[6]][k],
+					coeffArrays[e[5]][k], coeffArrays[e[4]][k], coeffArrays[e[3]][k],
+					coeffArrays[e[2]][k], coeffArrays[e[1]][k], coeffArrays[e[0]][k]);
+
+				sums[i] = _mm512_add_pd(sums[i], _mm512_mul_pd(poly, c));
+			}
+		}
+
+		size_t lanesUsed = count - first < LANES ? count - first : LANES;
+
+		for (unsigned i = 0; i < componentsCount; ++i)
+		{
+			double values[LANES];
+			_mm512_storeu_pd(values, sums[i]);
+
+			for (size_t l = 0; l < lanesUsed; ++l)
+			{
+				resultArray[(first + l) * componentsCount + i] = values[l];
+			}
+		}
+	}
+}
+
+void dph::Chebyshev::stateChunk_avx512(const double* normalizedTimes,
+	const double* const* coeffArrays, size_t count, uint32_t cpec,
+		unsigned componentsCount, double derivativeUnits, double* resultArray)
+{
+	const size_t LANES = 8;
+	unsigned valuesCount = componentsCount * 2;
+
+	for (size_t first = 0; first < count; first += LANES)
+	{
+		size_t e[LANES];
+		for (size_t l = 0; l < LANES; ++l)
+		{
+			e[l] = first + l < count ? first + l : count - 1;
+		}
+
+		const __m512d two = _mm512_set1_pd(2.0);
+		__m512d t = _mm512_set_pd(normalizedTimes[e[7]], normalizedTimes[e[6]],
+			normalizedTimes[e[5]], normalizedTimes[e[4]], normalizedTimes[e[3]],
+			normalizedTimes[e[2]], normalizedTimes[e[1]], normalizedTimes[e[0]]);
+		__m512d twoT = _mm512_mul_pd(two, t);
+
+		__m512d prevPoly = _mm512_setzero_pd();
+		__m512d poly = _mm512_set1_pd(1.0);
+		__m512d prevDpoly = _mm512_setzero_pd();
+		__m512d dpoly = _mm512_setzero_pd();
+
+		__m512d sums[3] = { _mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd() };
+		__m512d dsums[3] = { _mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd() };
+
+		for (uint32_t j = 0; j < cpec; ++j)
+		{
+			if (j == 1)
+			{
+				prevPoly = poly;
+				poly = t;
+				prevDpoly = dpoly;
+				dpoly = _mm512_set1_pd(1.0);
+			}
+			else if (j == 2)
+			{
+				prevPoly = poly;
+				poly = _mm512_sub_pd(_mm512_mul_pd(twoT, t), _mm512_set1_pd(1.0));
+				prevDpoly = dpoly;
+				dpoly = _mm512_mul_pd(_mm512_set1_pd(4.0), t);
+			}
+			else if (j > 2)
+			{
+				__m512d nextPoly = _mm512_sub_pd(_mm512_mul_pd(twoT, poly), prevPoly);
+				__m512d nextDpoly = _mm512_sub_pd(_mm512_add_pd(_mm512_mul_pd(two, poly),
+					_mm512_mul_pd(twoT, dpoly)), prevDpoly);
+
+				prevPoly = poly;
+				poly = nextPoly;
+				prevDpoly = dpoly;
+				dpoly = nextDpoly;
+			}
+
+			for (unsigned i = 0; i < componentsCount; ++i)
+			{
+				size_t k = i * cpec + j;
+				__m512d c = _mm512_set_pd(coeffArrays[e[7]][k], coeffArrays[e[6]][k],
+					coeffArrays[e[5]][k], coeffArrays[e[4]][k], coeffArrays[e[3]][k],
+					coeffArrays[e[2]][k], coeffArrays[e[1]][k], coeffArrays[e[0]][k]);
+
+				sums[i]  = _mm512_add_pd(sums[i],  _mm512_mul_pd(poly, c));
+				dsums[i] = _mm512_add_pd(dsums[i], _mm512_mul_pd(dpoly, c));
+			}
+		}
+
+		size_t lanesUsed = count - first < LANES ? count - first : LANES;
+		__m512d units = _mm512_set1_pd(derivativeUnits);
+
+		for (unsigned i = 0; i < componentsCount; ++i)
+		{
+			double values[LANES];
+			double dvalues[LANES];
+			_mm512_storeu_pd(values, sums[i]);
+			_mm512_storeu_pd(dvalues, _mm512_mul_pd(dsums[i], units));
+
+			for (size_t l = 0; l < lanesUsed; ++l)
+			{
+				resultArray[(first + l) * valuesCount + i] = values[l];
+				resultArray[(first + l) * valuesCount + componentsCount + i] = dvalues[l];
+			}
+		}
+	}
+}
+
+// Шаблонные ядра с векторизацией по компонентам.
+// Элементы регистров: SSE2 - [x, y] и [z, -] (младший элемент), AVX2 -
+// [x, y, z, -]. Суммы каждой компоненты накапливаются в том же порядке, что
+// и в скалярных ядрах.
+
+template <uint32_t CPEC, unsigned COMPONENTS>
+void dph::Chebyshev::sumPositionFixed_sse2(const double* poly, const double* coeffArray,
+	double* resultArray)
+{
+	__m128d sumXY = _mm_setzero_pd();
+	__m128d sumZ  = _mm_setzero_pd();
+
+	for (uint32_t j = 0; j < CPEC; ++j)
+	{
+		__m128d p = _mm_set1_pd(poly[j]);
+
+		sumXY = _mm_add_pd(sumXY, _mm_mul_pd(p,
+			_mm_set_pd(coeffArray[CPEC + j], coeffArray[j])));
+
+		if (COMPONENTS == 3)
+		{
+			sumZ = _mm_add_sd(sumZ, _mm_mul_sd(p, _mm_load_sd(coeffArray + 2 * CPEC + j)));
+		}
+	}
+
+	_mm_storeu_pd(resultArray, sumXY);
+
+	if (COMPONENTS == 3)
+	{
+		_mm_store_sd(resultArray + 2, sumZ);
+	}
+}
+
+template <uint32_t CPEC, unsigned COMPONENTS>
+void dph::Chebyshev::sumStateFixed_sse2(const double* poly, const double* dpoly,
+	const double* coeffArray, double derivativeUnits, double* resultArray)
+{
+	__m128d sumXY  = _mm_setzero_pd();
+	__m128d sumZ   = _mm_setzero_pd();
+	__m128d dsumXY = _mm_setzero_pd();
+	__m128d dsumZ  = _mm_setzero_pd();
+
+	for (uint32_t j = 0; j < CPEC; ++j)
+	{
+		__m128d p = _mm_set1_pd(poly[j]);
+		__m128d d = _mm_set1_pd(dpoly[j]);
+		__m128d cXY = _mm_set_pd(coeffArray[CPEC + j], coeffArray[j]);
+
+		sumXY  = _mm_add_pd(sumXY,  _mm_mul_pd(p, cXY));
+		dsumXY = _mm_add_pd(dsumXY, _mm_mul_pd(d, cXY));
+
+		if (COMPONENTS == 3)
+		{
+			__m128d cZ = _mm_load_sd(coeffArray + 2 * CPEC + j);
+
+			sumZ  = _mm_add_sd(sumZ,  _mm_mul_sd(p, cZ));
+			dsumZ = _mm_add_sd(dsumZ, _mm_mul_sd(d, cZ));
+		}
+	}
+
+	__m128d units = _mm_set1_pd(derivativeUnits);
+
+	_mm_storeu_pd(resultArray, sumXY);
+	_mm_storeu_pd(resultArray + COMPONENTS, _mm_mul_pd(dsumXY, units));
+
+	if (COMPONENTS == 3)
+	{
+		_mm_store_sd(resultArray + 2, sumZ);
+		_mm_store_sd(resultArray + 5, _mm_mul_sd(dsumZ, units));
+	}
+}
+
+template <uint32_t CPEC, unsigned COMPONENTS>
+void dph::Chebyshev::positionFixed_sse2(double normalizedTime, bool isPolyReady,
+	double* poly, const double* coeffArray, double* resultArray)
+{
+	// См. positionFixed(...).
+	if (isPolyReady)
+	{
+		sumPositionFixed_sse2<CPEC, COMPONENTS>(poly, coeffArray, resultArray);
+
+		return;
+	}
+
+	double p[CPEC];
+
+	fixedPolynoms<CPEC>(normalizedTime, p);
+
+	sumPositionFixed_sse2<CPEC, COMPONENTS>(p, coeffArray, resultArray);
+
+	for (uint32_t i = 0; i < CPEC; ++i)
+	{
+		poly[i] = p[i];
+	}
+}
+
+template <uint32_t CPEC, unsigned COMPONENTS>
+void dph::Chebyshev::stateFixed_sse2(double normalizedTime, bool isPolyReady,
+	double* poly, double* dpoly, const double* coeffArray, double derivativeUnits,
+		double* resultArray)
+{
+	// См. stateFixed(...).
+	if (isPolyReady)
+	{
+		sumStateFixed_sse2<CPEC, COMPONENTS>(poly, dpoly, coeffArray, derivativeUnits,
+			resultArray);
+
+		return;
+	}
+
+	double p[CPEC];
+	double dp[CPEC];
+
+	fixedDerivatives<CPEC>(normalizedTime, p, dp);
+
+	sumStateFixed_sse2<CPEC, COMPONENTS>(p, dp, coeffArray, derivativeUnits,
+		resultArray);
+
+	for (uint32_t i = 0; i < CPEC; ++i)
+	{
+		 poly[i] =  p[i];
+		dpoly[i] = dp[i];
+	}
+}
+
+template <uint32_t CPEC>
+void dph::Chebyshev::sumPositionFixed_avx2(const double* poly, const double* coeffArray,
+	double* resultArray)
+{
+	__m256d sum = _mm256_setzero_pd();
+
+	for (uint32_t j = 0; j < CPEC; ++j)
+	{
+		__m256d c = _mm256_set_pd(0.0, coeffArray[2 * CPEC + j], coeffArray[CPEC + j],
+			coeffArray[j]);
+
+		sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_set1_pd(poly[j]), c));
+	}
+
+	double values[4];
+	_mm256_storeu_pd(values, sum);
+
+	resultArray[0] = values[0];
+	resultArray[1] = values[1];
+	resultArray[2] = values[2];
+}
+
+template <uint32_t CPEC>
+void dph::Chebyshev::sumStateFixed_avx2(const double* poly, const double* dpoly,
+	const double* coeffArray, double derivativeUnits, double* resultArray)
+{
+	__m256d sum  = _mm256_setzero_pd();
+	__m256d dsum = _mm256_setzero_pd();
+
+	for (uint32_t j = 0; j < CPEC; ++j)
+	{
+		__m256d c = _mm256_set_pd(0.0, coeffArray[2 * CPEC + j], coeffArray[CPEC + j],
+			coeffArray[j]);
+
+		sum  = _mm256_add_pd(sum,  _mm256_mul_pd(_mm256_set1_pd( poly[j]), c));
+		dsum = _mm256_add_pd(dsum, _mm256_mul_pd(_mm256_set1_pd(dpoly[j]), c));
+	}
+
+	double values[8];
+	_mm256_storeu_pd(values, sum);
+	_mm256_storeu_pd(values + 4, _mm256_mul_pd(dsum, _mm256_set1_pd(derivativeUnits)));
+
+	resultArray[0] = values[0];
+	resultArray[1] = values[1];
+	resultArray[2] = values[2];
+	resultArray[3] = values[4];
+	resultArray[4] = values[5];
+	resultArray[5] = values[6];
+}
+
+template <uint32_t CPEC>
+void dph::Chebyshev::positionFixed_avx2(double normalizedTime, bool isPolyReady,
+	double* poly, const double* coeffArray, double* resultArray)
+{
+	// См. positionFixed(...).
+	if (isPolyReady)
+	{
+		sumPositionFixed_avx2<CPEC>(poly, coeffArray, resultArray);
+
+		return;
+	}
+
+	double p[CPEC];
+
+	fixedPolynoms<CPEC>(normalizedTime, p);
+
+	sumPositionFixed_avx2<CPEC>(p, coeffArray, resultArray);
+
+	for (uint32_t i = 0; i < CPEC; ++i)
+	{
+		poly[i] = p[i];
+	}
+}
+
+template <uint32_t CPEC>
+void dph::Chebyshev::stateFixed_avx2(double normalizedTime, bool isPolyReady,
+	double* poly, double* dpoly, const double* coeffArray, double derivativeUnits,
+		double* resultArray)
+{
+	// См. stateFixed(...).
+	if (isPolyReady)
+	{
+		sumStateFixed_avx2<CPEC>(poly, dpoly, coeffArray, derivativeUnits, resultArray);
+
+		return;
+	}
+
+	double p[CPEC];
+	double dp[CPEC];
+
+	fixedDerivatives<CPEC>(normalizedTime, p, dp);
+
+	sumStateFixed_avx2<CPEC>(p, dp, coeffArray, derivativeUnits, resultArray);
+
+	for (uint32_t i = 0; i < CPEC; ++i)
+	{
+		 poly[i] =  p[i];
+		dpoly[i] = dp[i];
+	}
+}
+
+#endif // DEPHEM_SIMD_X86
+
+#if defined(DEPHEM_CLANG_FLOAT_CONTROL)
+#pragma float_control(pop)
+#undef DEPHEM_CLANG_FLOAT_CONTROL
+#elif defined(__GNUC__) && !defined(__clang__)
+#pragma GCC pop_options
+#endif
+
+#endif // DEPHEM_CHEBYSHEV_HPP
@@ -7,12 +7,28 @@
 
 #include <fstream>
 #include <cstring>
+#include <cmath>
 #include <stdint.h>
 #include <string>
 #include <map>
 #include <vector>
-
-#include "help.hpp" // Body::..., Other::..., Calculate::...
+#include <utility>
+#include <algorithm>
+
+#include "help.hpp" // Body::..., Other::..., Calculate::..., Access::...
+#include "ReleaseCore.hpp"
+#include "PackedFormat.hpp"
+#include "CalculationContext.hpp"
+#include "Epoch.hpp"
+#include "Chebyshev.hpp"
+#include "Thread.hpp"
+#include "ThreadPool.hpp"
+#include "WorkQueue.hpp"
+
+// Семантика перемещения (C++11 и новее):
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
+#define DEPHEM_MOVE_SEMANTICS
+#endif
 
 namespace dph
 {	
@@ -32,6 +48,16 @@ namespace dph
 //     - Получение общей информации о выпуске эфемерид.                       //
 //     - Хранение и доступ к константам, хранящихся в выпуске эфемерид.       //
 //                                                                            //
+// Методы вычислений без параметра "context" используют внутренний контекст   //
+// объекта и не должны вызываться из нескольких потоков одновременно. Для     //
+// многопоточных вычислений используй перегрузки с dph::CalculationContext    //
+// (свой контекст для каждого потока).                                        //
+//                                                                            //
+// Копии объекта разделяют неизменяемые данные выпуска (отображение или       //
+// загруженный файл, константы, см. dph::ReleaseCore): копирование не         //
+// открывает и не проверяет файл заново. Каждая копия имеет собственный       //
+// внутренний контекст вычислений. При C++11 объект также перемещается.       //
+//                                                                            //
 // ************************************************************************** //
 class EphemerisRelease
 {
@@ -42,20 +68,37 @@ public:
 	// Конструктор по пути к бинарному файлу эфемерид.
 	// -----------------------------------------------
 	// Чтение файла, проверка полученных значений.
-	explicit EphemerisRelease(const std::string& binaryFilePath);
+	// Параметры открытия (способ доступа к файлу и т.д.) задаются через
+	// "options", см. dph::ReleaseOptions.
+	explicit EphemerisRelease(const std::string& binaryFilePath,
+		const ReleaseOptions& options = ReleaseOptions());
 
 	// Конструктор копирования.
 	// ------------------------
-	// Проверка полученных значений и доступ к файлу. 
-	// При неудачной проверке объект очищается.
+	// Копия разделяет с "other" данные выпуска (файл не открывается и не
+	// проверяется заново). Копия неготового объекта также является неготовой.
 	EphemerisRelease(const EphemerisRelease& other);
 
 	// Оператор копирования.
 	// ---------------------
-	// Проверка полученных значений и доступ к файлу.
-	// При неудачной проверке объект очищается.
+	// См. конструктор копирования. Если объект "other" не готов к работе, 
+	// то текущий объект не изменяется.
 	EphemerisRelease& operator=(const EphemerisRelease& other);
 
+#ifdef DEPHEM_MOVE_SEMANTICS
+	// Конструктор перемещения.
+	// ------------------------
+	// Данные выпуска передаются без копирования, объект "other" становится 
+	// неготовым.
+	EphemerisRelease(EphemerisRelease&& other);
+
+	// Оператор перемещения.
+	// ---------------------
+	// См. конструктор перемещения. Если объект "other" не готов к работе,
+	// то текущий объект не изменяется.
+	EphemerisRelease& operator=(EphemerisRelease&& other);
+#endif
+
 	// Деструктор.
 	// -----------
 	// Просто деструктор.
@@ -92,6 +135,171 @@ public:
 	void calculateBody(unsigned calculationResult, unsigned targetBody, 
 		unsigned centerBody, double JED, double* resultArray) const;
 
+	// То же, что и calculateBody(...) выше, но все изменяемые при вычислении
+	// данные хранятся в переданном контексте "context".
+	// -----------------
+	// Примечание: метод можно вызывать одновременно из нескольких потоков, 
+	// если каждый поток использует свой контекст.
+	// -----------------
+	void calculateBody(unsigned calculationResult, unsigned targetBody, 
+		unsigned centerBody, double JED, double* resultArray, 
+			CalculationContext& context) const;
+
+	// То же, что и calculateBody(...) выше, но момент времени задан 
+	// двухчастной Юлианской датой: JED = JED1 + JED2 (например, целая часть
+	// и доля суток). Время внутри блока вычисляется от даты начала блока, 
+	// поэтому точность двухчастной даты сохраняется (см. dph::Epoch).
+	void calculateBody(unsigned calculationResult, unsigned targetBody, 
+		unsigned centerBody, double JED1, double JED2, double* resultArray) const;
+
+	// То же, что и calculateBody(...) выше, но с контекстом "context".
+	void calculateBody(unsigned calculationResult, unsigned targetBody, 
+		unsigned centerBody, double JED1, double JED2, double* resultArray, 
+			CalculationContext& context) const;
+
+	// Подготовить момент времени "epoch" (см. dph::Epoch) по двухчастной 
+	// Юлианской дате JED = JED1 + JED2. Возвращает false, если объект не 
+	// готов к работе или момент не принадлежит промежутку 
+	// [startDate : endDate].
+	bool makeEpoch(double JED1, double JED2, Epoch& epoch) const;
+
+	// То же, что и makeEpoch(...) выше, но для JED одним числом.
+	bool makeEpoch(double JED, Epoch& epoch) const;
+
+	// То же, что и calculateBody(...) выше, но момент времени задан 
+	// подготовленным объектом "epoch" (см. makeEpoch(...)): номер блока и 
+	// время внутри блока повторно не вычисляются.
+	void calculateBody(unsigned calculationResult, unsigned targetBody, 
+		unsigned centerBody, const Epoch& epoch, double* resultArray) const;
+
+	// То же, что и calculateBody(...) выше, но с контекстом "context".
+	void calculateBody(unsigned calculationResult, unsigned targetBody, 
+		unsigned centerBody, const Epoch& epoch, double* resultArray, 
+			CalculationContext& context) const;
+
+	// Получить значения радиус-векторов (или векторов состояния) нескольких
+	// тел относительно одного центрального тела на заданный момент времени.
+	// -------------------------------------------------------------------
+	// Параметры метода:
+	//
+	//	- calculationResult	: Индекс результата вычислений. 
+	//                        Используй dph::Calculate.
+	//
+	//	- targetBodies		: Указатель на массив порядковых номеров искомых 
+	//						  тел размера "count". Используй dph::Body.
+	//
+	//	- count				: Количество искомых тел.
+	//
+	//	- centerBody		: Порядковый номер центрального тела. 
+	//						  Используй dph::Body.
+	//
+	//	- JED				: Момент времени (см. calculateBody(...)).
+	//
+	//	- resultArray		: Указатель на массив для результатов вычислений.
+	//						  Результат для targetBodies[i] записывается 
+	//						  начиная с resultArray[i * n], где n - количество
+	//						  компонент (3 или 6). Размер массива - не менее 
+	//						  count * n.
+	// -----------------
+	// Примечания: 
+	//	1. Параметры проверяются один раз. Если в метод поданы неверные 
+	//	   параметры, то он просто прервётся, не записав ни одного значения.
+	//	2. Центральное тело и общие для нескольких тел базовые элементы 
+	//	   (например, барицентр Земля-Луна и Луна для Земли и Луны) 
+	//	   вычисляются один раз. Результаты совпадают с результатами 
+	//	   calculateBody(...) для каждого тела в отдельности.
+	// -----------------
+	void calculateBodies(unsigned calculationResult, const unsigned* targetBodies,
+		size_t count, unsigned centerBody, double JED, double* resultArray) const;
+
+	// То же, что и calculateBodies(...) выше, но с контекстом "context"
+	// (см. calculateBody(...)).
+	void calculateBodies(unsigned calculationResult, const unsigned* targetBodies,
+		size_t count, unsigned centerBody, double JED, double* resultArray, 
+			CalculationContext& context) const;
+
+	// Получить значения радиус-вектора (или вектора состояния) выбранного
+	// тела относительно другого на ряд моментов времени.
+	// -------------------------------------------------------------------
+	// Параметры метода:
+	//
+	//	- calculationResult, targetBody, centerBody : см. calculateBody(...).
+	//
+	//	- JEDs				: Указатель на массив моментов времени (JED) 
+	//						  размера "count". Порядок моментов произвольный.
+	//						  Каждый момент принадлежит промежутку: 
+	//						  [startDate : endDate].
+	//
+	//	- count				: Количество моментов времени.
+	//
+	//	- resultArray		: Указатель на массив для результатов вычислений.
+	//						  Результат для JEDs[i] записывается начиная с
+	//						  resultArray[i * n], где n - количество компонент
+	//						  (3 или 6). Размер массива - не менее count * n.
+	// -----------------
+	// Примечания: 
+	//	1. Параметры проверяются один раз на весь ряд. Если в метод поданы 
+	//	   неверные параметры (в т.ч. хотя бы один момент времени вне 
+	//	   промежутка), то он просто прервётся, не записав ни одного значения.
+	//	2. Моменты времени группируются по блокам, поэтому каждый блок 
+	//	   загружается один раз за вызов. Результаты совпадают с результатами 
+	//	   calculateBody(...) для каждого момента в отдельности.
+	//	3. Если блок не удалось прочитать из файла, то вычисления 
+	//	   прерываются: результаты для моментов этого и следующих пакетов не
+	//	   записываются.
+	// -----------------
+	void calculateBodySeries(unsigned calculationResult, unsigned targetBody,
+		unsigned centerBody, const double* JEDs, size_t count, 
+			double* resultArray) const;
+
+	// То же, что и calculateBodySeries(...) выше, но с контекстом "context"
+	// (см. calculateBody(...)).
+	void calculateBodySeries(unsigned calculationResult, unsigned targetBody,
+		unsigned centerBody, const double* JEDs, size_t count, 
+			double* resultArray, CalculationContext& context) const;
+
+	// То же, что и calculateBodySeries(...) выше, но для равномерного ряда 
+	// моментов времени: JED[i] = startJED + i * step, i = 0 ... count - 1.
+	// Шаг "step" может быть отрицательным.
+	void calculateBodySeries(unsigned calculationResult, unsigned targetBody,
+		unsigned centerBody, double startJED, double step, size_t count, 
+			double* resultArray) const;
+
+	// То же, что и calculateBodySeries(...) выше, но с контекстом "context"
+	// (см. calculateBody(...)).
+	void calculateBodySeries(unsigned calculationResult, unsigned targetBody,
+		unsigned centerBody, double startJED, double step, size_t count, 
+			double* resultArray, CalculationContext& context) const;
+
+	// То же, что и calculateBodySeries(...) выше, но ряд вычисляется 
+	// параллельно в "threadsCount" потоках (0 - по количеству логических
+	// процессоров). Возвращает false, если параметры неверны (значения не
+	// записываются) или часть блоков не удалось прочитать из файла 
+	// (результаты для моментов этих блоков не записываются).
+	// -----------------
+	// Примечания: 
+	//	1. Проверка моментов времени и дат блоков (Validation::LAZY), 
+	//	   вычисление номеров блоков и упорядочивание моментов по блокам
+	//	   (если они ещё не упорядочены, сортировкой подсчётом) выполняются
+	//	   исполнителями параллельно, каждый по своей доле ряда. Затем ряд
+	//	   делится на части. Каждый поток получает непрерывный промежуток
+	//	   блоков и вычисляет его со своим контекстом, поэтому коэффициенты 
+	//	   блоков не разделяются между потоками. Поток, закончивший свои 
+	//	   части, забирает части других потоков (см. dph::WorkQueue).
+	//	2. Потоки берутся из общего пула (dph::ThreadPool::shared()) и не 
+	//	   запускаются при каждом вызове. Первый исполнитель работает в 
+	//	   вызывающем потоке. Если пул занят другим вызовом, поток не удалось
+	//	   запустить или исполнителю не удалось подготовить контекст, его 
+	//	   части вычисляют остальные исполнители (ряд вычисляется полностью,
+	//	   но с меньшим количеством потоков).
+	//	3. Результаты совпадают с результатами calculateBodySeries(...). 
+	//	   Внутренний контекст объекта не используется: метод можно вызывать
+	//	   одновременно из нескольких потоков.
+	// -----------------
+	bool calculateBodySeriesParallel(unsigned calculationResult, unsigned targetBody,
+		unsigned centerBody, const double* JEDs, size_t count, double* resultArray,
+			unsigned threadsCount) const;
+
 	// Получить значение(-я) прочих элементов, хранящихся в выпуске эфемерид, 
 	// на заданный момент времени.
 	// -----------------
@@ -120,6 +328,108 @@ public:
 	void calculateOther(unsigned calculationResult, unsigned otherItem, 
 		double JED, double* resultArray) const;
 
+	// То же, что и calculateOther(...) выше, но все изменяемые при вычислении
+	// данные хранятся в переданном контексте "context".
+	// -----------------
+	// Примечание: метод можно вызывать одновременно из нескольких потоков, 
+	// если каждый поток использует свой контекст.
+	// -----------------
+	void calculateOther(unsigned calculationResult, unsigned otherItem, 
+		double JED, double* resultArray, CalculationContext& context) const;
+
+	// То же, что и calculateOther(...) выше, но для двухчастной Юлианской 
+	// даты JED = JED1 + JED2 (см. calculateBody(...)).
+	void calculateOther(unsigned calculationResult, unsigned otherItem, 
+		double JED1, double JED2, double* resultArray) const;
+
+	// То же, что и calculateOther(...) выше, но с контекстом "context".
+	void calculateOther(unsigned calculationResult, unsigned otherItem, 
+		double JED1, double JED2, double* resultArray, 
+			CalculationContext& context) const;
+
+	// То же, что и calculateOther(...) выше, но для подготовленного момента
+	// времени "epoch" (см. makeEpoch(...)).
+	void calculateOther(unsigned calculationResult, unsigned otherItem, 
+		const Epoch& epoch, double* resultArray) const;
+
+	// То же, что и calculateOther(...) выше, но с контекстом "context".
+	void calculateOther(unsigned calculationResult, unsigned otherItem, 
+		const Epoch& epoch, double* resultArray, CalculationContext& context) const;
+
+	// Получить значения прочего элемента на ряд моментов времени "JEDs" 
+	// (количество - "count", см. calculateBodySeries(...)). Результат для 
+	// JEDs[i] записывается начиная с resultArray[i * n], где n - количество
+	// значений элемента для выбранного результата вычислений (см. 
+	// calculateOther(...)).
+	void calculateOtherSeries(unsigned calculationResult, unsigned otherItem,
+		const double* JEDs, size_t count, double* resultArray) const;
+
+	// То же, что и calculateOtherSeries(...) выше, но с контекстом "context"
+	// (см. calculateBody(...)).
+	void calculateOtherSeries(unsigned calculationResult, unsigned otherItem,
+		const double* JEDs, size_t count, double* resultArray, 
+			CalculationContext& context) const;
+
+	// Получить видимое положение выбранного тела относительно наблюдателя на
+	// заданный момент наблюдения.
+	// -------------------------------------------------------------------
+	// Параметры метода:
+	//
+	//	- correction		: Индекс поправок видимого положения.
+	//						  Используй dph::Correction.
+	//
+	//	- targetBody		: Порядковый номер наблюдаемого тела.
+	//						  Используй dph::Body.
+	//
+	//	- observerBody		: Порядковый номер тела наблюдателя.
+	//						  Используй dph::Body.
+	//
+	//	- JED				: Момент наблюдения (см. calculateBody(...)).
+	//
+	//	- resultArray		: Указатель на массив для результата вычислений
+	//						  (4 значения): радиус-вектор тела относительно
+	//						  наблюдателя (км) и время распространения света
+	//						  от тела до наблюдателя (с).
+	// -----------------
+	// Примечания:
+	//	1. Положение наблюдателя (и его скорость при Correction::ABERRATION)
+	//	   вычисляется один раз на момент наблюдения. Положение тела
+	//	   уточняется итерациями светового времени, пока момент излучения не
+	//	   перестанет изменяться (не более LIGHT_TIME_ITERATIONS итераций).
+	//	   Итерации выполняются по блоку момента излучения, поэтому за вызов 
+	//	   загружается не более двух блоков.
+	//	2. Скорость света - константа выпуска "CLIGHT" (если её нет - 
+	//	   299792.458 км/с).
+	//	3. Если в метод поданы неверные параметры или момент излучения
+	//	   предшествует startDate(), то он просто прервётся.
+	// -----------------
+	void calculateApparent(unsigned correction, unsigned targetBody,
+		unsigned observerBody, double JED, double* resultArray) const;
+
+	// То же, что и calculateApparent(...) выше, но с контекстом "context"
+	// (см. calculateBody(...)).
+	void calculateApparent(unsigned correction, unsigned targetBody,
+		unsigned observerBody, double JED, double* resultArray,
+			CalculationContext& context) const;
+
+	// Получить видимые положения нескольких тел "targetBodies" (количество -
+	// "count") относительно одного наблюдателя на заданный момент наблюдения
+	// (см. calculateApparent(...)). Результат для targetBodies[i] 
+	// записывается начиная с resultArray[i * 4].
+	// -----------------
+	// Примечание: состояние наблюдателя вычисляется один раз для всех тел.
+	// Если в метод поданы неверные параметры, то он просто прервётся, не 
+	// записав ни одного значения.
+	// -----------------
+	void calculateApparentBodies(unsigned correction, const unsigned* targetBodies,
+		size_t count, unsigned observerBody, double JED, double* resultArray) const;
+
+	// То же, что и calculateApparentBodies(...) выше, но с контекстом 
+	// "context" (см. calculateBody(...)).
+	void calculateApparentBodies(unsigned correction, const unsigned* targetBodies,
+		size_t count, unsigned observerBody, double JED, double* resultArray,
+			CalculationContext& context) const;
+
 
 // --------------------------------- ГЕТТЕРЫ -------------------------------- //
 
@@ -132,16 +442,102 @@ public:
 	// Последняя доступная дата для рассчётов.
 	double endDate() const;
 
+	// Временная протяжённость блока коэффициентов (сутки).
+	double blockTimeSpan() const;
+
 	// Номер выпуска.
 	uint32_t releaseIndex() const;
 
 	// Строковая информация о выпуске.
 	const std::string& releaseLabel() const;
 
-	// Значение константы по её имени.
+	// Значение константы по её имени (0, если константы нет в выпуске).
 	double constant(const std::string& constantName) const;
 
+	// Количество констант в таблице констант выпуска.
+	size_t constantsCount() const;
+
+	// Таблица значений констант (в порядке файла, размер - 
+	// constantsCount()). NULL, если констант нет.
+	const double* constantsValues() const;
+
+	// Имя константы с номером "constantIndex" в таблице (пустая строка при 
+	// неверном номере).
+	std::string constantName(size_t constantIndex) const;
+
+	// Номер константы в таблице по её имени (NO_CONSTANT, если константы нет 
+	// в выпуске). Номер определяется один раз, далее значение берётся 
+	// методом constantAt(...) без поиска по имени.
+	size_t constantIndex(const std::string& constantName) const;
+
+	// Значение константы с номером "constantIndex" в таблице (0 при неверном
+	// номере, в т.ч. NO_CONSTANT).
+	double constantAt(size_t constantIndex) const;
+
+	// Номер отсутствующей константы (см. constantIndex(...)).
+	static const size_t NO_CONSTANT = ~size_t(0);
+
+	// Используемый способ доступа к файлу (см. dph::Access).
+	// Если отобразить (загрузить) файл в память не удалось, используется 
+	// Access::STREAM.
+	unsigned accessMode() const;
+
+	// Файл упакованного формата (см. dph::PackedFormat)?
+	bool isPacked() const;
+
+	// Загруженный в память файл (Access::MEMORY) расположен на больших 
+	// страницах?
+	bool hugePages() const;
+
+	// Используемый набор инструкций (см. dph::InstructionSet).
+	unsigned instructionSet() const;
+
+	// Используемый уровень проверки файла (см. dph::Validation).
+	unsigned validation() const;
+
+	// Количество блоков в кэше каждого контекста вычислений (см. 
+	// dph::ReleaseOptions::cacheSize_bytes).
+	size_t cacheBlocksCount() const;
+
+	// Количество блоков упреждающей загрузки (см. 
+	// dph::ReleaseOptions::prefetchBlocksCount).
+	unsigned prefetchBlocksCount() const;
+
+	// Запрошенные тела и прочие элементы (см. dph::ReleaseOptions::items).
+	unsigned long items() const;
+
+	// Доступно ли для вычислений тело (dph::Body) или прочий элемент 
+	// (dph::Other) "item"? Элемент должен храниться в выпуске и входить в
+	// запрошенные (см. dph::ReleaseOptions::items).
+	bool hasItem(unsigned item) const;
+
+	// Счётчики кэша внутреннего контекста объекта (см. 
+	// dph::CalculationContext). Для собственных контекстов используй 
+	// одноимённые методы контекста.
+	uint64_t cacheHits() const;
+	uint64_t cacheMisses() const;
+	uint64_t cacheEvictions() const;
+
+	// Обнулить счётчики кэша внутреннего контекста объекта.
+	void resetCacheCounters();
+
+	// Снимок счётчиков внутреннего контекста объекта (см. dph::Statistics).
+	// Для собственных контекстов используй одноимённый метод контекста.
+	Statistics statistics() const;
+
+	// Обнулить все счётчики внутреннего контекста объекта.
+	void resetStatistics();
+
 private:
+
+	// Доступ к ключам, константам и блокам выпуска для "обрезки" файла.
+	friend class ReleaseTrimmer;
+
+	// Доступ к формату заголовка для чтения дат файла.
+	friend class ReleaseSet;
+
+	// Доступ к заголовку и блокам выпуска для записи упакованного файла.
+	friend class PackedWriter;
 		
 // -------------------------- Внутренние значения --------------------------- //
 
@@ -162,6 +558,23 @@ private:
 	// Кол-во констант (нов. формат).
 	static const size_t CCOUNT_MAX_NEW = 1000;	  
 
+// .......................... Пакетные вычисления ........................... //
+
+	// Максимальное количество моментов времени, обрабатываемых за один проход
+	// (пакет) при вычислении рядов.
+	static const size_t SERIES_CHUNK_SIZE = 64;
+
+// ........................... Видимые положения ............................ //
+
+	// Максимальное количество итераций светового времени.
+	static const unsigned LIGHT_TIME_ITERATIONS = 10;
+
+	// Минимальное количество блоков в кэше контекста (Access::STREAM): 
+	// видимое положение использует одновременно блок момента наблюдения и 
+	// блок момента излучения. При таком количестве ячеек блок ищется их 
+	// перебором, без таблицы ячеек блоков.
+	static const size_t CACHE_BLOCKS_MIN = 2;
+
 // ............................ Состояние объекта ............................//
 
 	bool m_ready;	// Готовность объекта к работе.									
@@ -169,7 +582,32 @@ private:
 // ........................... Работа с файлом ...............................//
 
 	std::string	 m_binaryFilePath;				// Путь к файлу эфемерид.	
-	mutable std::ifstream m_binaryFileStream;	// Поток чтения файла.	
+	mutable std::ifstream m_binaryFileStream;	// Поток чтения файла (открытие и проверка).
+	unsigned	 m_accessMode;					// Способ доступа к файлу.
+	unsigned	 m_instructionSet;				// Набор инструкций для интерполяции.
+	unsigned	 m_validation;					// Уровень проверки файла.
+	size_t		 m_cacheSize_bytes;				// Запрошенный объём кэша контекста.
+	ReleaseCore* m_core;						// Файл в памяти и константы.
+	unsigned	 m_loadThreadsCount;			// Количество потоков загрузки.
+	bool		 m_hugePagesRequested;			// Запрошены большие страницы?
+	unsigned	 m_prefetchBlocksCount;			// Упреждающая загрузка блоков.
+
+// ......................... Упакованный формат ............................. //
+
+	bool					m_packed;				// Файл упакованного формата?
+	PackedFormat::Header	m_packedHeader;			// Заголовок упакованного файла.
+	const double*			m_packedItems[15];		// Коэффициенты элементов (блок 0).
+	size_t					m_packedStrides[15];	// Шаг между записями (double).
+
+// ....................... Используемые элементы ............................ //
+
+	unsigned long	m_items;				// Запрошенные тела и элементы (0 - все).
+	uint32_t		m_residentItems;		// Используемые базовые элементы (биты).
+	uint32_t		m_residentRuns[16][2];	// Читаемые участки блока (double).
+	unsigned		m_residentRunsCount;	// Количество участков блока.
+	uint32_t		m_residentOffsets[15];	// Смещения элементов в блоке памяти.
+	uint32_t		m_residentLength;		// Размер блока в памяти (double).
+	bool			m_compactImage;			// В памяти - только участки блоков?
 
 // ..................... Значения, считанные из файла ....................... //
 
@@ -182,21 +620,31 @@ private:
 	double			m_au;				// Астрономическая единица (км).      
 	double			m_emrat;			// Отношение массы Земли к массе Луны.  
 
-	std::map<std::string, double> m_constants;	// Константы выпуска.
-
 // ......... Значения, дополнительно определённные внутри объекта ........... //
 
 	size_t		m_blocksCount;		// Количество блоков в файле.                
 	uint32_t	m_ncoeff;			// Количество коэффициентов в блоке.              
 	double		m_emrat2;			// Отношение массы Луны к массе Земля-Луна.
 	double		m_dimensionFit;		// Значение для соблюдения размерности.
+	double		m_clight;			// Скорость света (км/с).
 	size_t		m_blockSize_bytes;	// Размер блока в байтах.
+	size_t		m_polynomsCount;	// Максимальное количество полиномов в выпуске.
+	size_t		m_cacheBlocksCount;	// Количество блоков в кэше контекста.
+
+	// Шаблонные ядра интерполяции базовых элементов (NULL - общие ядра, см.
+	// dph::Chebyshev):
+	Chebyshev::PositionKernel	m_positionKernels[15];
+	Chebyshev::StateKernel		m_stateKernels[15];
+
+// ................ Контекст вычислений по умолчанию ........................ //
 
-// .............. Динамические массивы для работы с выпуском ................ //
+	mutable CalculationContext m_context;	// Используется методами без контекста.
 
-	mutable std::vector<double> m_buffer;	// Буффер блока с коэффициентами.
-	mutable std::vector<double> m_poly;		// Значения полиномов.
-	mutable std::vector<double> m_dpoly;	// Значения производных полиномов.
+	// Поколение объекта: новое значение (единое для всех объектов) при 
+	// каждой очистке, в т.ч. при открытии, копировании и перемещении. 
+	// Контексты, привязанные к прежнему поколению (или к другому объекту по 
+	// тому же адресу), переинициализируются (см. bindContext(...)).
+	uint64_t m_generation;
 
 
 // -------------------- Приватные методы работы объекта --------------------- //
@@ -207,14 +655,26 @@ private:
 	// размера "arraySize".
 	static std::string cutBackSpaces(const char* charArray, size_t arraySize);
 
+	// Следующее значение поколения объектов (см. m_generation). Счётчик 
+	// изменяется атомарно.
+	static uint64_t nextGeneration();
+
 // .............. Дополнения к стандартным публичным методам ................ //
 
 	// Приведение объекта к изначальному состоянию.
 	void clear();
 		
-	// Копирование информации из объекта "other" в текущий объект.
+	// Копирование информации из объекта "other" в текущий объект (кроме 
+	// ядра, см. shareCore(...)).
 	void copyHere(const EphemerisRelease& other);
 
+	// Использование ядра "core" (с добавлением ссылки) вместо текущего.
+	void shareCore(ReleaseCore* core);
+
+	// Освобождение ссылки на текущее ядро (с удалением ядра, если ссылок не
+	// осталось).
+	void releaseCore();
+
 // ........... Чтение файла и инициализация внутренних значений ............. //
 
 	//  Чтение файла.
@@ -223,49 +683,307 @@ private:
 	// Дополнительные вычисления после чтения файла.
 	void additionalCalculations();
 
+	// Определение используемых базовых элементов и расположения их 
+	// коэффициентов в блоке (участки чтения, смещения в буффере).
+	void arrangeResidentItems();
+
+	// Базовые элементы (биты), необходимые для вычислений тела (dph::Body) 
+	// или прочего элемента (dph::Other) "item".
+	static uint32_t baseItemsOf(unsigned item);
+
+	// Загрузка в память только участков блоков с используемыми элементами
+	// (Access::MEMORY при заданных dph::ReleaseOptions::items).
+	bool loadResidentItems();
+
 	// Проверка значений, хранящихся в объекте и проверка файла.
 	bool isDataCorrect() const;
 
-	// Проверка начальных и конечных дат всех блоков в файле.
+	// Проверка заголовка упакованного файла размера "fileSize" байт
+	// (см. dph::PackedFormat). Входит в состав проверки isDataCorrect().
+	bool isPackedDataCorrect(size_t fileSize) const;
+
+	// Проверка начальных и конечных дат блоков в файле (всех блоков при
+	// Validation::FULL, выборки блоков при Validation::SAMPLED).
 	// Подтверждает целостность файла и доступность всех коэффициентов.
 	// Входит в состав проверки isDataCorrect().
 	bool check_blocksDates() const;
 
-	// Заполнение буффера "m_buffer" коэффициентами требуемого блока.
-	void fillBuffer(size_t block_num) const;
+	// Начало файла в памяти (Access::MMAP и Access::MEMORY).
+	const char* fileData() const;
+
+	// Смещение (байт) дат блока "blockIndex" от начала файла. В формате JPL
+	// - начало блока, в упакованном формате - элемент массива дат. Если в 
+	// памяти хранятся только участки блоков - начало участков блока.
+	size_t blockAddress(size_t blockIndex) const;
+
+	// Коэффициенты базового элемента "baseItemIndex" в текущем блоке 
+	// контекста "context" (первый подблок).
+	const double* itemBlock(unsigned baseItemIndex, 
+		const CalculationContext& context) const;
+
+	// Чтение начальной и конечной дат блока "blockIndex" из потока "stream"
+	// (или из памяти при доступе Access::MMAP и Access::MEMORY) в массив 
+	// "blockDates".
+	bool readBlockDates(size_t blockIndex, std::ifstream& stream, 
+		double* blockDates) const;
+
+	// Соответствуют ли даты "blockDates" ожидаемым датам блока "blockIndex"?
+	bool isBlockDatesCorrect(size_t blockIndex, const double* blockDates) const;
+
+	// Привязка контекста к объекту (подготовка буфферов и потока чтения).
+	// Контекст считается привязанным, если он привязан к текущему поколению 
+	// объекта (см. m_generation). Возвращает false, если контекст не удалось
+	// подготовить.
+	bool bindContext(CalculationContext& context) const;
+
+	// Заполнение буффера контекста коэффициентами требуемого блока (или, при
+	// доступе Access::MMAP и Access::MEMORY, установка указателя на блок в
+	// памяти). При доступе Access::STREAM блок сначала ищется в кэше 
+	// контекста.
+	// При Validation::LAZY даты блока проверяются при первой загрузке. 
+	// Возвращает false (текущего блока в контексте нет), если блок не удалось
+	// прочитать или его даты неверны.
+	bool fillBuffer(size_t block_num, CalculationContext& context) const;
+
+	// Упреждающая загрузка блоков при последовательном обходе: если блок 
+	// "blockIndex" следует за текущим блоком контекста (или предшествует ему),
+	// ОС запрашивается фоновая загрузка следующих в том же направлении блоков
+	// (см. dph::ReleaseOptions::prefetchBlocksCount).
+	void prefetchBlocks(size_t blockIndex, CalculationContext& context) const;
+
+	// Проверка дат блока "blockIndex" без его загрузки (Validation::LAZY).
+	// Результат проверки запоминается в контексте. При других уровнях 
+	// проверки всегда возвращает true.
+	bool checkBlockOnce(size_t blockIndex, CalculationContext& context) const;
+
+	// Коэффициенты блока "blockIndex", загруженного в контекст "context"
+	// (NULL, если блок не удалось загрузить).
+	const double* loadBlock(size_t blockIndex, CalculationContext& context) const;
+
+	// Загрузка (при Validation::LAZY - с проверкой дат) блока момента времени
+	// "epoch" до начала вычислений. Возвращает false, если блок не удалось 
+	// загрузить (вычисления не выполняются).
+	bool prepareBlock(const Epoch& epoch, CalculationContext& context) const;
+
+	// Заполнить момент времени "epoch" по JED из промежутка 
+	// [startDate : endDate] (без проверок).
+	void setEpoch(double JED, Epoch& epoch) const;
+
+	// Подходит ли момент времени "epoch" для вычислений по выпуску (та же 
+	// шкала блоков)?
+	bool isEpochCorrect(const Epoch& epoch) const;
 
 // .............................. Вычисления ................................ //
 
 	// Интерполяция компонент выбранного базового элемента.
+	// Вычислены ли в контексте "context" первые "polynomsCount" полиномов (и,
+	// при "withDerivatives", их производных) для нормированного времени
+	// "normalizedTime"?
+	static bool isPolynomsReady(double normalizedTime, uint32_t polynomsCount,
+		bool withDerivatives, const CalculationContext& context);
+
+	// Отметить в контексте "context", что первые "polynomsCount" полиномов
+	// (и, при "withDerivatives", их производных) вычислены для нормированного
+	// времени "normalizedTime".
+	static void setPolynomsReady(double normalizedTime, uint32_t polynomsCount,
+		bool withDerivatives, CalculationContext& context);
+
+	// Вычислить в контексте "context" первые "polynomsCount" полиномов (и, при
+	// "withDerivatives", их производных) для нормированного времени
+	// "normalizedTime". Уже вычисленные для того же времени значения не
+	// пересчитываются.
+	void fillPolynoms(double normalizedTime, uint32_t polynomsCount, 
+		bool withDerivatives, CalculationContext& context) const;
+
 	void interpolatePosition(unsigned baseItemIndex, double normalizedTime, 
 		const double* coeffArray, unsigned componentsCount, 
-			double* resultArray) const;
+			double* resultArray, CalculationContext& context) const;
 
 	// Интерполяция компонент и их производных выбранного базового элемента.
 	void interpolateState(unsigned baseItemIndex, double normalizedTime,
 		const double* coeffArray, unsigned componentsCount, 
-			double* resultArray) const;
+			double* resultArray, CalculationContext& context) const;
 
 	// Получить значения требуемых компонент базового элемента на выбранный 
-	// момент времени.
-	void calculateBaseItem(unsigned baseItemIndex, double JED, 
-		unsigned calculationResult , double* resultArray) const;
+	// момент времени. Если блок момента не удалось загрузить, то результат -
+	// нули (блок загружается заранее, см. prepareBlock(...)).
+	void calculateBaseItem(unsigned baseItemIndex, const Epoch& epoch, 
+		unsigned calculationResult , double* resultArray, 
+			CalculationContext& context) const;
 
 	// Получить значение радиус-вектора (или вектора состояния) Земли 
 	// относительно барицентра Солнечной Системы.
-	void calculateBaseEarth(double JED, unsigned calculationResult, 
-		double* resultArray) const;
+	void calculateBaseEarth(const Epoch& epoch, unsigned calculationResult, 
+		double* resultArray, CalculationContext& context) const;
 
 	// Получить значение радиу-вектора (или вектора состояния) Луны относительно
 	// барицентра Солнечной Системы.
-	void calculateBaseMoon(double JED, unsigned calculationResult, 
-		double* resultArray) const;
+	void calculateBaseMoon(const Epoch& epoch, unsigned calculationResult, 
+		double* resultArray, CalculationContext& context) const;
+
+// ...................... Вычисления для нескольких тел ..................... //
+
+	// Значения базового элемента "baseItemIndex" на момент времени "epoch". 
+	// Вычисляются один раз в пределах вызова calculateBodies(...):
+	// "itemValues" - значения базовых элементов, "isCalculated" - признаки
+	// вычисленных элементов.
+	const double* calculateBaseItemOnce(unsigned baseItemIndex, const Epoch& epoch, 
+		unsigned calculationResult, double (*itemValues)[6], bool* isCalculated,
+			CalculationContext& context) const;
+
+	// Аналог calculateBase...(...) для тела "body" (кроме барицентра СС) с 
+	// однократным вычислением базовых элементов (см. calculateBaseItemOnce).
+	void calculateBaseBodyOnce(unsigned body, const Epoch& epoch, 
+		unsigned calculationResult, double* resultArray, double (*itemValues)[6], 
+			bool* isCalculated, CalculationContext& context) const;
+
+// ........................... Видимые положения ............................ //
+
+	// Аналог calculateBase...(...) для любого тела "body" (для барицентра СС
+	// - нулевой вектор).
+	void calculateBaseBody(unsigned body, const Epoch& epoch, 
+		unsigned calculationResult, double* resultArray, 
+			CalculationContext& context) const;
+
+	// Видимое положение тела "targetBody" (4 значения, см. 
+	// calculateApparent(...)) для наблюдателя с состоянием "observerState"
+	// относительно барицентра СС на момент наблюдения JED. Возвращает false,
+	// если момент излучения вне выпуска или блок не удалось загрузить.
+	bool calculateApparentBody(unsigned correction, unsigned targetBody, double JED,
+		const double* observerState, double* resultArray, 
+			CalculationContext& context) const;
+
+// ........................... Пакетные вычисления .......................... //
+
+	// Порядковый номер блока, соответствующего моменту времени JED (не 
+	// более m_blocksCount - 1).
+	size_t blockIndexOf(double JED) const;
+
+	// Аналог calculateBaseItem(...) для пакета моментов времени "JEDs" 
+	// (не более SERIES_CHUNK_SIZE), принадлежащих одному блоку. Возвращает 
+	// false, если блок не удалось загрузить (результат не записывается).
+	bool calculateBaseItemChunk(unsigned baseItemIndex, const double* JEDs, 
+		size_t count, unsigned calculationResult, double* resultArray, 
+			CalculationContext& context) const;
+
+	// Вычисление ряда моментов времени "JEDs" для тела "item" относительно 
+	// "centerBody" (или прочего элемента "item"): моменты времени 
+	// группируются по блокам в пакеты. "componentsCount" - количество 
+	// значений результата на один момент времени. Параметры проверены.
+	// Возвращает false, если блок не удалось загрузить: вычисления 
+	// прерываются, результаты следующих пакетов не записываются.
+	bool calculateSeries(unsigned calculationResult, unsigned item, 
+		unsigned centerBody, const double* JEDs, size_t count, 
+			unsigned componentsCount, double* resultArray, 
+				CalculationContext& context) const;
+
+	// Вычисление пакета: calculateBodyChunk(...) для тел, 
+	// calculateBaseItemChunk(...) для прочих элементов.
+	bool calculateItemChunk(unsigned calculationResult, unsigned item, 
+		unsigned centerBody, const double* JEDs, size_t count, 
+			double* resultArray, CalculationContext& context) const;
+
+// ......................... Параллельные вычисления ........................ //
+
+	// Минимальное количество моментов времени в одной части параллельного 
+	// ряда.
+	static const size_t PARALLEL_UNIT_MIN_SIZE = 256;
+
+	// Количество частей параллельного ряда на один поток (для 
+	// перераспределения работы между потоками).
+	static const size_t PARALLEL_UNITS_PER_THREAD = 32;
+
+	// Параллельный ряд (см. calculateBodySeriesParallel(...)).
+	struct ParallelSeries
+	{
+		const EphemerisRelease* release;
+
+		unsigned		calculationResult;
+		unsigned		targetBody;
+		unsigned		centerBody;
+		const double*	JEDs;
+		size_t			count;
+		unsigned		componentsCount;
+		double*			resultArray;
+
+		unsigned		workersCount;	// Исполнители (доли ряда при подготовке).
+		size_t*			blocks;			// Номера блоков моментов времени.
+
+		// Номера моментов времени, упорядоченных по блокам (NULL, если 
+		// моменты уже упорядочены).
+		size_t*			order;
+
+		// Сортировка подсчётом: блоки ряда (от firstBlock, количество - 
+		// blocksWidth) делятся на sortersCount отрезков, у каждого
+		// исполнителя сортировки своя строка гистограммы "counts".
+		size_t			firstBlock;
+		size_t			blocksWidth;
+		unsigned		sortersCount;
+		size_t*			counts;
+		size_t*			segmentStarts;	// Начала отрезков блоков в "order".
+
+		size_t			unitSize;		// Количество моментов времени в части.
+		WorkQueue*		queue;			// Части ряда.
+	};
+
+	// Исполнитель параллельного ряда (аргумент потока).
+	struct ParallelWorker
+	{
+		const ParallelSeries*	series;
+		unsigned				index;		// Номер исполнителя.
+
+		// Контекст исполнителя (создаётся в потоке исполнителя при 
+		// подготовке, NULL - не удалось создать).
+		CalculationContext*		context;
+
+		// Результаты подготовки своей доли ряда:
+		bool		isRejected;		// Момент вне выпуска или неверные даты блока.
+		bool		isOrdered;		// Моменты доли упорядочены по блокам?
+		size_t		headBlock;		// Блоки первого и последнего моментов.
+		size_t		tailBlock;
+		size_t		minBlock;		// Наименьший и наибольший блоки.
+		size_t		maxBlock;
+
+		bool		isFailed;		// Часть ряда не вычислена?
+	};
+
+	// Начало доли "part" из "partsCount" равных долей "count" элементов.
+	static size_t sliceStart(size_t count, size_t part, size_t partsCount);
+
+	// Этапы параллельного ряда (функции потока, аргумент - ParallelWorker):
+	//	- подготовка доли ряда: проверка моментов времени, номера их блоков и
+	//	  проверка дат блоков (Validation::LAZY);
+	//	- гистограмма блоков доли ряда;
+	//	- количество моментов в отрезке блоков (по всем гистограммам);
+	//	- начала блоков отрезка в "order" (по всем гистограммам);
+	//	- раскладка номеров моментов доли ряда в "order";
+	//	- вычисление частей ряда.
+	static void prepareParallelSlice(void* worker);
+	static void countParallelSlice(void* worker);
+	static void sumParallelSegment(void* worker);
+	static void offsetParallelSegment(void* worker);
+	static void scatterParallelSlice(void* worker);
+	static void runParallelWorker(void* worker);
+
+	// Аналог calculateBase...(...) для тела "body" (кроме барицентра СС) и
+	// пакета моментов времени одного блока (см. calculateBaseItemChunk(...)).
+	bool calculateBaseBodyChunk(unsigned body, const double* JEDs, size_t count,
+		unsigned calculationResult, double* resultArray, 
+			CalculationContext& context) const;
+
+	// Аналог calculateBody(...) (без проверки параметров) для пакета моментов
+	// времени одного блока (см. calculateBaseItemChunk(...)).
+	bool calculateBodyChunk(unsigned calculationResult, unsigned targetBody, 
+		unsigned centerBody, const double* JEDs, size_t count, 
+			double* resultArray, CalculationContext& context) const;
 
 }; // class EphemerisRelease
 
 } // namespace dph
 
-dph::EphemerisRelease::EphemerisRelease(const std::string& binaryFilePath)
+dph::EphemerisRelease::EphemerisRelease(const std::string& binaryFilePath,
+	const ReleaseOptions& options)
+	: m_core(new ReleaseCore)
 {			
 	// Инициализация внутренних переменных:
 	clear();
@@ -281,8 +999,56 @@ dph::EphemerisRelease::EphemerisRelease(const std::string& binaryFilePath)
 
 	if (isFileOpen)
 	{
+		// Упакованный файл читается только из памяти (по умолчанию - через
+		// отображение):
+		m_packed = PackedFormat::readHeader(m_binaryFileStream, m_packedHeader);
+
+		bool isMappingRequested = options.accessMode == Access::MMAP || 
+			(m_packed && options.accessMode != Access::MEMORY);
+
+		// Отображение файла в память (при неудаче - чтение через поток):
+		if (isMappingRequested && m_core->mappedFile.open(m_binaryFilePath))
+		{
+			m_accessMode = Access::MMAP;
+		}
+
+		// Загрузка файла в память целиком (при неудаче - чтение через поток):
+		m_loadThreadsCount = options.loadThreadsCount;
+		m_hugePagesRequested = options.hugePages;
+		m_prefetchBlocksCount = options.prefetchBlocksCount;
+		m_items = options.items;
+
+		// Выборочная загрузка файла JPL выполняется после чтения ключей (см.
+		// ниже):
+		bool isFullLoadRequested = options.accessMode == Access::MEMORY &&
+			(m_packed || m_items == 0);
+
+		if (isFullLoadRequested && 
+			m_core->loadedFile.load(m_binaryFilePath, m_loadThreadsCount, m_hugePagesRequested))
+		{
+			m_accessMode = Access::MEMORY;
+		}
+
+		// Выбор ядер интерполяции по возможностям процессора:
+		m_instructionSet = Chebyshev::selectInstructionSet(options.instructionSet);
+
+		// Уровень проверки файла (неизвестные значения - полная проверка):
+		m_validation = options.validation > Validation::FULL ? Validation::FULL :
+			options.validation;
+
+		// Объём кэша блоков (количество блоков определяется после чтения файла):
+		m_cacheSize_bytes = options.cacheSize_bytes;
+
 		readAndPackData();
 
+		// Загрузка только используемых элементов (при неудаче - чтение через 
+		// поток):
+		if (options.accessMode == Access::MEMORY && m_accessMode == Access::STREAM &&
+			isFullLoadRequested == false && loadResidentItems())
+		{
+			m_accessMode = Access::MEMORY;
+		}
+
 		if (isDataCorrect())
 		{
 			m_ready = true;
@@ -291,6 +1057,10 @@ dph::EphemerisRelease::EphemerisRelease(const std::string& binaryFilePath)
 		{
 			clear();
 		}
+
+		// Поток нужен только для чтения и проверки файла. Коэффициенты 
+		// читаются через контексты вычислений:
+		m_binaryFileStream.close();
 	}
 	else
 	{
@@ -299,53 +1069,188 @@ dph::EphemerisRelease::EphemerisRelease(const std::string& binaryFilePath)
 }
 
 dph::EphemerisRelease::EphemerisRelease(const EphemerisRelease& other)
+	: m_core(new ReleaseCore)
 {
+	// Инициализация внутренних переменных (копия неготового объекта также 
+	// является неготовой):
+	clear();
+
 	if (other.m_ready)
 	{
 		copyHere(other);
-
-		if (isDataCorrect())
-		{
-			m_ready = true;
-		}
-		else
-		{
-			m_ready = false;
-			
-			clear();
-		}
+		shareCore(other.m_core);
 	}
 }
 
 dph::EphemerisRelease& dph::EphemerisRelease::operator=(const EphemerisRelease& other)
 {
+	if (other.m_ready && this != &other)
+	{
+		clear();
+		copyHere(other);
+		shareCore(other.m_core);
+	}
+
+	return *this;
+}
+
+#ifdef DEPHEM_MOVE_SEMANTICS
+dph::EphemerisRelease::EphemerisRelease(EphemerisRelease&& other)
+	: m_core(new ReleaseCore)
+{
+	clear();
+
 	if (other.m_ready)
+	{
+		// Ядро передаётся без изменения счётчика ссылок, "other" получает 
+		// пустое ядро текущего объекта:
+		copyHere(other);
+		std::swap(m_core, other.m_core);
+
+		other.clear();
+	}
+}
+
+dph::EphemerisRelease& dph::EphemerisRelease::operator=(EphemerisRelease&& other)
+{
+	if (other.m_ready && this != &other)
 	{
 		clear();
 		copyHere(other);
+		std::swap(m_core, other.m_core);
 
-		if (isDataCorrect())
-		{
-			m_ready = true;
-		}
-		else
-		{
-			m_ready = false;
-			
-			clear();
-		}
+		other.clear();
 	}
 
 	return *this;
 }
+#endif
 
 dph::EphemerisRelease::~EphemerisRelease()
 {
 	m_binaryFileStream.close();
+
+	releaseCore();
 }
 
 void dph::EphemerisRelease::calculateBody(unsigned calculationResult,
 	unsigned targetBody, unsigned centerBody, double JED, double* resultArray) const
+{
+	calculateBody(calculationResult, targetBody, centerBody, JED, resultArray, m_context);
+}
+
+void dph::EphemerisRelease::calculateBody(unsigned calculationResult,
+	unsigned targetBody, unsigned centerBody, double JED, double* resultArray,
+		CalculationContext& context) const
+{
+	Epoch epoch;
+
+	if (makeEpoch(JED, epoch))
+	{
+		calculateBody(calculationResult, targetBody, centerBody, epoch, resultArray,
+			context);
+	}
+}
+
+void dph::EphemerisRelease::calculateBody(unsigned calculationResult,
+	unsigned targetBody, unsigned centerBody, double JED1, double JED2,
+		double* resultArray) const
+{
+	calculateBody(calculationResult, targetBody, centerBody, JED1, JED2, resultArray,
+		m_context);
+}
+
+void dph::EphemerisRelease::calculateBody(unsigned calculationResult,
+	unsigned targetBody, unsigned centerBody, double JED1, double JED2,
+		double* resultArray, CalculationContext& context) const
+{
+	Epoch epoch;
+
+	if (makeEpoch(JED1, JED2, epoch))
+	{
+		calculateBody(calculationResult, targetBody, centerBody, epoch, resultArray,
+			context);
+	}
+}
+
+bool dph::EphemerisRelease::makeEpoch(double JED1, double JED2, Epoch& epoch) const
+{
+	// Разности с датами выпуска вычисляются до сложения частей (без потери 
+	// точности JED2):
+	if (m_ready == false || m_blocksCount == 0)
+	{
+		return false;
+	}
+	else if ((JED1 - m_startDate) + JED2 < 0 || (JED1 - m_endDate) + JED2 > 0)
+	{
+		return false;
+	}
+
+	epoch.m_JED = JED1 + JED2;
+	epoch.m_startDate = m_startDate;
+	epoch.m_blockTimeSpan = m_blockTimeSpan;
+
+	// Порядковый номер блока (по приближённому времени):
+	size_t blockIndex = static_cast<size_t>(((JED1 - m_startDate) + JED2) / 
+		m_blockTimeSpan);
+
+	if (blockIndex >= m_blocksCount)
+	{
+		blockIndex = m_blocksCount - 1;
+	}
+
+	// Время внутри блока - от даты начала блока:
+	double blockTime = ((JED1 - (m_startDate + blockIndex * m_blockTimeSpan)) + JED2) /
+		m_blockTimeSpan;
+
+	// Ошибка округления на границе блоков исправляется переходом к соседнему
+	// блоку:
+	if (blockTime < 0 && blockIndex > 0)
+	{
+		--blockIndex;
+		blockTime = ((JED1 - (m_startDate + blockIndex * m_blockTimeSpan)) + JED2) /
+			m_blockTimeSpan;
+	}
+	else if (blockTime >= 1 && blockIndex + 1 < m_blocksCount)
+	{
+		++blockIndex;
+		blockTime = ((JED1 - (m_startDate + blockIndex * m_blockTimeSpan)) + JED2) /
+			m_blockTimeSpan;
+	}
+
+	epoch.m_blockIndex = blockIndex;
+	epoch.m_blockTime = blockTime < 0 ? 0 : blockTime > 1 ? 1 : blockTime;
+
+	return true;
+}
+
+bool dph::EphemerisRelease::makeEpoch(double JED, Epoch& epoch) const
+{
+	if (m_ready == false || m_blocksCount == 0)
+	{
+		return false;
+	}
+	else if (JED < m_startDate || JED > m_endDate)
+	{
+		return false;
+	}
+
+	setEpoch(JED, epoch);
+
+	return true;
+}
+
+void dph::EphemerisRelease::calculateBody(unsigned calculationResult,
+	unsigned targetBody, unsigned centerBody, const Epoch& epoch, 
+		double* resultArray) const
+{
+	calculateBody(calculationResult, targetBody, centerBody, epoch, resultArray, 
+		m_context);
+}
+
+void dph::EphemerisRelease::calculateBody(unsigned calculationResult,
+	unsigned targetBody, unsigned centerBody, const Epoch& epoch, 
+		double* resultArray, CalculationContext& context) const
 {
 	// Допустимые значения параметров:
 	// -------------------------------
@@ -374,8 +1279,8 @@ void dph::EphemerisRelease::calculateBody(unsigned calculationResult,
 	//		------------------------------------
 	//		Примечание: используй значения из dph::Body.
 	//
-	//	- JED:
-	//		JED должен принадлежать промежутку: [m_startDate : m_endDate].
+	//	- epoch:
+	//		Момент времени, подготовленный методом makeEpoch(...).
 	//
 	//	- resultArray:
 	//		От пользователя требуется знать, каков минимальный размер массива для 
@@ -399,7 +1304,11 @@ void dph::EphemerisRelease::calculateBody(unsigned calculationResult,
 	{
 		return;
 	}
-	else if (JED < m_startDate || JED > m_endDate)
+	else if (hasItem(targetBody) == false || hasItem(centerBody) == false)
+	{
+		return;
+	}
+	else if (isEpochCorrect(epoch) == false)
 	{
 		return;
 	}
@@ -407,6 +1316,14 @@ void dph::EphemerisRelease::calculateBody(unsigned calculationResult,
 	{
 		return;
 	}
+	else if (bindContext(context) == false)
+	{
+		return;
+	}
+	else if (prepareBlock(epoch, context) == false)
+	{
+		return;
+	}
 
 	// Количество требуемых компонент:
 	unsigned componentsCount = calculationResult == Calculate::STATE ? 6 : 3;
@@ -435,10 +1352,10 @@ void dph::EphemerisRelease::calculateBody(unsigned calculationResult,
 		// Выбор метода вычисления в зависимости от тела:
 		switch (notSSBARY)
 		{
-		case Body::EARTH: calculateBaseEarth(JED, calculationResult, resultArray);	break;
-		case Body::MOON: calculateBaseMoon(JED, calculationResult, resultArray);		break;
-		case Body::EMBARY: calculateBaseItem(2, JED, calculationResult, resultArray);	break;
-		default: calculateBaseItem(notSSBARY - 1, JED, calculationResult, resultArray);
+		case Body::EARTH: calculateBaseEarth(epoch, calculationResult, resultArray, context);	break;
+		case Body::MOON: calculateBaseMoon(epoch, calculationResult, resultArray, context);		break;
+		case Body::EMBARY: calculateBaseItem(2, epoch, calculationResult, resultArray, context);	break;
+		default: calculateBaseItem(notSSBARY - 1, epoch, calculationResult, resultArray, context);
 		}
 
 		// Если барицентр СС является искомым телом, то возвращается "зеркальный" вектор:
@@ -459,7 +1376,7 @@ void dph::EphemerisRelease::calculateBody(unsigned calculationResult,
 		// "зеркальный вектор".
 
 		// Получение радиус-вектора (или вектора состояния) Луны относительно Земли:
-		calculateBaseItem(9, JED, calculationResult, resultArray);
+		calculateBaseItem(9, epoch, calculationResult, resultArray, context);
 
 		// Если искомым телом является Земля, то возвращается "зеркальный" вектор.
 		if (targetBody == Body::EARTH)
@@ -493,10 +1410,10 @@ void dph::EphemerisRelease::calculateBody(unsigned calculationResult,
 			// Выбор метода вычисления в зависимости от тела:
 			switch (currentBodyIndex)
 			{
-			case Body::EARTH: calculateBaseEarth(JED, calculationResult, currentArray);	break;
-			case Body::MOON: calculateBaseMoon(JED, calculationResult, currentArray);	break;
-			case Body::EMBARY: calculateBaseItem(2, JED, calculationResult, currentArray);	break;
-			default: calculateBaseItem(currentBodyIndex - 1, JED, calculationResult, currentArray);
+			case Body::EARTH: calculateBaseEarth(epoch, calculationResult, currentArray, context);	break;
+			case Body::MOON: calculateBaseMoon(epoch, calculationResult, currentArray, context);	break;
+			case Body::EMBARY: calculateBaseItem(2, epoch, calculationResult, currentArray, context);	break;
+			default: calculateBaseItem(currentBodyIndex - 1, epoch, calculationResult, currentArray, context);
 			}
 		}
 
@@ -512,15 +1429,58 @@ void dph::EphemerisRelease::calculateOther(unsigned calculationResult,
 	unsigned otherItem, double JED,
 	double* resultArray) const
 {
-	// Допустимые значения параметров:
-	// -------------------------------
-	//	- calculationResult:
-	//		1 - Получить оригинальное значение,
-	//		2 - Получить оригинальное значение и его (их) производные первого порядка.
-	//		Примечание: используй значения из dph::Calculate.
-	//	
-	//	- other Item:
-	//		----------------------------------------------------------------		
+	calculateOther(calculationResult, otherItem, JED, resultArray, m_context);
+}
+
+void dph::EphemerisRelease::calculateOther(unsigned calculationResult,
+	unsigned otherItem, double JED,
+	double* resultArray, CalculationContext& context) const
+{
+	Epoch epoch;
+
+	if (makeEpoch(JED, epoch))
+	{
+		calculateOther(calculationResult, otherItem, epoch, resultArray, context);
+	}
+}
+
+void dph::EphemerisRelease::calculateOther(unsigned calculationResult,
+	unsigned otherItem, double JED1, double JED2, double* resultArray) const
+{
+	calculateOther(calculationResult, otherItem, JED1, JED2, resultArray, m_context);
+}
+
+void dph::EphemerisRelease::calculateOther(unsigned calculationResult,
+	unsigned otherItem, double JED1, double JED2, double* resultArray,
+		CalculationContext& context) const
+{
+	Epoch epoch;
+
+	if (makeEpoch(JED1, JED2, epoch))
+	{
+		calculateOther(calculationResult, otherItem, epoch, resultArray, context);
+	}
+}
+
+void dph::EphemerisRelease::calculateOther(unsigned calculationResult,
+	unsigned otherItem, const Epoch& epoch, double* resultArray) const
+{
+	calculateOther(calculationResult, otherItem, epoch, resultArray, m_context);
+}
+
+void dph::EphemerisRelease::calculateOther(unsigned calculationResult,
+	unsigned otherItem, const Epoch& epoch, double* resultArray, 
+		CalculationContext& context) const
+{
+	// Допустимые значения параметров:
+	// -------------------------------
+	//	- calculationResult:
+	//		1 - Получить оригинальное значение,
+	//		2 - Получить оригинальное значение и его (их) производные первого порядка.
+	//		Примечание: используй значения из dph::Calculate.
+	//	
+	//	- other Item:
+	//		----------------------------------------------------------------		
 	//		Индекс	Название
 	//		----------------------------------------------------------------
 	//		14		Земные нутации по долдготе и наклонению (модель IAU 1980)	
@@ -530,8 +1490,8 @@ void dph::EphemerisRelease::calculateOther(unsigned calculationResult,
 	//		----------------------------------------------------------------
 	//		Примечание: используй значения из dph::Other.
 	//
-	//	- JED:
-	//		JED должен принадлежать промежутку: [m_startDate : m_endDate].
+	//	- epoch:
+	//		Момент времени, подготовленный методом makeEpoch(...).
 	//
 	//	- resultArray:
 	//		От пользователя требуется знать, каков минимальный размер массива для 
@@ -550,7 +1510,11 @@ void dph::EphemerisRelease::calculateOther(unsigned calculationResult,
 	{
 		return;
 	}
-	else if (JED < m_startDate || JED > m_endDate)
+	else if (hasItem(otherItem) == false)
+	{
+		return;
+	}
+	else if (isEpochCorrect(epoch) == false)
 	{
 		return;
 	}
@@ -558,507 +1522,3030 @@ void dph::EphemerisRelease::calculateOther(unsigned calculationResult,
 	{
 		return;
 	}
+	else if (bindContext(context) == false)
+	{
+		return;
+	}
+	else if (prepareBlock(epoch, context) == false)
+	{
+		return;
+	}
 	else
 	{
-		calculateBaseItem(otherItem - 3, JED, calculationResult, resultArray);
+		calculateBaseItem(otherItem - 3, epoch, calculationResult, resultArray, context);
 	}
 }
 
-
-bool dph::EphemerisRelease::isReady() const
+void dph::EphemerisRelease::calculateOtherSeries(unsigned calculationResult,
+	unsigned otherItem, const double* JEDs, size_t count, double* resultArray) const
 {
-	return m_ready;
+	calculateOtherSeries(calculationResult, otherItem, JEDs, count, resultArray, 
+		m_context);
 }
 
-double dph::EphemerisRelease::startDate() const
+void dph::EphemerisRelease::calculateOtherSeries(unsigned calculationResult,
+	unsigned otherItem, const double* JEDs, size_t count, double* resultArray,
+		CalculationContext& context) const
 {
-	return m_startDate;
+	//Условия недопустимые для данного метода:
+	if (this->m_ready == false)
+	{
+		return;
+	}
+	else if (calculationResult > 1)
+	{
+		return;
+	}
+	else if (otherItem < 14 || otherItem > 17)
+	{
+		return;
+	}
+	else if (hasItem(otherItem) == false)
+	{
+		return;
+	}
+	else if (JEDs == NULL || resultArray == NULL || count == 0)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (JEDs[i] < m_startDate || JEDs[i] > m_endDate)
+		{
+			return;
+		}
+	}
+
+	if (bindContext(context) == false)
+	{
+		return;
+	}
+
+	// Даты всех затрагиваемых блоков проверяются до начала вычислений 
+	// (Validation::LAZY):
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (checkBlockOnce(blockIndexOf(JEDs[i]), context) == false)
+		{
+			return;
+		}
+	}
+
+	// Количество значений элемента (см. calculateBaseItem(...)):
+	unsigned componentsCount = otherItem == Other::EARTH_NUTATIONS ? 2 : 
+		otherItem == Other::TTmTDB ? 1 : 3;
+
+	if (calculationResult == Calculate::STATE)
+	{
+		componentsCount *= 2;
+	}
+
+	calculateSeries(calculationResult, otherItem, 0, JEDs, count, componentsCount,
+		resultArray, context);
 }
 
-double dph::EphemerisRelease::endDate() const
+void dph::EphemerisRelease::calculateApparent(unsigned correction,
+	unsigned targetBody, unsigned observerBody, double JED,
+		double* resultArray) const
 {
-	return m_endDate;
+	calculateApparent(correction, targetBody, observerBody, JED, resultArray, m_context);
 }
 
-uint32_t dph::EphemerisRelease::releaseIndex() const
+void dph::EphemerisRelease::calculateApparent(unsigned correction,
+	unsigned targetBody, unsigned observerBody, double JED, double* resultArray,
+		CalculationContext& context) const
 {
-	return m_releaseIndex;
+	calculateApparentBodies(correction, &targetBody, 1, observerBody, JED, resultArray,
+		context);
 }
 
-const std::string& dph::EphemerisRelease::releaseLabel() const
+void dph::EphemerisRelease::calculateApparentBodies(unsigned correction,
+	const unsigned* targetBodies, size_t count, unsigned observerBody, double JED,
+		double* resultArray) const
 {
-	return m_releaseLabel;
+	calculateApparentBodies(correction, targetBodies, count, observerBody, JED,
+		resultArray, m_context);
 }
 
-double dph::EphemerisRelease::constant(const std::string& constantName) const
+void dph::EphemerisRelease::calculateApparentBodies(unsigned correction,
+	const unsigned* targetBodies, size_t count, unsigned observerBody, double JED,
+		double* resultArray, CalculationContext& context) const
 {
-	if (m_ready == false)
+	//Условия недопустимые для данного метода:
+	if (this->m_ready == false)
 	{
-		return 0.0;
+		return;
 	}
-	else if (constantName == "AU")
+	else if (correction > Correction::ABERRATION)
 	{
-		return m_au;
+		return;
 	}
-	else if (constantName == "EMRAT")
+	else if (observerBody == 0 || observerBody > 13 || hasItem(observerBody) == false)
 	{
-		return m_emrat;
+		return;
 	}
-	else if (constantName == "DENUM")
+	else if (JED < m_startDate || JED > m_endDate)
 	{
-		return m_releaseIndex;
+		return;
 	}
-	else
+	else if (targetBodies == NULL || resultArray == NULL || count == 0)
 	{
-		return m_constants.find(constantName)->second;
+		return;
 	}
-}
 
-std::string dph::EphemerisRelease::cutBackSpaces(const char* charArray, size_t arraySize)
-{
-	for (size_t i = arraySize - 1; i > 0; --i)
+	for (size_t i = 0; i < count; ++i)
 	{
-		if (charArray[i] == ' ' && charArray[i - 1] != ' ')
+		if (targetBodies[i] == 0 || targetBodies[i] > 13 || hasItem(targetBodies[i]) == false)
 		{
-			return std::string(charArray, i);
+			return;
 		}
 	}
 
-	return std::string(charArray, arraySize);
-}
-
-void dph::EphemerisRelease::clear()
-{
-	m_ready = false;
-
-	m_binaryFilePath.clear();
-	m_binaryFileStream.close();
-
-	m_releaseLabel.clear();
-	m_releaseIndex = 0;
-	m_startDate = 0.0;
-	m_endDate = 0.0;
-	m_blockTimeSpan = 0.0;
-	std::memset(m_keys, 0, sizeof(m_keys));
-	m_au = 0.0;
-	m_emrat = 0.0;
-	std::map<std::string, double>().swap(m_constants);	// SWAP TRICK
+	// Момент времени (параметры проверены выше):
+	Epoch epoch;
 
-	m_blocksCount = 0;
-	m_ncoeff = 0;
-	m_dimensionFit = 0;
-	m_blockSize_bytes = 0;
+	setEpoch(JED, epoch);
 
-	std::vector<double>().swap(m_buffer);	// SWAP TRICK
-	std::vector<double>(1).swap(m_poly);		// SWAP TRICK
-	std::vector<double>(2).swap(m_dpoly);	// SWAP TRICK
+	if (bindContext(context) == false)
+	{
+		return;
+	}
+	else if (prepareBlock(epoch, context) == false)
+	{
+		return;
+	}
 
-	m_poly[0]  = 1;
-	m_dpoly[0] = 0;
-	m_dpoly[1] = 1;
-}
+	// Состояние наблюдателя относительно барицентра СС (скорость нужна только
+	// для аберрации):
+	double observerState[6] = {0, 0, 0, 0, 0, 0};
 
-void dph::EphemerisRelease::copyHere(const EphemerisRelease& other)
-{
-	// Используется в:
-	//	- Конструктор копирования.
-	//	- Оператор копирования.
-	
-	m_ready = other.m_ready;
+	calculateBaseBody(observerBody, epoch, correction == Correction::ABERRATION ?
+		Calculate::STATE : Calculate::POSITION, observerState, context);
 
-	m_binaryFilePath	= other.m_binaryFilePath;
+	// Результаты записываются только после вычисления для всех тел:
+	double singleResult[4];
+	std::vector<double> results;
 
-	m_binaryFileStream.close();
-	m_binaryFileStream.open(other.m_binaryFilePath.c_str(), std::ios::binary);
+	if (count > 1)
+	{
+		results.resize(count * 4);
+	}
 
-	m_releaseLabel =	other.m_releaseLabel;
-	m_releaseIndex =	other.m_releaseIndex;
-	m_startDate =		other.m_startDate;
-	m_endDate =			other.m_endDate;
-	m_blockTimeSpan =	other.m_blockTimeSpan;
-	std::memcpy(m_keys, other.m_keys, sizeof(m_keys));
-	m_au =				other.m_au;
-	m_emrat =			other.m_emrat;
-	m_constants =		other.m_constants;
+	double* bodiesResult = count > 1 ? &results[0] : singleResult;
 
-	m_blocksCount =		other.m_blocksCount;
-	m_ncoeff =			other.m_ncoeff;
-	m_emrat2 =			other.m_emrat2;
-	m_dimensionFit =	other.m_dimensionFit;
-	m_blockSize_bytes = other.m_blockSize_bytes;
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (calculateApparentBody(correction, targetBodies[i], JED, observerState,
+			bodiesResult + i * 4, context) == false)
+		{
+			return;
+		}
+	}
 
-	m_buffer =	other.m_buffer;
-	m_poly =	other.m_poly;
-	m_dpoly =	other.m_poly;
+	std::memcpy(resultArray, bodiesResult, count * 4 * sizeof(double));
 }
 
-void dph::EphemerisRelease::readAndPackData()
+void dph::EphemerisRelease::calculateBodies(unsigned calculationResult, 
+	const unsigned* targetBodies, size_t count, unsigned centerBody, double JED, 
+		double* resultArray) const
 {
-	// Буфферы для чтения информации из файла:
-	char	releaseLabel_buffer[RLS_LABELS_COUNT][RLS_LABEL_SIZE];	// Строк. инф. о выпуске.
-	char	constantsNames_buffer[CCOUNT_MAX_NEW][CNAME_SIZE];		// Имена констант.
-	double	constantsValues_buffer[CCOUNT_MAX_NEW];					// Значения констант.
-	
-	// Количество констант в файле эфемерид:
-	uint32_t constantsCount;
-	// ------------------------------------- Чтение файла ------------------------------------- //
-
-	m_binaryFileStream.seekg(0, std::ios::beg);
-	m_binaryFileStream.read((char*)&releaseLabel_buffer, RLS_LABEL_SIZE * RLS_LABELS_COUNT);
-	m_binaryFileStream.read((char*)&constantsNames_buffer, CNAME_SIZE * CCOUNT_MAX_OLD);
-	m_binaryFileStream.read((char*)&m_startDate, 8);
-	m_binaryFileStream.read((char*)&m_endDate, 8);
-	m_binaryFileStream.read((char*)&m_blockTimeSpan, 8);
-	m_binaryFileStream.read((char*)&constantsCount, 4);
-	m_binaryFileStream.read((char*)&m_au, 8);
-	m_binaryFileStream.read((char*)&m_emrat, 8);
-	m_binaryFileStream.read((char*)&m_keys, (12 * 3) * 4);
-	m_binaryFileStream.read((char*)&m_releaseIndex, 4);
-	m_binaryFileStream.read((char*)&m_keys[12], (3) * 4);	
+	calculateBodies(calculationResult, targetBodies, count, centerBody, JED, 
+		resultArray, m_context);
+}
 
-	// Чтение дополнительных констант:
-	if (constantsCount > 400)
+void dph::EphemerisRelease::calculateBodies(unsigned calculationResult, 
+	const unsigned* targetBodies, size_t count, unsigned centerBody, double JED, 
+		double* resultArray, CalculationContext& context) const
+{
+	//Условия недопустимые для данного метода:
+	if (this->m_ready == false)
 	{
-		// Количество дополнительных констант:
-		size_t extraConstantsCount = constantsCount - CCOUNT_MAX_OLD;
-
-		m_binaryFileStream.read((char*)&constantsNames_buffer[CCOUNT_MAX_OLD], 
-			extraConstantsCount * CNAME_SIZE);
-	}		
-
-	// Чтение дополнительных ключей:
-	m_binaryFileStream.read((char*)&m_keys[13], (3 * 2) * 4);
-
-	// Подсчёт ncoeff (количество коэффициентов в блоке):
-	m_ncoeff = 2;
-	for (int i = 0; i < 15; ++i)
+		return;
+	}
+	else if (calculationResult > 1)
 	{
-		// Количество компонент для выбранного элемента:
-		int comp = i == 11 ? 2 : i == 14 ? 1 : 3;
-		m_ncoeff += comp * m_keys[i][1] * m_keys[i][2];
+		return;
 	}
-
-	// Переход к блоку с константами и их чтение:	
-	if (constantsCount <= CCOUNT_MAX_NEW)
+	else if (centerBody == 0 || centerBody > 13)
 	{
-		m_binaryFileStream.seekg(m_ncoeff * 8, std::ios::beg);
-		m_binaryFileStream.read((char*)&constantsValues_buffer, constantsCount * 8);
+		return;
 	}
-	
-
-	// -------------------- Форматирование и упаковка считанной информации --------------------- // 
-	
-	// Формирование строк общей информации о выпуске:
-	for (size_t i = 0; i < RLS_LABELS_COUNT; ++i)
+	else if (hasItem(centerBody) == false)
 	{
-		m_releaseLabel += cutBackSpaces(releaseLabel_buffer[i], RLS_LABEL_SIZE);
-		m_releaseLabel += '\n';
+		return;
+	}
+	else if (JED < m_startDate || JED > m_endDate)
+	{
+		return;
+	}
+	else if (targetBodies == NULL || resultArray == NULL || count == 0)
+	{
+		return;
 	}
-	m_releaseLabel;
 
-	// Заполнение контейнера m_constants именами и значениями констант:
-	if (constantsCount > 0 && constantsCount <= CCOUNT_MAX_NEW)
+	for (size_t i = 0; i < count; ++i)
 	{
-		for (uint32_t i = 0; i < constantsCount; ++i)
+		if (targetBodies[i] == 0 || targetBodies[i] > 13 || hasItem(targetBodies[i]) == false)
 		{
-			std::string constantName = cutBackSpaces(constantsNames_buffer[i], CNAME_SIZE);
-			m_constants[constantName] = constantsValues_buffer[i];
+			return;
 		}
 	}
 
-	// Дополнительные вычисления:
-	additionalCalculations();
-}
+	// Момент времени (параметры проверены выше):
+	Epoch epoch;
 
-void dph::EphemerisRelease::additionalCalculations()
-{
-	// Определение доп. коэффициентов для работы с ежегодником:
-	m_emrat2 = 1 / (1 + m_emrat);
-	m_dimensionFit = 1 / (43200 * m_blockTimeSpan);
+	setEpoch(JED, epoch);
 
-	// Определение количества блоков в ежегоднике:
+	if (bindContext(context) == false)
+	{
+		return;
+	}
+	else if (prepareBlock(epoch, context) == false)
+	{
+		return;
+	}
+
+	// Количество требуемых компонент:
+	unsigned componentsCount = calculationResult == Calculate::STATE ? 6 : 3;
+
+	// Значения базовых элементов, вычисленных в ходе вызова:
+	double itemValues[15][6];
+	bool isCalculated[15] = { false };
+
+	// Вектор центрального тела относительно барицентра СС (вычисляется один
+	// раз, при первой необходимости):
+	double centerBodyArray[6] = { 0.0 };
+	bool isCenterCalculated = false;
+
+	for (size_t k = 0; k < count; ++k)
+	{
+		unsigned targetBody = targetBodies[k];
+		double* result = resultArray + k * componentsCount;
+
+		// Выбор методики вычисления повторяет calculateBody(...):
+		if (targetBody == centerBody)
+		{
+			std::memset(result, 0, sizeof(double) * componentsCount);
+		}
+		else if (targetBody * centerBody == 30 && targetBody + centerBody == 13)
+		{
+			// Земля и Луна: вектор Луны относительно Земли (элемент #9).
+			const double* MoonRelativeEarth = calculateBaseItemOnce(9, epoch, 
+				calculationResult, itemValues, isCalculated, context);
+
+			for (unsigned i = 0; i < componentsCount; ++i)
+			{
+				result[i] = targetBody == Body::EARTH ? -MoonRelativeEarth[i] : 
+					MoonRelativeEarth[i];
+			}
+		}
+		else
+		{
+			if (centerBody != Body::SSBARY && isCenterCalculated == false)
+			{
+				calculateBaseBodyOnce(centerBody, epoch, calculationResult, centerBodyArray,
+					itemValues, isCalculated, context);
+
+				isCenterCalculated = true;
+			}
+
+			if (targetBody == Body::SSBARY)
+			{
+				// "Зеркальный" вектор центрального тела:
+				for (unsigned i = 0; i < componentsCount; ++i)
+				{
+					result[i] = -centerBodyArray[i];
+				}
+			}
+			else
+			{
+				calculateBaseBodyOnce(targetBody, epoch, calculationResult, result,
+					itemValues, isCalculated, context);
+
+				// Разница между вектором центрального и искомого тела:
+				if (centerBody != Body::SSBARY)
+				{
+					for (unsigned i = 0; i < componentsCount; ++i)
+					{
+						result[i] -= centerBodyArray[i];
+					}
+				}
+			}
+		}
+	}
+}
+
+void dph::EphemerisRelease::calculateBodySeries(unsigned calculationResult,
+	unsigned targetBody, unsigned centerBody, const double* JEDs, size_t count,
+		double* resultArray) const
+{
+	calculateBodySeries(calculationResult, targetBody, centerBody, JEDs, count, 
+		resultArray, m_context);
+}
+
+void dph::EphemerisRelease::calculateBodySeries(unsigned calculationResult,
+	unsigned targetBody, unsigned centerBody, const double* JEDs, size_t count,
+		double* resultArray, CalculationContext& context) const
+{
+	//Условия недопустимые для данного метода:
+	if (this->m_ready == false)
+	{
+		return;
+	}
+	else if (calculationResult > 1)
+	{
+		return;
+	}
+	else if (targetBody == 0 || centerBody == 0)
+	{
+		return;
+	}
+	else if (targetBody > 13 || centerBody > 13)
+	{
+		return;
+	}
+	else if (hasItem(targetBody) == false || hasItem(centerBody) == false)
+	{
+		return;
+	}
+	else if (JEDs == NULL || resultArray == NULL || count == 0)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (JEDs[i] < m_startDate || JEDs[i] > m_endDate)
+		{
+			return;
+		}
+	}
+
+	if (bindContext(context) == false)
+	{
+		return;
+	}
+
+	// Даты всех затрагиваемых блоков проверяются до начала вычислений 
+	// (Validation::LAZY):
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (checkBlockOnce(blockIndexOf(JEDs[i]), context) == false)
+		{
+			return;
+		}
+	}
+
+	// Количество требуемых компонент:
+	unsigned componentsCount = calculationResult == Calculate::STATE ? 6 : 3;
+
+	calculateSeries(calculationResult, targetBody, centerBody, JEDs, count, 
+		componentsCount, resultArray, context);
+}
+void dph::EphemerisRelease::calculateBodySeries(unsigned calculationResult,
+	unsigned targetBody, unsigned centerBody, double startJED, double step, 
+		size_t count, double* resultArray) const
+{
+	calculateBodySeries(calculationResult, targetBody, centerBody, startJED, step, 
+		count, resultArray, m_context);
+}
+
+void dph::EphemerisRelease::calculateBodySeries(unsigned calculationResult,
+	unsigned targetBody, unsigned centerBody, double startJED, double step, 
+		size_t count, double* resultArray, CalculationContext& context) const
+{
+	//Условия недопустимые для данного метода:
+	if (this->m_ready == false)
+	{
+		return;
+	}
+	else if (calculationResult > 1)
+	{
+		return;
+	}
+	else if (targetBody == 0 || centerBody == 0)
+	{
+		return;
+	}
+	else if (targetBody > 13 || centerBody > 13)
+	{
+		return;
+	}
+	else if (hasItem(targetBody) == false || hasItem(centerBody) == false)
+	{
+		return;
+	}
+	else if (resultArray == NULL || count == 0)
+	{
+		return;
+	}
+
+	// Ряд монотонный, поэтому достаточно проверить крайние моменты времени:
+	double lastJED = startJED + (count - 1) * step;
+
+	if (startJED < m_startDate || startJED > m_endDate)
+	{
+		return;
+	}
+	else if (lastJED < m_startDate || lastJED > m_endDate)
+	{
+		return;
+	}
+	else if (bindContext(context) == false)
+	{
+		return;
+	}
+
+	// Даты всех затрагиваемых блоков проверяются до начала вычислений 
+	// (Validation::LAZY):
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (checkBlockOnce(blockIndexOf(startJED + i * step), context) == false)
+		{
+			return;
+		}
+	}
+
+	// Количество требуемых компонент:
+	unsigned componentsCount = calculationResult == Calculate::STATE ? 6 : 3;
+
+	// Пакет моментов времени:
+	double chunkJEDs[SERIES_CHUNK_SIZE];
+
+	for (size_t first = 0; first < count; )
+	{
+		// Формирование пакета из моментов времени одного блока:
+		size_t chunkSize = 0;
+		size_t chunkBlock = blockIndexOf(startJED + first * step);
+
+		while (first + chunkSize < count && chunkSize < SERIES_CHUNK_SIZE)
+		{
+			double JED = startJED + (first + chunkSize) * step;
+
+			if (blockIndexOf(JED) != chunkBlock)
+			{
+				break;
+			}
+
+			chunkJEDs[chunkSize] = JED;
+			++chunkSize;
+		}
+
+		// Моменты времени идут подряд, поэтому результаты записываются сразу 
+		// в итоговый массив (если блок не удалось загрузить, вычисления 
+		// прерываются):
+		if (calculateBodyChunk(calculationResult, targetBody, centerBody, chunkJEDs, 
+			chunkSize, resultArray + first * componentsCount, context) == false)
+		{
+			return;
+		}
+
+		first += chunkSize;
+	}
+}
+
+bool dph::EphemerisRelease::calculateBodySeriesParallel(unsigned calculationResult,
+	unsigned targetBody, unsigned centerBody, const double* JEDs, size_t count,
+		double* resultArray, unsigned threadsCount) const
+{
+	//Условия недопустимые для данного метода:
+	if (this->m_ready == false)
+	{
+		return false;
+	}
+	else if (calculationResult > 1)
+	{
+		return false;
+	}
+	else if (targetBody == 0 || centerBody == 0)
+	{
+		return false;
+	}
+	else if (targetBody > 13 || centerBody > 13)
+	{
+		return false;
+	}
+	else if (hasItem(targetBody) == false || hasItem(centerBody) == false)
+	{
+		return false;
+	}
+	else if (JEDs == NULL || resultArray == NULL || count == 0)
+	{
+		return false;
+	}
+
+	if (threadsCount == 0)
+	{
+		threadsCount = Thread::hardwareConcurrency();
+	}
+
+	// Контекст первого исполнителя (вызывающий поток). Остальные исполнители
+	// создают контексты в своих потоках при подготовке:
+	CalculationContext context;
+
+	if (bindContext(context) == false)
+	{
+		return false;
+	}
+
+	// Размер части: не менее PARALLEL_UNIT_MIN_SIZE моментов времени, около
+	// PARALLEL_UNITS_PER_THREAD частей на поток:
+	size_t unitSize = count / (size_t(threadsCount) * PARALLEL_UNITS_PER_THREAD);
+
+	if (unitSize < PARALLEL_UNIT_MIN_SIZE)
+	{
+		unitSize = PARALLEL_UNIT_MIN_SIZE;
+	}
+
+	size_t unitsCount = (count + unitSize - 1) / unitSize;
+
+	// Потоков не больше, чем частей:
+	unsigned workersCount = unitsCount < threadsCount ? 
+		static_cast<unsigned>(unitsCount) : threadsCount;
+
+	WorkQueue queue(unitsCount, workersCount);
+
+	// Буферы номеров блоков и упорядоченных моментов заполняются 
+	// исполнителями (без предварительного обнуления в вызывающем потоке):
+	size_t* blocks = new size_t[count];
+	size_t* order = NULL;
+	size_t* counts = NULL;
+
+	ParallelSeries series;
+	series.release = this;
+	series.calculationResult = calculationResult;
+	series.targetBody = targetBody;
+	series.centerBody = centerBody;
+	series.JEDs = JEDs;
+	series.count = count;
+	series.componentsCount = calculationResult == Calculate::STATE ? 6 : 3;
+	series.resultArray = resultArray;
+	series.workersCount = workersCount;
+	series.blocks = blocks;
+	series.order = NULL;
+	series.firstBlock = 0;
+	series.blocksWidth = 0;
+	series.sortersCount = 0;
+	series.counts = NULL;
+	series.segmentStarts = NULL;
+	series.unitSize = unitSize;
+	series.queue = &queue;
+
+	std::vector<ParallelWorker> workers(workersCount);
+	std::vector<void*> arguments(workersCount);
+
+	for (unsigned i = 0; i < workersCount; ++i)
+	{
+		workers[i].series = &series;
+		workers[i].index = i;
+		workers[i].context = i == 0 ? &context : NULL;
+		workers[i].isRejected = false;
+		workers[i].isOrdered = true;
+		workers[i].headBlock = 0;
+		workers[i].tailBlock = 0;
+		workers[i].minBlock = 0;
+		workers[i].maxBlock = 0;
+		workers[i].isFailed = false;
+
+		arguments[i] = &workers[i];
+	}
+
+	// Первый исполнитель работает в вызывающем потоке, остальные - в потоках
+	// пула (см. примечание 2 к методу). Подготовка:
+	ThreadPool::shared().run(prepareParallelSlice, &arguments[0], workersCount);
+
+	bool isRejected = false;
+	bool isOrdered = true;
+	size_t minBlock = workers[0].minBlock;
+	size_t maxBlock = workers[0].maxBlock;
+
+	for (unsigned i = 0; i < workersCount; ++i)
+	{
+		const ParallelWorker& worker = workers[i];
+
+		isRejected = isRejected || worker.isRejected;
+		isOrdered = isOrdered && worker.isOrdered && 
+			(i == 0 || workers[i - 1].tailBlock <= worker.headBlock);
+
+		minBlock = worker.minBlock < minBlock ? worker.minBlock : minBlock;
+		maxBlock = worker.maxBlock > maxBlock ? worker.maxBlock : maxBlock;
+	}
+
+	// Даты блоков долей, исполнителям которых не удалось создать контекст,
+	// проверяются в вызывающем потоке:
+	for (unsigned i = 1; i < workersCount && isRejected == false; ++i)
+	{
+		if (workers[i].context != NULL)
+		{
+			continue;
+		}
+
+		size_t last = sliceStart(count, i + 1, workersCount);
+
+		for (size_t j = sliceStart(count, i, workersCount); j < last; ++j)
+		{
+			if (checkBlockOnce(blocks[j], context) == false)
+			{
+				isRejected = true;
+
+				break;
+			}
+		}
+	}
+
+	// Упорядочивание моментов времени по блокам (сортировка подсчётом):
+	std::vector<size_t> segmentStarts;
+
+	if (isRejected == false && isOrdered == false)
+	{
+		series.firstBlock = minBlock;
+		series.blocksWidth = maxBlock - minBlock + 1;
+
+		// Исполнителей сортировки не больше, чем моментов времени на блок
+		// ряда (объём гистограмм не превышает объёма ряда):
+		size_t sortersCount = count / series.blocksWidth;
+
+		if (sortersCount < 1)
+		{
+			sortersCount = 1;
+		}
+		else if (sortersCount > workersCount)
+		{
+			sortersCount = workersCount;
+		}
+
+		order = new size_t[count];
+		counts = new size_t[sortersCount * series.blocksWidth];
+		segmentStarts.resize(sortersCount);
+
+		series.order = order;
+		series.sortersCount = static_cast<unsigned>(sortersCount);
+		series.counts = counts;
+		series.segmentStarts = &segmentStarts[0];
+
+		ThreadPool::shared().run(countParallelSlice, &arguments[0], series.sortersCount);
+		ThreadPool::shared().run(sumParallelSegment, &arguments[0], series.sortersCount);
+
+		// Начала отрезков блоков (префиксная сумма по отрезкам):
+		size_t start = 0;
+
+		for (size_t s = 0; s < sortersCount; ++s)
+		{
+			size_t segmentCount = segmentStarts[s];
+
+			segmentStarts[s] = start;
+			start += segmentCount;
+		}
+
+		ThreadPool::shared().run(offsetParallelSegment, &arguments[0], 
+			series.sortersCount);
+		ThreadPool::shared().run(scatterParallelSlice, &arguments[0], 
+			series.sortersCount);
+	}
+
+	// Вычисление частей ряда:
+	if (isRejected == false)
+	{
+		ThreadPool::shared().run(runParallelWorker, &arguments[0], workersCount);
+	}
+
+	bool isCalculated = isRejected == false;
+
+	for (unsigned i = 0; i < workersCount; ++i)
+	{
+		isCalculated = isCalculated && workers[i].isFailed == false;
+
+		if (i != 0)
+		{
+			delete workers[i].context;
+		}
+	}
+
+	delete[] counts;
+	delete[] order;
+	delete[] blocks;
+
+	return isCalculated;
+}
+
+bool dph::EphemerisRelease::isReady() const
+{
+	return m_ready;
+}
+
+double dph::EphemerisRelease::startDate() const
+{
+	return m_startDate;
+}
+
+double dph::EphemerisRelease::endDate() const
+{
+	return m_endDate;
+}
+
+double dph::EphemerisRelease::blockTimeSpan() const
+{
+	return m_blockTimeSpan;
+}
+
+uint32_t dph::EphemerisRelease::releaseIndex() const
+{
+	return m_releaseIndex;
+}
+
+const std::string& dph::EphemerisRelease::releaseLabel() const
+{
+	return m_releaseLabel;
+}
+
+double dph::EphemerisRelease::constant(const std::string& constantName) const
+{
+	if (m_ready == false)
+	{
+		return 0.0;
+	}
+	else if (constantName == "AU")
+	{
+		return m_au;
+	}
+	else if (constantName == "EMRAT")
+	{
+		return m_emrat;
+	}
+	else if (constantName == "DENUM")
+	{
+		return m_releaseIndex;
+	}
+	else
+	{
+		return constantAt(constantIndex(constantName));
+	}
+}
+
+size_t dph::EphemerisRelease::constantsCount() const
+{
+	return m_ready ? m_core->constantsValues.size() : 0;
+}
+
+const double* dph::EphemerisRelease::constantsValues() const
+{
+	return constantsCount() == 0 ? NULL : &m_core->constantsValues[0];
+}
+
+std::string dph::EphemerisRelease::constantName(size_t constantIndex) const
+{
+	return constantIndex < constantsCount() ? m_core->constantsNames[constantIndex] :
+		std::string();
+}
+
+size_t dph::EphemerisRelease::constantIndex(const std::string& constantName) const
+{
+	if (m_ready == false)
+	{
+		return NO_CONSTANT;
+	}
+
+	std::map<std::string, size_t>::const_iterator it = 
+		m_core->constantsIndex.find(constantName);
+
+	if (it == m_core->constantsIndex.end())
+	{
+		return NO_CONSTANT;
+	}
+
+	return it->second;
+}
+
+double dph::EphemerisRelease::constantAt(size_t constantIndex) const
+{
+	return constantIndex < constantsCount() ? m_core->constantsValues[constantIndex] : 
+		0.0;
+}
+
+unsigned dph::EphemerisRelease::accessMode() const
+{
+	return m_accessMode;
+}
+
+bool dph::EphemerisRelease::isPacked() const
+{
+	return m_packed;
+}
+
+bool dph::EphemerisRelease::hugePages() const
+{
+	return m_core->loadedFile.hugePages();
+}
+
+unsigned dph::EphemerisRelease::instructionSet() const
+{
+	return m_instructionSet;
+}
+
+unsigned dph::EphemerisRelease::validation() const
+{
+	return m_validation;
+}
+
+size_t dph::EphemerisRelease::cacheBlocksCount() const
+{
+	return m_cacheBlocksCount;
+}
+
+unsigned dph::EphemerisRelease::prefetchBlocksCount() const
+{
+	return m_prefetchBlocksCount;
+}
+
+unsigned long dph::EphemerisRelease::items() const
+{
+	return m_items;
+}
+
+bool dph::EphemerisRelease::hasItem(unsigned item) const
+{
+	// Барицентр Солнечной Системы не требует коэффициентов:
+	if (item == Body::SSBARY)
+	{
+		return m_ready;
+	}
+
+	uint32_t baseItems = baseItemsOf(item);
+
+	return m_ready && baseItems != 0 && (m_residentItems & baseItems) == baseItems;
+}
+
+uint64_t dph::EphemerisRelease::cacheHits() const
+{
+	return m_context.cacheHits();
+}
+
+uint64_t dph::EphemerisRelease::cacheMisses() const
+{
+	return m_context.cacheMisses();
+}
+
+uint64_t dph::EphemerisRelease::cacheEvictions() const
+{
+	return m_context.cacheEvictions();
+}
+
+void dph::EphemerisRelease::resetCacheCounters()
+{
+	m_context.resetCacheCounters();
+}
+
+dph::Statistics dph::EphemerisRelease::statistics() const
+{
+	return m_context.statistics();
+}
+
+void dph::EphemerisRelease::resetStatistics()
+{
+	m_context.resetStatistics();
+}
+
+std::string dph::EphemerisRelease::cutBackSpaces(const char* charArray, size_t arraySize)
+{
+	for (size_t i = arraySize - 1; i > 0; --i)
+	{
+		if (charArray[i] == ' ' && charArray[i - 1] != ' ')
+		{
+			return std::string(charArray, i);
+		}
+	}
+
+	return std::string(charArray, arraySize);
+}
+
+uint64_t dph::EphemerisRelease::nextGeneration()
+{
+	// Счётчик общий для всех объектов (статическая инициализация нулём):
+#if defined(_WIN32)
+	static volatile LONG64 generation = 0;
+
+	return static_cast<uint64_t>(InterlockedIncrement64(&generation));
+#elif defined(__GNUC__)
+	static volatile uint64_t generation = 0;
+
+	return __sync_add_and_fetch(&generation, uint64_t(1));
+#else
+	static uint64_t generation = 0;
+
+	return ++generation;
+#endif
+}
+
+void dph::EphemerisRelease::clear()
+{
+	m_ready = false;
+
+	m_binaryFilePath.clear();
+	m_binaryFileStream.close();
+	m_accessMode = Access::STREAM;
+	m_instructionSet = InstructionSet::SCALAR;
+	m_validation = Validation::FULL;
+	m_cacheSize_bytes = 0;
+	m_loadThreadsCount = 0;
+	m_hugePagesRequested = false;
+	m_prefetchBlocksCount = 0;
+
+	m_packed = false;
+	std::memset(&m_packedHeader, 0, sizeof(m_packedHeader));
+	std::memset(m_packedItems, 0, sizeof(m_packedItems));
+	std::memset(m_packedStrides, 0, sizeof(m_packedStrides));
+
+	m_items = 0;
+	m_residentItems = 0;
+	std::memset(m_residentRuns, 0, sizeof(m_residentRuns));
+	m_residentRunsCount = 0;
+	std::memset(m_residentOffsets, 0, sizeof(m_residentOffsets));
+	m_residentLength = 0;
+	m_compactImage = false;
+
+	m_releaseLabel.clear();
+	m_releaseIndex = 0;
+	m_startDate = 0.0;
+	m_endDate = 0.0;
+	m_blockTimeSpan = 0.0;
+	std::memset(m_keys, 0, sizeof(m_keys));
+	m_au = 0.0;
+	m_emrat = 0.0;
+
+	// Ядро, используемое другими объектами, не изменяется (объект получает
+	// новое пустое ядро):
+	if (m_core->isShared())
+	{
+		releaseCore();
+		m_core = new ReleaseCore;
+	}
+	else
+	{
+		m_core->clear();
+	}
+
+	m_blocksCount = 0;
+	m_ncoeff = 0;
+	m_dimensionFit = 0;
+	m_clight = 0;
+	m_blockSize_bytes = 0;
+	m_polynomsCount = 0;
+	m_cacheBlocksCount = 0;
+	std::memset(m_positionKernels, 0, sizeof(m_positionKernels));
+	std::memset(m_stateKernels, 0, sizeof(m_stateKernels));
+
+	// Контексты, привязанные к прежнему состоянию объекта, недействительны:
+	m_context.reset();
+	m_generation = nextGeneration();
+}
+
+void dph::EphemerisRelease::copyHere(const EphemerisRelease& other)
+{
+	// Используется в:
+	//	- Конструктор копирования.
+	//	- Оператор копирования.
+	//	- Конструктор и оператор перемещения.
+	
+	m_ready = other.m_ready;
+
+	m_binaryFilePath	= other.m_binaryFilePath;
+
+	// Поток нужен только для чтения и проверки файла (см. конструктор), 
+	// отображение (загруженный файл) и константы хранятся в ядре:
+	m_binaryFileStream.close();
+
+	m_loadThreadsCount =	other.m_loadThreadsCount;
+	m_hugePagesRequested =	other.m_hugePagesRequested;
+	m_prefetchBlocksCount =	other.m_prefetchBlocksCount;
+
+	// Указатели на коэффициенты остаются действительными: ядро (и отображение
+	// файла) разделяется между объектами.
+	m_packed = other.m_packed;
+	std::memcpy(&m_packedHeader, &other.m_packedHeader, sizeof(m_packedHeader));
+	std::memcpy(m_packedItems, other.m_packedItems, sizeof(m_packedItems));
+	std::memcpy(m_packedStrides, other.m_packedStrides, sizeof(m_packedStrides));
+
+	m_items =				other.m_items;
+	m_residentItems =		other.m_residentItems;
+	std::memcpy(m_residentRuns, other.m_residentRuns, sizeof(m_residentRuns));
+	m_residentRunsCount =	other.m_residentRunsCount;
+	std::memcpy(m_residentOffsets, other.m_residentOffsets, sizeof(m_residentOffsets));
+	m_residentLength =		other.m_residentLength;
+	m_compactImage =		other.m_compactImage;
+
+	m_accessMode =		other.m_accessMode;
+	m_instructionSet =	other.m_instructionSet;
+	m_validation =		other.m_validation;
+	m_cacheSize_bytes =	other.m_cacheSize_bytes;
+
+	m_releaseLabel =	other.m_releaseLabel;
+	m_releaseIndex =	other.m_releaseIndex;
+	m_startDate =		other.m_startDate;
+	m_endDate =			other.m_endDate;
+	m_blockTimeSpan =	other.m_blockTimeSpan;
+	std::memcpy(m_keys, other.m_keys, sizeof(m_keys));
+	m_au =				other.m_au;
+	m_emrat =			other.m_emrat;
+
+	m_blocksCount =		other.m_blocksCount;
+	m_ncoeff =			other.m_ncoeff;
+	m_emrat2 =			other.m_emrat2;
+	m_dimensionFit =	other.m_dimensionFit;
+	m_clight =			other.m_clight;
+	m_blockSize_bytes = other.m_blockSize_bytes;
+	m_polynomsCount =	other.m_polynomsCount;
+	m_cacheBlocksCount = other.m_cacheBlocksCount;
+	std::memcpy(m_positionKernels, other.m_positionKernels, sizeof(m_positionKernels));
+	std::memcpy(m_stateKernels, other.m_stateKernels, sizeof(m_stateKernels));
+
+	// Контекст будет подготовлен заново при первом вычислении:
+	m_context.reset();
+}
+
+void dph::EphemerisRelease::shareCore(ReleaseCore* core)
+{
+	// Ссылка добавляется до освобождения текущего ядра (ядра могут совпадать):
+	core->addReference();
+
+	releaseCore();
+
+	m_core = core;
+}
+
+void dph::EphemerisRelease::releaseCore()
+{
+	if (m_core->removeReference())
+	{
+		delete m_core;
+	}
+
+	m_core = NULL;
+}
+
+void dph::EphemerisRelease::readAndPackData()
+{
+	// Буфферы для чтения информации из файла:
+	char	releaseLabel_buffer[RLS_LABELS_COUNT][RLS_LABEL_SIZE];	// Строк. инф. о выпуске.
+	char	constantsNames_buffer[CCOUNT_MAX_NEW][CNAME_SIZE];		// Имена констант.
+	double	constantsValues_buffer[CCOUNT_MAX_NEW];					// Значения констант.
+	
+	// Количество констант в файле эфемерид:
+	uint32_t constantsCount;
+	// Смещение заголовка JPL (в упакованном файле заголовок JPL следует за 
+	// заголовком-индексом):
+	std::streamoff headerOffset = m_packed ? 
+		static_cast<std::streamoff>(m_packedHeader.jplHeaderOffset) : 0;
+
+	// ------------------------------------- Чтение файла ------------------------------------- //
+
+	m_binaryFileStream.seekg(headerOffset, std::ios::beg);
+	m_binaryFileStream.read((char*)&releaseLabel_buffer, RLS_LABEL_SIZE * RLS_LABELS_COUNT);
+	m_binaryFileStream.read((char*)&constantsNames_buffer, CNAME_SIZE * CCOUNT_MAX_OLD);
+	m_binaryFileStream.read((char*)&m_startDate, 8);
+	m_binaryFileStream.read((char*)&m_endDate, 8);
+	m_binaryFileStream.read((char*)&m_blockTimeSpan, 8);
+	m_binaryFileStream.read((char*)&constantsCount, 4);
+	m_binaryFileStream.read((char*)&m_au, 8);
+	m_binaryFileStream.read((char*)&m_emrat, 8);
+	m_binaryFileStream.read((char*)&m_keys, (12 * 3) * 4);
+	m_binaryFileStream.read((char*)&m_releaseIndex, 4);
+	m_binaryFileStream.read((char*)&m_keys[12], (3) * 4);	
+
+	// Чтение дополнительных констант:
+	if (constantsCount > 400)
+	{
+		// Количество дополнительных констант:
+		size_t extraConstantsCount = constantsCount - CCOUNT_MAX_OLD;
+
+		m_binaryFileStream.read((char*)&constantsNames_buffer[CCOUNT_MAX_OLD], 
+			extraConstantsCount * CNAME_SIZE);
+	}		
+
+	// Чтение дополнительных ключей:
+	m_binaryFileStream.read((char*)&m_keys[13], (3 * 2) * 4);
+
+	// Подсчёт ncoeff (количество коэффициентов в блоке):
+	m_ncoeff = 2;
+	for (int i = 0; i < 15; ++i)
+	{
+		// Количество компонент для выбранного элемента:
+		int comp = i == 11 ? 2 : i == 14 ? 1 : 3;
+		m_ncoeff += comp * m_keys[i][1] * m_keys[i][2];
+	}
+
+	// Переход к блоку с константами и их чтение:	
+	if (constantsCount <= CCOUNT_MAX_NEW)
+	{
+		m_binaryFileStream.seekg(headerOffset + m_ncoeff * 8, std::ios::beg);
+		m_binaryFileStream.read((char*)&constantsValues_buffer, constantsCount * 8);
+	}
+	
+
+	// -------------------- Форматирование и упаковка считанной информации --------------------- // 
+	
+	// Формирование строк общей информации о выпуске:
+	for (size_t i = 0; i < RLS_LABELS_COUNT; ++i)
+	{
+		m_releaseLabel += cutBackSpaces(releaseLabel_buffer[i], RLS_LABEL_SIZE);
+		m_releaseLabel += '\n';
+	}
+
+	// Заполнение таблицы констант именами и значениями констант. При 
+	// повторе имени индекс указывает на последнюю константу с этим именем:
+	if (constantsCount > 0 && constantsCount <= CCOUNT_MAX_NEW)
+	{
+		m_core->constantsNames.reserve(constantsCount);
+		m_core->constantsValues.reserve(constantsCount);
+
+		for (uint32_t i = 0; i < constantsCount; ++i)
+		{
+			std::string constantName = cutBackSpaces(constantsNames_buffer[i], CNAME_SIZE);
+
+			m_core->constantsIndex[constantName] = m_core->constantsNames.size();
+			m_core->constantsNames.push_back(constantName);
+			m_core->constantsValues.push_back(constantsValues_buffer[i]);
+		}
+	}
+
+	// Дополнительные вычисления:
+	additionalCalculations();
+}
+
+void dph::EphemerisRelease::additionalCalculations()
+{
+	// Определение доп. коэффициентов для работы с ежегодником:
+	m_emrat2 = 1 / (1 + m_emrat);
+	m_dimensionFit = 1 / (43200 * m_blockTimeSpan);
+
+	// Скорость света (км/с) для видимых положений (в выпусках DE - константа 
+	// CLIGHT):
+	std::map<std::string, size_t>::const_iterator clight = 
+		m_core->constantsIndex.find("CLIGHT");
+	m_clight = clight != m_core->constantsIndex.end() && 
+		m_core->constantsValues[clight->second] > 0 ? 
+			m_core->constantsValues[clight->second] : 299792.458;
+
+	// Определение количества блоков в ежегоднике:
 	m_blocksCount = size_t((m_endDate - m_startDate) / m_blockTimeSpan);
 
-	// Подсчёт максимального количества полиномов в выпуске:
-	size_t maxPolynomsCount = 0;
-	for (int i = 0; i < 15; ++i)
+	// Подсчёт максимального количества полиномов в выпуске (не менее трёх,
+	// см. interpolateState):
+	m_polynomsCount = 3;
+	for (int i = 0; i < 15; ++i)
+	{
+		if (m_keys[i][1] > m_polynomsCount)
+		{
+			m_polynomsCount = m_keys[i][1];
+		}			
+	}
+
+	// Определение размера блока в байтах:
+	m_blockSize_bytes = m_ncoeff * sizeof(double);
+
+	// Используемые элементы и их расположение в блоке:
+	arrangeResidentItems();
+
+	// Количество блоков в кэше контекста (не менее CACHE_BLOCKS_MIN и не 
+	// более количества блоков в файле). В кэше хранятся только используемые 
+	// элементы:
+	m_cacheBlocksCount = m_residentLength == 0 ? 1 : 
+		m_cacheSize_bytes / (m_residentLength * sizeof(double));
+
+	if (m_cacheBlocksCount < CACHE_BLOCKS_MIN)
+	{
+		m_cacheBlocksCount = CACHE_BLOCKS_MIN;
+	}
+
+	if (m_cacheBlocksCount > m_blocksCount)
+	{
+		m_cacheBlocksCount = m_blocksCount;
+	}
+
+	if (m_cacheBlocksCount == 0)
+	{
+		m_cacheBlocksCount = 1;
+	}
+
+	// Выбор шаблонных ядер интерполяции по набору инструкций, количеству
+	// коэффициентов и компонент каждого элемента:
+	for (unsigned i = 0; i < 15; ++i)
+	{
+		unsigned componentsCount = i == 11 ? 2 : i == 14 ? 1 : 3;
+
+		m_positionKernels[i] = Chebyshev::positionKernel(m_instructionSet, m_keys[i][1],
+			componentsCount);
+		m_stateKernels[i] = Chebyshev::stateKernel(m_instructionSet, m_keys[i][1],
+			componentsCount);
+	}
+
+	// Массивы коэффициентов элементов упакованного файла (границы массивов
+	// проверяются в isPackedDataCorrect(...)):
+	if (m_packed && m_accessMode != Access::STREAM)
+	{
+		size_t fileSize = m_accessMode == Access::MMAP ? m_core->mappedFile.size() :
+			m_core->loadedFile.size();
+
+		for (unsigned i = 0; i < 15; ++i)
+		{
+			uint64_t itemOffset = m_packedHeader.itemOffsets[i];
+
+			m_packedItems[i] = itemOffset == 0 || itemOffset >= fileSize ? NULL :
+				reinterpret_cast<const double*>(fileData() + itemOffset);
+			m_packedStrides[i] = static_cast<size_t>(m_packedHeader.itemStrides[i] / 
+				sizeof(double));
+		}
+	}
+}
+
+void dph::EphemerisRelease::arrangeResidentItems()
+{
+	// Запрошенные базовые элементы:
+	uint32_t requestedItems = m_items == 0 ? 0x7FFF : 0;
+
+	for (unsigned item = Body::MERCURY; item <= Other::TTmTDB && m_items != 0; ++item)
+	{
+		if ((m_items >> item) & 1)
+		{
+			requestedItems |= baseItemsOf(item);
+		}
+	}
+
+	// Участки блока (смещение и размер в double): даты блока и коэффициенты
+	// элементов, хранящихся в файле.
+	uint32_t ranges[16][2];
+	unsigned rangeItems[16];
+	unsigned rangesCount = 1;
+
+	ranges[0][0] = 0;
+	ranges[0][1] = 2;
+	rangeItems[0] = 15;
+
+	// Элемент-заполнитель записи файлов dph::BinaryWriter (индекс ячейки -
+	// константа FILLER) не хранит данных:
+	std::map<std::string, size_t>::const_iterator filler =
+		m_core->constantsIndex.find("FILLER");
+
+	if (filler != m_core->constantsIndex.end())
+	{
+		double fillerItem = m_core->constantsValues[filler->second];
+
+		if (fillerItem >= 0 && fillerItem < 15)
+		{
+			requestedItems &= ~(uint32_t(1) << static_cast<unsigned>(fillerItem));
+		}
+	}
+
+	m_residentItems = 0;
+
+	for (unsigned i = 0; i < 15; ++i)
+	{
+		unsigned componentsCount = i == 11 ? 2 : i == 14 ? 1 : 3;
+		uint32_t size = componentsCount * m_keys[i][1] * m_keys[i][2];
+
+		if (((requestedItems >> i) & 1) == 0 || size == 0 || m_keys[i][0] < 3 ||
+			m_keys[i][0] - 1 + size > m_ncoeff)
+		{
+			continue;
+		}
+
+		m_residentItems |= uint32_t(1) << i;
+
+		// Вставка участка по возрастанию смещения:
+		unsigned position = rangesCount;
+
+		while (position > 0 && ranges[position - 1][0] > m_keys[i][0] - 1)
+		{
+			ranges[position][0] = ranges[position - 1][0];
+			ranges[position][1] = ranges[position - 1][1];
+			rangeItems[position] = rangeItems[position - 1];
+			--position;
+		}
+
+		ranges[position][0] = m_keys[i][0] - 1;
+		ranges[position][1] = size;
+		rangeItems[position] = i;
+
+		++rangesCount;
+	}
+
+	// Смежные участки читаются вместе. Если коэффициенты копируются из файла 
+	// (Access::STREAM, Access::MEMORY), в памяти участки располагаются подряд:
+	bool isCompact = m_items != 0 && m_packed == false && m_accessMode == Access::STREAM;
+
+	m_residentRunsCount = 0;
+	m_residentLength = 0;
+	std::memset(m_residentOffsets, 0, sizeof(m_residentOffsets));
+
+	for (unsigned r = 0; r < rangesCount; ++r)
+	{
+		if (rangeItems[r] < 15)
+		{
+			m_residentOffsets[rangeItems[r]] = isCompact ? m_residentLength : 
+				ranges[r][0];
+		}
+
+		if (m_residentRunsCount != 0 && m_residentRuns[m_residentRunsCount - 1][0] + 
+			m_residentRuns[m_residentRunsCount - 1][1] == ranges[r][0])
+		{
+			m_residentRuns[m_residentRunsCount - 1][1] += ranges[r][1];
+		}
+		else
+		{
+			m_residentRuns[m_residentRunsCount][0] = ranges[r][0];
+			m_residentRuns[m_residentRunsCount][1] = ranges[r][1];
+			++m_residentRunsCount;
+		}
+
+		m_residentLength += ranges[r][1];
+	}
+
+	// Без выбора элементов блок читается и хранится целиком:
+	if (m_items == 0)
+	{
+		m_residentRuns[0][0] = 0;
+		m_residentRuns[0][1] = m_ncoeff;
+		m_residentRunsCount = 1;
+	}
+
+	if (isCompact == false)
+	{
+		m_residentLength = m_ncoeff;
+	}
+}
+
+uint32_t dph::EphemerisRelease::baseItemsOf(unsigned item)
+{
+	// Земля и Луна вычисляются по барицентру системы Земля-Луна и положению
+	// Луны относительно Земли (см. calculateBaseEarth(...)):
+	switch (item)
+	{
+	case Body::EARTH:
+	case Body::MOON:	return (uint32_t(1) << 2) | (uint32_t(1) << 9);
+	case Body::SSBARY:	return 0;
+	case Body::EMBARY:	return uint32_t(1) << 2;
+	}
+
+	if (item >= Body::MERCURY && item <= Body::SUN)
+	{
+		return uint32_t(1) << (item - 1);
+	}
+	else if (item >= Other::EARTH_NUTATIONS && item <= Other::TTmTDB)
+	{
+		return uint32_t(1) << (item - 3);
+	}
+
+	return 0;
+}
+
+bool dph::EphemerisRelease::loadResidentItems()
+{
+	LoadedFile::RecordSelection selection;
+
+	selection.recordSize = m_blockSize_bytes;
+	selection.rangesCount = m_residentRunsCount;
+
+	for (unsigned r = 0; r < m_residentRunsCount; ++r)
+	{
+		selection.ranges[r][0] = m_residentRuns[r][0] * sizeof(double);
+		selection.ranges[r][1] = m_residentRuns[r][1] * sizeof(double);
+	}
+
+	// Блоки следуют за заголовком и блоком констант:
+	m_compactImage = m_blockSize_bytes != 0 && m_blocksCount != 0 &&
+		m_core->loadedFile.loadRecords(m_binaryFilePath, 2 * m_blockSize_bytes, 
+			m_blocksCount, selection, m_loadThreadsCount, m_hugePagesRequested);
+
+	return m_compactImage;
+}
+
+bool dph::EphemerisRelease::isDataCorrect() const
+{
+	// В данном методе проверяются только те параметры, которые
+	// могут повлиять непосредственно на вычисления значений элементов, 
+	// хранящихся в выпуске эфемерид.	
+	
+	if (m_accessMode == Access::STREAM)
+	{
+		if (m_binaryFileStream.is_open() == false)		return false;	// Ошибка открытия файла.
+	}
+	else if (m_accessMode == Access::MMAP)
+	{
+		if (m_core->mappedFile.isOpen() == false)		return false;	// Ошибка отображения файла.
+	}
+	else
+	{
+		if (m_core->loadedFile.isOpen() == false)		return false;	// Ошибка загрузки файла.
+	}
+
+	if (m_startDate >= m_endDate)						return false;
+	if (m_blockTimeSpan == 0)							return false;
+	if ((m_endDate - m_startDate) < m_blockTimeSpan)	return false;
+	if (m_emrat == 0)									return false;
+	if (m_ncoeff == 0)									return false;
+
+	// Все блоки должны умещаться в файле:
+	size_t fileSize = m_accessMode == Access::MMAP ? m_core->mappedFile.size() : 
+		m_core->loadedFile.size();
+
+	if (m_accessMode == Access::STREAM)
+	{
+		m_binaryFileStream.seekg(0, std::ios::end);
+
+		std::streamoff streamSize = m_binaryFileStream.tellg();
+
+		if (streamSize < 0)								return false;	// Ошибка чтения файла.
+
+		fileSize = static_cast<size_t>(streamSize);
+	}
+
+	if (m_packed)
+	{
+		if (isPackedDataCorrect(fileSize) == false)	return false;
+	}
+	else if (m_compactImage)
+	{
+		if (fileSize / sizeof(double) / m_residentLength < m_blocksCount)	return false;
+	}
+	else if (fileSize / m_blockSize_bytes < m_blocksCount + 2)	return false;
+
+	if (check_blocksDates() == false)					return false;
+
+	return true;
+}
+
+bool dph::EphemerisRelease::check_blocksDates() const
+{
+	// При Validation::HEADER даты блоков не проверяются, при Validation::LAZY
+	// - проверяются при первой загрузке блока (см. fillBuffer(...)):
+	if (m_validation == Validation::HEADER || m_validation == Validation::LAZY)
+	{
+		return true;
+	}
+
+	// Шаг между проверяемыми блоками:
+	size_t step = 1;
+
+	if (m_validation == Validation::SAMPLED)
+	{
+		step = m_blocksCount / (Validation::SAMPLED_BLOCKS_COUNT + 1) + 1;
+	}
+
+	// Массив для чтения первых двух коэффициентов блока:
+	double blockDates[2] = {0.0, 0.0};
+
+	for (size_t blockIndex = 0; blockIndex < m_blocksCount; blockIndex += step)
+	{
+		if (readBlockDates(blockIndex, m_binaryFileStream, blockDates) == false ||
+			isBlockDatesCorrect(blockIndex, blockDates) == false)
+		{
+			return false;
+		}
+	}
+
+	// Последний блок проверяется всегда:
+	size_t lastBlock = m_blocksCount - 1;
+
+	if (lastBlock % step != 0)
+	{
+		if (readBlockDates(lastBlock, m_binaryFileStream, blockDates) == false ||
+			isBlockDatesCorrect(lastBlock, blockDates) == false)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool dph::EphemerisRelease::isPackedDataCorrect(size_t fileSize) const
+{
+	const PackedFormat::Header& header = m_packedHeader;
+
+	// Коэффициенты упакованного файла используются только на месте:
+	if (m_accessMode == Access::STREAM)							return false;
+
+	if (header.ncoeff != m_ncoeff)								return false;
+	if (header.blocksCount != m_blocksCount)					return false;
+	if (header.fileSize > fileSize)								return false;
+	if (header.datesOffset % sizeof(double) != 0)				return false;
+	if (header.datesOffset + m_blocksCount * 16 > fileSize)	return false;
+
+	for (unsigned i = 0; i < 15; ++i)
+	{
+		// Количество коэффициентов элемента в блоке:
+		uint64_t itemCoeffCount = (i == 11 ? 2 : i == 14 ? 1 : 3) * 
+			uint64_t(m_keys[i][1]) * m_keys[i][2];
+
+		if (itemCoeffCount == 0)
+		{
+			continue;
+		}
+
+		uint64_t offset = header.itemOffsets[i];
+		uint64_t stride = header.itemStrides[i];
+
+		if (m_packedItems[i] == NULL)							return false;
+		if (offset % sizeof(double) != 0)						return false;
+		if (stride % sizeof(double) != 0)						return false;
+		if (stride < itemCoeffCount * sizeof(double))			return false;
+		if (offset + stride * m_blocksCount > fileSize)			return false;
+	}
+
+	return true;
+}
+
+const char* dph::EphemerisRelease::fileData() const
+{
+	return m_accessMode == Access::MMAP ? m_core->mappedFile.data() : 
+		m_core->loadedFile.data();
+}
+
+size_t dph::EphemerisRelease::blockAddress(size_t blockIndex) const
+{
+	if (m_packed)
+	{
+		return static_cast<size_t>(m_packedHeader.datesOffset) + blockIndex * 2 * 
+			sizeof(double);
+	}
+	else if (m_compactImage)
+	{
+		return blockIndex * m_residentLength * sizeof(double);
+	}
+
+	return (2 + blockIndex) * m_blockSize_bytes;
+}
+
+const double* dph::EphemerisRelease::itemBlock(unsigned baseItemIndex,
+	const CalculationContext& context) const
+{
+	if (m_packed)
+	{
+		return m_packedItems[baseItemIndex] + 
+			context.m_blockIndex * m_packedStrides[baseItemIndex];
+	}
+
+	return context.m_block + m_residentOffsets[baseItemIndex];
+}
+
+bool dph::EphemerisRelease::readBlockDates(size_t blockIndex, std::ifstream& stream,
+	double* blockDates) const
+{
+	// Адрес блока в файле:
+	size_t adress = blockAddress(blockIndex);
+
+	if (m_accessMode != Access::STREAM)
+	{
+		// Даты блоков читаются прямо из памяти:
+		std::memcpy(blockDates, fileData() + adress, sizeof(double) * 2);
+
+		return true;
+	}
+
+	stream.seekg(adress, std::ios::beg);
+	stream.read((char*)blockDates, sizeof(double) * 2);
+
+	return stream.good();
+}
+
+bool dph::EphemerisRelease::isBlockDatesCorrect(size_t blockIndex, 
+	const double* blockDates) const
+{
+	// Значения, которые должны быть:
+	double blockStartDate = m_startDate + blockIndex * m_blockTimeSpan;
+	double blockEndDate = blockStartDate + m_blockTimeSpan;
+
+	return blockDates[0] == blockStartDate && blockDates[1] == blockEndDate;
+}
+
+bool dph::EphemerisRelease::bindContext(CalculationContext& context) const
+{
+	// Адреса объекта недостаточно: по нему может находиться другой (или 
+	// переоткрытый, скопированный) выпуск.
+	if (context.m_owner == this && context.m_ownerGeneration == m_generation)
+	{
+		return true;
+	}
+
+	context.reset();
+
+	// Собственный поток и буффер блока нужны только при чтении через поток:
+	if (m_accessMode == Access::STREAM)
+	{
+		context.m_stream.open(m_binaryFilePath.c_str(), std::ios::binary);
+
+		if (context.m_stream.is_open() == false)
+		{
+			return false;
+		}
+
+		// Буффер на все ячейки кэша:
+		context.m_buffer.resize(m_residentLength * m_cacheBlocksCount);
+
+		context.m_cacheSlotBlocks.assign(m_cacheBlocksCount, size_t(-1));
+		context.m_cacheReferenced.assign(m_cacheBlocksCount, 0);
+
+		// При малом количестве ячеек поиск блока выполняется без таблицы:
+		if (m_cacheBlocksCount > CACHE_BLOCKS_MIN)
+		{
+			context.m_cacheBlockSlots.assign(m_blocksCount, size_t(-1));
+		}
+
+		// Дескриптор для подсказок ОС (при неудаче загрузка не упреждается):
+		if (m_prefetchBlocksCount != 0)
+		{
+			context.m_readAhead.open(m_binaryFilePath);
+		}
+	}
+
+	context.m_poly.resize(m_polynomsCount);
+	context.m_dpoly.resize(m_polynomsCount);
+
+	// Признаки проверенных блоков (по биту на блок):
+	if (m_validation == Validation::LAZY)
+	{
+		context.m_checkedBlocks.assign(m_blocksCount / 8 + 1, 0);
+	}
+
+	context.m_poly[0]  = 1;
+	context.m_dpoly[0] = 0;
+	context.m_dpoly[1] = 1;
+
+	context.m_owner = this;
+	context.m_ownerGeneration = m_generation;
+
+	return true;
+}
+
+bool dph::EphemerisRelease::fillBuffer(size_t block_num, CalculationContext& context) const
+{
+	size_t adress = blockAddress(block_num);
+
+#ifdef DEPHEM_ENABLE_STATS
+	++context.m_statistics.fillBufferCalls;
+#endif
+
+	if (m_prefetchBlocksCount != 0)
+	{
+		prefetchBlocks(block_num, context);
+	}
+
+	// Ячейка кэша, в которую читается блок (Access::STREAM):
+	size_t slot = size_t(-1);
+
+	if (m_accessMode != Access::STREAM)
+	{
+		// Коэффициенты используются на месте, без копирования (в упакованном
+		// формате указатель блока - его даты, см. itemBlock(...)):
+		context.m_block = reinterpret_cast<const double*>(fileData() + adress);
+
+		++context.m_cacheMisses;
+	}
+	else
+	{
+		// Поиск блока в кэше:
+		if (context.m_cacheBlockSlots.empty())
+		{
+			for (size_t s = 0; s < context.m_cacheSlotBlocks.size(); ++s)
+			{
+				if (context.m_cacheSlotBlocks[s] == block_num)
+				{
+					slot = s;
+					break;
+				}
+			}
+		}
+		else
+		{
+			slot = context.m_cacheBlockSlots[block_num];
+		}
+
+		if (slot != size_t(-1))
+		{
+			// Блок уже в кэше (и, при Validation::LAZY, уже проверен):
+			++context.m_cacheHits;
+
+			context.m_cacheReferenced[slot] = 1;
+			context.m_block = &context.m_buffer[slot * m_residentLength];
+			context.m_blockIndex = block_num;
+
+			return true;
+		}
+
+		++context.m_cacheMisses;
+
+		// Выбор ячейки для вытеснения (CLOCK): пропускаются ячейки, к которым
+		// обращались после прошлого прохода "стрелки".
+		size_t slotsCount = context.m_cacheSlotBlocks.size();
+
+		while (context.m_cacheReferenced[context.m_cacheHand] != 0)
+		{
+			context.m_cacheReferenced[context.m_cacheHand] = 0;
+			context.m_cacheHand = (context.m_cacheHand + 1) % slotsCount;
+		}
+
+		slot = context.m_cacheHand;
+		context.m_cacheHand = (slot + 1) % slotsCount;
+
+		// Вытеснение блока из ячейки:
+		size_t evictedBlock = context.m_cacheSlotBlocks[slot];
+
+		if (evictedBlock != size_t(-1))
+		{
+			++context.m_cacheEvictions;
+
+			if (context.m_cacheBlockSlots.empty() == false)
+			{
+				context.m_cacheBlockSlots[evictedBlock] = size_t(-1);
+			}
+
+			context.m_cacheSlotBlocks[slot] = size_t(-1);
+		}
+
+#ifdef DEPHEM_ENABLE_STATS
+		double ioStartTime = Statistics::currentTime();
+#endif
+
+		// Читаются только участки блока с используемыми элементами (см. 
+		// arrangeResidentItems()), в ячейке они располагаются подряд:
+		double* slotBlock = &context.m_buffer[slot * m_residentLength];
+
+		for (unsigned r = 0; r < m_residentRunsCount; ++r)
+		{
+			context.m_stream.seekg(adress + m_residentRuns[r][0] * sizeof(double), 
+				std::ios::beg);
+
+			context.m_stream.read((char*)slotBlock, m_residentRuns[r][1] * sizeof(double));
+
+#ifdef DEPHEM_ENABLE_STATS
+			context.m_statistics.bytesRead += context.m_stream.gcount();
+			++context.m_statistics.seeksCount;
+#endif
+
+			slotBlock += m_residentRuns[r][1];
+		}
+
+#ifdef DEPHEM_ENABLE_STATS
+		context.m_statistics.ioTime_s += Statistics::currentTime() - ioStartTime;
+#endif
+
+		// Блок прочитан не полностью: в ячейке - часть блока или коэффициенты
+		// вытесненного блока. Ячейка остаётся пустой, текущего блока нет (при
+		// любом уровне проверки):
+		if (context.m_stream.fail())
+		{
+			context.m_stream.clear();
+			context.m_block = NULL;
+			context.m_blockIndex = size_t(-1);
+
+			return false;
+		}
+
+		context.m_block = &context.m_buffer[slot * m_residentLength];
+	}
+
+	// Проверка дат блока при первой загрузке (Validation::LAZY):
+	if (m_validation == Validation::LAZY)
+	{
+		unsigned char& checkedByte = context.m_checkedBlocks[block_num / 8];
+		unsigned char checkedBit = static_cast<unsigned char>(1 << (block_num % 8));
+
+		if ((checkedByte & checkedBit) == 0)
+		{
+			if (isBlockDatesCorrect(block_num, context.m_block) == false)
+			{
+				context.m_block = NULL;
+				context.m_blockIndex = size_t(-1);
+
+				return false;
+			}
+
+			checkedByte |= checkedBit;
+		}
+	}
+
+	// Запись блока в кэш (блок с неверными датами в кэш не попадает):
+	if (slot != size_t(-1))
+	{
+		context.m_cacheSlotBlocks[slot] = block_num;
+		context.m_cacheReferenced[slot] = 1;
+
+		if (context.m_cacheBlockSlots.empty() == false)
+		{
+			context.m_cacheBlockSlots[block_num] = slot;
+		}
+	}
+
+	context.m_blockIndex = block_num;
+
+	return true;
+}
+
+void dph::EphemerisRelease::prefetchBlocks(size_t blockIndex, 
+	CalculationContext& context) const
+{
+	// Коэффициенты в памяти процесса (Access::MEMORY) загружать не нужно:
+	if (m_accessMode == Access::MEMORY)
+	{
+		return;
+	}
+
+	// Направление обхода (относительно текущего блока контекста):
+	size_t currentIndex = context.m_blockIndex;
+	int direction = 0;
+
+	if (currentIndex != size_t(-1))
+	{
+		direction = blockIndex == currentIndex + 1 ? 1 : 
+			blockIndex + 1 == currentIndex ? -1 : 0;
+	}
+
+	if (direction == 0)
+	{
+		context.m_prefetchDirection = 0;
+
+		return;
+	}
+
+	// Диапазон запрашиваемых блоков [first : last]:
+	size_t first = 0;
+	size_t last = 0;
+
+	if (direction > 0)
+	{
+		if (blockIndex + 1 >= m_blocksCount)
+		{
+			return;
+		}
+
+		first = blockIndex + 1;
+		last = m_blocksCount - 1 - blockIndex > m_prefetchBlocksCount ? 
+			blockIndex + m_prefetchBlocksCount : m_blocksCount - 1;
+
+		// Уже запрошенные ранее блоки пропускаются:
+		if (context.m_prefetchDirection > 0 && context.m_prefetchEdge >= first)
+		{
+			if (context.m_prefetchEdge >= last)
+			{
+				return;
+			}
+
+			first = context.m_prefetchEdge + 1;
+		}
+
+		context.m_prefetchEdge = last;
+	}
+	else
+	{
+		if (blockIndex == 0)
+		{
+			return;
+		}
+
+		first = blockIndex > m_prefetchBlocksCount ? 
+			blockIndex - m_prefetchBlocksCount : 0;
+		last = blockIndex - 1;
+
+		if (context.m_prefetchDirection < 0 && context.m_prefetchEdge <= last)
+		{
+			if (context.m_prefetchEdge <= first)
+			{
+				return;
+			}
+
+			last = context.m_prefetchEdge - 1;
+		}
+
+		context.m_prefetchEdge = first;
+	}
+
+	context.m_prefetchDirection = direction;
+
+	if (m_packed)
+	{
+		// В упакованном файле запрашиваются записи каждого элемента:
+		for (unsigned i = 0; i < 15; ++i)
+		{
+			if (m_packedItems[i] != NULL && ((m_residentItems >> i) & 1))
+			{
+				size_t itemOffset = static_cast<size_t>(m_packedHeader.itemOffsets[i]);
+				size_t stride = static_cast<size_t>(m_packedHeader.itemStrides[i]);
+
+				m_core->mappedFile.willNeed(itemOffset + first * stride, 
+					(last - first + 1) * stride);
+			}
+		}
+
+		return;
+	}
+
+	// Если используются все элементы, блоки запрашиваются одним участком, 
+	// иначе - по участкам блоков с используемыми элементами:
+	bool isWholeBlock = m_residentRunsCount == 1 && m_residentRuns[0][1] == m_ncoeff;
+
+	size_t blocksStep = isWholeBlock ? last - first + 1 : 1;
+
+	for (size_t b = first; b <= last; b += blocksStep)
+	{
+		for (unsigned r = 0; r < m_residentRunsCount; ++r)
+		{
+			size_t offset = (2 + b) * m_blockSize_bytes + m_residentRuns[r][0] * sizeof(double);
+			size_t size = isWholeBlock ? blocksStep * m_blockSize_bytes : 
+				m_residentRuns[r][1] * sizeof(double);
+
+			if (m_accessMode == Access::MMAP)
+			{
+				m_core->mappedFile.willNeed(offset, size);
+			}
+			else
+			{
+				context.m_readAhead.willNeed(offset, size);
+			}
+		}
+	}
+}
+
+bool dph::EphemerisRelease::checkBlockOnce(size_t blockIndex, 
+	CalculationContext& context) const
+{
+	if (m_validation != Validation::LAZY)
+	{
+		return true;
+	}
+
+	unsigned char& checkedByte = context.m_checkedBlocks[blockIndex / 8];
+	unsigned char checkedBit = static_cast<unsigned char>(1 << (blockIndex % 8));
+
+	if ((checkedByte & checkedBit) == 0)
+	{
+		// Массив для чтения первых двух коэффициентов блока:
+		double blockDates[2] = {0.0, 0.0};
+
+#ifdef DEPHEM_ENABLE_STATS
+		double ioStartTime = Statistics::currentTime();
+#endif
+
+		bool isRead = readBlockDates(blockIndex, context.m_stream, blockDates);
+
+#ifdef DEPHEM_ENABLE_STATS
+		context.m_statistics.ioTime_s += Statistics::currentTime() - ioStartTime;
+		context.m_statistics.bytesRead += isRead ? sizeof(blockDates) : 0;
+		++context.m_statistics.seeksCount;
+#endif
+
+		if (isRead == false || isBlockDatesCorrect(blockIndex, blockDates) == false)
+		{
+			context.m_stream.clear();
+
+			return false;
+		}
+
+		checkedByte |= checkedBit;
+	}
+
+	return true;
+}
+
+const double* dph::EphemerisRelease::loadBlock(size_t blockIndex, 
+	CalculationContext& context) const
+{
+	if (blockIndex != context.m_blockIndex && fillBuffer(blockIndex, context) == false)
+	{
+		return NULL;
+	}
+
+	return context.m_block;
+}
+
+bool dph::EphemerisRelease::prepareBlock(const Epoch& epoch, 
+	CalculationContext& context) const
+{
+	// Блок загружается до вычислений при любом уровне проверки: если его не
+	// удалось прочитать, результат не записывается.
+	size_t blockIndex = epoch.m_blockIndex;
+
+	if (blockIndex == context.m_blockIndex)
+	{
+		return true;
+	}
+
+	return fillBuffer(blockIndex, context);
+}
+
+void dph::EphemerisRelease::setEpoch(double JED, Epoch& epoch) const
+{
+	// См. calculateBaseItem(...).
+	double normalizedTime = (JED - m_startDate) / m_blockTimeSpan;
+	size_t offset = static_cast<size_t>(normalizedTime);
+
+	epoch.m_JED = JED;
+	epoch.m_startDate = m_startDate;
+	epoch.m_blockTimeSpan = m_blockTimeSpan;
+
+	// Если JED равна последней доступной дате, то используется конец 
+	// последнего блока:
+	if (JED == m_endDate || offset >= m_blocksCount)
+	{
+		epoch.m_blockIndex = m_blocksCount - 1;
+		epoch.m_blockTime = 1;
+	}
+	else
+	{
+		epoch.m_blockIndex = offset;
+		epoch.m_blockTime = normalizedTime - offset;
+	}
+}
+
+bool dph::EphemerisRelease::isEpochCorrect(const Epoch& epoch) const
+{
+	return epoch.m_startDate == m_startDate && epoch.m_blockTimeSpan == m_blockTimeSpan &&
+		epoch.m_blockIndex < m_blocksCount;
+}
+
+bool dph::EphemerisRelease::isPolynomsReady(double normalizedTime, uint32_t polynomsCount,
+	bool withDerivatives, const CalculationContext& context)
+{
+	return context.m_polyCount >= polynomsCount && normalizedTime == context.m_polyTime &&
+		(withDerivatives == false || context.m_dpolyCount >= polynomsCount);
+}
+
+void dph::EphemerisRelease::setPolynomsReady(double normalizedTime, uint32_t polynomsCount,
+	bool withDerivatives, CalculationContext& context)
+{
+	// Полиномы другого момента времени заменяют прежние (poly[0], dpoly[0] и 
+	// dpoly[1] постоянны, см. bindContext(...)):
+	if (context.m_polyCount == 0 || normalizedTime != context.m_polyTime)
+	{
+		context.m_polyTime = normalizedTime;
+		context.m_polyCount = 2;
+		context.m_dpolyCount = 2;
+	}
+
+	if (polynomsCount > context.m_polyCount)
+	{
+		context.m_polyCount = polynomsCount;
+	}
+
+	if (withDerivatives && polynomsCount > context.m_dpolyCount)
+	{
+		context.m_dpolyCount = polynomsCount;
+	}
+}
+
+void dph::EphemerisRelease::fillPolynoms(double normalizedTime, uint32_t polynomsCount, 
+	bool withDerivatives, CalculationContext& context) const
+{
+	if (isPolynomsReady(normalizedTime, polynomsCount, withDerivatives, context))
+	{
+		return;
+	}
+
+	// Значения полиномов и их производных:
+	double* poly  = &context.m_poly[0];
+	double* dpoly = &context.m_dpoly[0];
+
+	// Количество уже вычисленных для этого момента времени значений:
+	uint32_t polyCount = 2;
+	uint32_t dpolyCount = 2;
+
+	if (context.m_polyCount != 0 && normalizedTime == context.m_polyTime)
+	{
+		polyCount = context.m_polyCount;
+		dpolyCount = context.m_dpolyCount;
+	}
+
+	poly[1] = normalizedTime;
+
+	// Заполнение полиномов и их производных (см. dph::Chebyshev). Каждое
+	// значение зависит только от предыдущих, поэтому вычисленные ранее
+	// значения дополняются:
+	Chebyshev::fillPolynoms(normalizedTime, polyCount, polynomsCount, poly);
+
+	if (withDerivatives)
+	{
+		Chebyshev::fillDerivatives(normalizedTime, dpolyCount, polynomsCount, poly, dpoly);
+	}
+
+	setPolynomsReady(normalizedTime, polynomsCount, withDerivatives, context);
+}
+
+void dph::EphemerisRelease::interpolatePosition(unsigned baseItemIndex, double normalizedTime,
+	const double* coeffArray, unsigned componentsCount, double* resultArray, 
+		CalculationContext& context) const
+{
+#ifdef DEPHEM_ENABLE_STATS
+	double mathStartTime = Statistics::currentTime();
+#endif
+
+	// Копирование значения количества коэффициентов на компоненту:
+	uint32_t cpec = m_keys[baseItemIndex][1];
+
+	if (m_positionKernels[baseItemIndex] != NULL)
+	{
+		// Шаблонное ядро для количества коэффициентов и компонент элемента
+		// (полиномы вычисляются, если не вычислены ранее для этого времени):
+		bool isPolyReady = isPolynomsReady(normalizedTime, cpec, false, context);
+
+		m_positionKernels[baseItemIndex](normalizedTime, isPolyReady, &context.m_poly[0],
+			coeffArray, resultArray);
+
+		setPolynomsReady(normalizedTime, cpec, false, context);
+	}
+	else
+	{
+		// Значения полиномов:
+		fillPolynoms(normalizedTime, cpec, false, context);
+
+		// Вычисление координат:
+		Chebyshev::sumPosition(&context.m_poly[0], coeffArray, cpec, componentsCount,
+			resultArray);
+	}
+
+#ifdef DEPHEM_ENABLE_STATS
+	context.m_statistics.mathTime_s += Statistics::currentTime() - mathStartTime;
+	++context.m_statistics.interpolations[baseItemIndex];
+#endif
+}
+
+void dph::EphemerisRelease::interpolateState(unsigned baseItemIndex, double normalizedTime,
+	const double* coeffArray, unsigned componentsCount, double* resultArray, 
+		CalculationContext& context) const
+{
+#ifdef DEPHEM_ENABLE_STATS
+	double mathStartTime = Statistics::currentTime();
+#endif
+
+	// Копирование значения количества коэффициентов на компоненту:
+	uint32_t cpec = m_keys[baseItemIndex][1];
+
+	// Определение переменной для соблюдения размерности:
+	double derivative_units = m_keys[baseItemIndex][2] * m_dimensionFit;
+
+	if (m_stateKernels[baseItemIndex] != NULL)
+	{
+		// Шаблонное ядро для количества коэффициентов и компонент элемента
+		// (полиномы вычисляются, если не вычислены ранее для этого времени):
+		bool isPolyReady = isPolynomsReady(normalizedTime, cpec, true, context);
+
+		m_stateKernels[baseItemIndex](normalizedTime, isPolyReady, &context.m_poly[0],
+			&context.m_dpoly[0], coeffArray, derivative_units, resultArray);
+
+		setPolynomsReady(normalizedTime, cpec, true, context);
+	}
+	else
+	{
+		// Значения полиномов и их производных (не менее трёх):
+		fillPolynoms(normalizedTime, cpec < 3 ? 3 : cpec, true, context);
+
+		// Вычисление координат и их производных:
+		Chebyshev::sumState(&context.m_poly[0], &context.m_dpoly[0], coeffArray, cpec,
+			componentsCount, derivative_units, resultArray);
+	}
+
+#ifdef DEPHEM_ENABLE_STATS
+	context.m_statistics.mathTime_s += Statistics::currentTime() - mathStartTime;
+	++context.m_statistics.interpolations[baseItemIndex];
+#endif
+}
+
+void dph::EphemerisRelease::calculateBaseItem(unsigned baseItemIndex, const Epoch& epoch, 
+	unsigned calculationResult, double* resultArray, CalculationContext& context) const
+{
+	// Допустимые значения переданных параметров:
+	//	[1]	baseItemIndex - Индекс базового элемента выпуска (от нуля).
+	// 
+	//						Нумерация базовых элементов выпуска
+	//		-------------------------------------------------------------------
+	//		Индекс	Наименование
+	//		-------------------------------------------------------------------
+	//		0		Mercury
+	//		1		Venus
+	//		2		Earth-Moon barycenter
+	//		3		Mars
+	//		4		Jupiter
+	//		5		Saturn
+	//		6		Uranus
+	//		7		Neptune
+	//		8		Pluto
+	//		9		Moon (geocentric)
+	//		10		Sun
+	//		11		Earth Nutations in longitude and obliquity (IAU 1980 model)
+	//		12		Lunar mantle libration
+	//		13		Lunar mantle angular velocity
+	//		14		TT-TDB (at geocenter)
+	//		-------------------------------------------------------------------
+	//	[2] epoch - момент времени на который требуется получить требуемые значения.
+	//	[3] calculationResult - индекс результата вычисления (см. dph::Calculate).
+	//	[4] resultArray - указатель на массив для результата вычислений.
+	//	[5] context - контекст вычислений (привязанный к объекту).
+
+	// Внимание! 
+	// В ходе выполнения функции смысл переменных "normalizedTime" и "offset" будет меняться.
+
+	// Порядковый номер требуемого блока (см. setEpoch(...)):
+	size_t blockIndex = epoch.m_blockIndex;
+
+	// Количество компонент для выбранного базового элемента:
+	unsigned componentsCount = baseItemIndex == 11 ? 2 : baseItemIndex == 14 ? 1 : 3;
+
+	// Заполнение буффера коэффициентами требуемого блока.
+	// Если требуемый блок уже в кэше объекта, то он не заполняется повторно.
+	// Если блок не удалось загрузить, то коэффициентов нет:
+	if (blockIndex != context.m_blockIndex && fillBuffer(blockIndex, context) == false)
+	{
+		std::memset(resultArray, 0, componentsCount * sizeof(double) * 
+			(calculationResult == Calculate::STATE ? 2 : 1));
+
+		return;
+	}
+	
+	size_t offset;
+	double normalizedTime;
+
+	if (epoch.m_blockTime == 1)
+	{
+		// Конец блока (дата окончания выпуска).
+		// Порядковый номер подблока (последний подблок):
+		offset = m_keys[baseItemIndex][2] - 1;
+
+		// Норм. время относительно подблока (в диапазоне от -1 до 1):
+		normalizedTime = 1;
+	}
+	else
+	{
+		// Норм. время относительно всех подблоков:
+		normalizedTime = epoch.m_blockTime * m_keys[baseItemIndex][2];
+
+		// Порядковый номер подблока (целая часть от normalizedTime):
+		offset = static_cast<size_t>(normalizedTime);
+
+		// Норм. время относительно подблока (в диапазоне от -1 до 1):
+		normalizedTime = 2 * (normalizedTime - offset) - 1;
+	}
+
+	// Порядковый номер первого коэффициента подблока (относительно первого 
+	// коэффициента элемента в блоке):
+	size_t coeff_pos = componentsCount * offset * m_keys[baseItemIndex][1];
+
+	// Коэффициенты подблока:
+	const double* coeffArray = itemBlock(baseItemIndex, context) + coeff_pos;
+
+	// Выбор метода вычисления в зависимости от заданного результата вычислений:
+	switch(calculationResult)
+	{
+	case Calculate::POSITION : 
+		interpolatePosition(baseItemIndex, normalizedTime, coeffArray, 
+			componentsCount, resultArray, context);
+		break;
+
+	case Calculate::STATE :
+		interpolateState(baseItemIndex, normalizedTime, coeffArray, 
+			componentsCount, resultArray, context);
+		break;
+		
+	default:
+		memset(resultArray, 0, componentsCount * sizeof(double));
+	}		
+}
+
+void dph::EphemerisRelease::calculateBaseEarth(const Epoch& epoch, unsigned calculationResult, 
+	double* resultArray, CalculationContext& context) const
+{
+	// Получение радиус-вектора (или вектора состояния) барицентра сиситемы Земля-Луна
+	// относительно барицентра Солнечной Системы:
+	calculateBaseItem(2, epoch, calculationResult, resultArray, context);
+
+	// Получение радиус-вектора (или вектора состояния) Луны относитльно Земли:
+	double MoonRelativeEarth[6];
+	calculateBaseItem(9, epoch, calculationResult, MoonRelativeEarth, context);
+
+	// Количество компонент:
+	unsigned componentsCount = calculationResult == Calculate::POSITION ? 3 : 6;
+
+	// Опредление положения Земли относительно барицентра Солнечной Системы:
+	for (unsigned i = 0; i < componentsCount; ++i)
+	{
+		resultArray[i] -= MoonRelativeEarth[i] * m_emrat2;
+	}
+}
+
+void dph::EphemerisRelease::calculateBaseMoon(const Epoch& epoch, unsigned calculationResult,
+	double* resultArray, CalculationContext& context) const
+{
+	// Получение радиус-вектора (или вектора состояния) барицентра сиситемы Земля-Луна
+	// относительно барицентра Солнечной Системы:
+	calculateBaseItem(2, epoch, calculationResult, resultArray, context);
+
+	// Получение радиус-вектора (или вектора состояния) Луны относитльно Земли:
+	double MoonRelativeEarth[6];
+	calculateBaseItem(9, epoch, calculationResult, MoonRelativeEarth, context);
+
+	// Количество компонент:
+	unsigned componentsCount = calculationResult == Calculate::POSITION ? 3 : 6;
+
+	// Определение относительного положения:
+	for (unsigned i = 0; i < componentsCount; ++i)
+	{
+		resultArray[i] += MoonRelativeEarth[i] * (1 - m_emrat2);
+	}	
+}
+
+
+const double* dph::EphemerisRelease::calculateBaseItemOnce(unsigned baseItemIndex,
+	const Epoch& epoch, unsigned calculationResult, double (*itemValues)[6], 
+		bool* isCalculated,
+		CalculationContext& context) const
+{
+	if (isCalculated[baseItemIndex] == false)
+	{
+		calculateBaseItem(baseItemIndex, epoch, calculationResult, itemValues[baseItemIndex],
+			context);
+
+		isCalculated[baseItemIndex] = true;
+	}
+
+	return itemValues[baseItemIndex];
+}
+
+void dph::EphemerisRelease::calculateBaseBodyOnce(unsigned body, const Epoch& epoch, 
+	unsigned calculationResult, double* resultArray, double (*itemValues)[6], 
+		bool* isCalculated, CalculationContext& context) const
+{
+	// Количество компонент:
+	unsigned componentsCount = calculationResult == Calculate::POSITION ? 3 : 6;
+
+	// Базовый элемент тела (для Земли и Луны - барицентр системы Земля-Луна):
+	unsigned baseItemIndex = body == Body::EMBARY || body == Body::EARTH || 
+		body == Body::MOON ? 2 : body - 1;
+
+	std::memcpy(resultArray, calculateBaseItemOnce(baseItemIndex, epoch, calculationResult,
+		itemValues, isCalculated, context), sizeof(double) * componentsCount);
+
+	// См. calculateBaseEarth(...) и calculateBaseMoon(...).
+	if (body == Body::EARTH || body == Body::MOON)
+	{
+		const double* MoonRelativeEarth = calculateBaseItemOnce(9, epoch, calculationResult,
+			itemValues, isCalculated, context);
+
+		if (body == Body::EARTH)
+		{
+			for (unsigned i = 0; i < componentsCount; ++i)
+			{
+				resultArray[i] -= MoonRelativeEarth[i] * m_emrat2;
+			}
+		}
+		else
+		{
+			for (unsigned i = 0; i < componentsCount; ++i)
+			{
+				resultArray[i] += MoonRelativeEarth[i] * (1 - m_emrat2);
+			}
+		}
+	}
+}
+
+void dph::EphemerisRelease::calculateBaseBody(unsigned body, const Epoch& epoch,
+	unsigned calculationResult, double* resultArray, CalculationContext& context) const
+{
+	switch (body)
+	{
+	case Body::EARTH: calculateBaseEarth(epoch, calculationResult, resultArray, context);	break;
+	case Body::MOON: calculateBaseMoon(epoch, calculationResult, resultArray, context);		break;
+	case Body::EMBARY: calculateBaseItem(2, epoch, calculationResult, resultArray, context);	break;
+	case Body::SSBARY: 
+		std::memset(resultArray, 0, sizeof(double) * 
+			(calculationResult == Calculate::POSITION ? 3 : 6));
+		break;
+	default: calculateBaseItem(body - 1, epoch, calculationResult, resultArray, context);
+	}
+}
+
+bool dph::EphemerisRelease::calculateApparentBody(unsigned correction,
+	unsigned targetBody, double JED, const double* observerState, double* resultArray,
+		CalculationContext& context) const
+{
+	// Момент излучения света и время его распространения (с):
+	double emissionJED = JED;
+	double lightTime = 0;
+
+	// Положение тела относительно наблюдателя:
+	double position[3];
+
+	for (unsigned i = 0; ; ++i)
+	{
+		Epoch emissionEpoch;
+
+		setEpoch(emissionJED, emissionEpoch);
+
+		// Блок момента излучения (при Validation::LAZY - с проверкой дат):
+		if (prepareBlock(emissionEpoch, context) == false)
+		{
+			return false;
+		}
+
+		calculateBaseBody(targetBody, emissionEpoch, Calculate::POSITION, position, 
+			context);
+
+		for (unsigned k = 0; k < 3; ++k)
+		{
+			position[k] -= observerState[k];
+		}
+
+		lightTime = std::sqrt(position[0] * position[0] + position[1] * position[1] +
+			position[2] * position[2]) / m_clight;
+
+		if (correction == Correction::GEOMETRIC)
+		{
+			break;
+		}
+
+		// Уточнённый момент излучения (итерации прекращаются, когда момент 
+		// перестаёт изменяться в пределах точности JED):
+		double nextJED = JED - lightTime / 86400;
+
+		if (nextJED == emissionJED || i + 1 == LIGHT_TIME_ITERATIONS)
+		{
+			break;
+		}
+		else if (nextJED < m_startDate)
+		{
+			return false;
+		}
+
+		emissionJED = nextJED;
+	}
+
+	// Звёздная аберрация (релятивистская формула, как в NOVAS):
+	double distance = lightTime * m_clight;
+
+	if (correction == Correction::ABERRATION && distance > 0)
+	{
+		// Скорость наблюдателя в долях скорости света:
+		double beta[3] = { observerState[3] / m_clight, observerState[4] / m_clight,
+			observerState[5] / m_clight };
+
+		double cosine = (position[0] * beta[0] + position[1] * beta[1] + 
+			position[2] * beta[2]) / distance;
+		double gammaInverse = std::sqrt(1 - beta[0] * beta[0] - beta[1] * beta[1] - 
+			beta[2] * beta[2]);
+		double factor = (1 + cosine / (1 + gammaInverse)) * distance;
+
+		for (unsigned k = 0; k < 3; ++k)
+		{
+			position[k] = (gammaInverse * position[k] + factor * beta[k]) / (1 + cosine);
+		}
+	}
+
+	resultArray[0] = position[0];
+	resultArray[1] = position[1];
+	resultArray[2] = position[2];
+	resultArray[3] = lightTime;
+
+	return true;
+}
+
+size_t dph::EphemerisRelease::blockIndexOf(double JED) const
+{
+	// См. calculateBaseItem(...).
+	size_t offset = static_cast<size_t>((JED - m_startDate) / m_blockTimeSpan);
+
+	// Последняя дата выпуска (и ошибка округления вблизи неё) относится к 
+	// последнему блоку, см. makeEpoch(...):
+	return JED == m_endDate || offset >= m_blocksCount ? m_blocksCount - 1 : offset;
+}
+
+bool dph::EphemerisRelease::calculateBaseItemChunk(unsigned baseItemIndex, 
+	const double* JEDs, size_t count, unsigned calculationResult, double* resultArray,
+		CalculationContext& context) const
+{
+	// Все моменты времени пакета принадлежат одному блоку:
+	size_t blockIndex = blockIndexOf(JEDs[0]);
+
+	if (blockIndex != context.m_blockIndex && fillBuffer(blockIndex, context) == false)
+	{
+		return false;
+	}
+
+	// Количество компонент для выбранного базового элемента:
+	unsigned componentsCount = baseItemIndex == 11 ? 2 : baseItemIndex == 14 ? 1 : 3;
+
+	// Норм. время и коэффициенты подблока для каждого момента времени.
+	// Вычисляются так же, как и в calculateBaseItem(...).
+	double normalizedTimes[SERIES_CHUNK_SIZE];
+	const double* coeffArrays[SERIES_CHUNK_SIZE];
+
+	// Коэффициенты элемента в блоке:
+	const double* itemCoeffs = itemBlock(baseItemIndex, context);
+
+	for (size_t e = 0; e < count; ++e)
+	{
+		double normalizedTime = (JEDs[e] - m_startDate) / m_blockTimeSpan;
+		size_t offset = static_cast<size_t>(normalizedTime);
+
+		if (JEDs[e] == m_endDate || offset >= m_blocksCount)
+		{
+			offset = m_keys[baseItemIndex][2] - 1;
+			normalizedTime = 1;
+		}
+		else
+		{
+			normalizedTime = (normalizedTime - offset) * m_keys[baseItemIndex][2];
+			offset = static_cast<size_t>(normalizedTime);
+			normalizedTime = 2 * (normalizedTime - offset) - 1;
+		}
+
+		normalizedTimes[e] = normalizedTime;
+		coeffArrays[e] = itemCoeffs + componentsCount * offset * m_keys[baseItemIndex][1];
+	}
+
+#ifdef DEPHEM_ENABLE_STATS
+	double mathStartTime = Statistics::currentTime();
+#endif
+
+	// Интерполяция сразу для нескольких моментов времени (см. dph::Chebyshev):
+	if (calculationResult == Calculate::STATE)
+	{
+		// Определение переменной для соблюдения размерности:
+		double derivative_units = m_keys[baseItemIndex][2] * m_dimensionFit;
+
+		Chebyshev::stateChunk(m_instructionSet, normalizedTimes, coeffArrays, count,
+			m_keys[baseItemIndex][1], componentsCount, derivative_units, resultArray);
+	}
+	else
+	{
+		Chebyshev::positionChunk(m_instructionSet, normalizedTimes, coeffArrays, count,
+			m_keys[baseItemIndex][1], componentsCount, resultArray);
+	}
+
+#ifdef DEPHEM_ENABLE_STATS
+	context.m_statistics.mathTime_s += Statistics::currentTime() - mathStartTime;
+	context.m_statistics.interpolations[baseItemIndex] += count;
+#endif
+
+	return true;
+}
+
+bool dph::EphemerisRelease::calculateBaseBodyChunk(unsigned body, const double* JEDs,
+	size_t count, unsigned calculationResult, double* resultArray, 
+		CalculationContext& context) const
+{
+	// Количество компонент:
+	unsigned componentsCount = calculationResult == Calculate::POSITION ? 3 : 6;
+
+	if (body == Body::EARTH || body == Body::MOON)
+	{
+		// См. calculateBaseEarth(...) и calculateBaseMoon(...).
+		double MoonRelativeEarth[SERIES_CHUNK_SIZE * 6];
+
+		if (calculateBaseItemChunk(2, JEDs, count, calculationResult, resultArray, 
+				context) == false ||
+			calculateBaseItemChunk(9, JEDs, count, calculationResult, MoonRelativeEarth,
+				context) == false)
+		{
+			return false;
+		}
+
+		size_t valuesCount = count * componentsCount;
+
+		if (body == Body::EARTH)
+		{
+			for (size_t i = 0; i < valuesCount; ++i)
+			{
+				resultArray[i] -= MoonRelativeEarth[i] * m_emrat2;
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < valuesCount; ++i)
+			{
+				resultArray[i] += MoonRelativeEarth[i] * (1 - m_emrat2);
+			}
+		}
+	}
+	else if (body == Body::EMBARY)
+	{
+		return calculateBaseItemChunk(2, JEDs, count, calculationResult, resultArray, 
+			context);
+	}
+	else
 	{
-		if (m_keys[i][1] > maxPolynomsCount)
-		{
-			maxPolynomsCount = m_keys[i][1];
-		}			
+		return calculateBaseItemChunk(body - 1, JEDs, count, calculationResult, 
+			resultArray, context);
 	}
 
-	// Определение размера блока в байтах:
-	m_blockSize_bytes = m_ncoeff * sizeof(double);
-
-	// Резервирование памяти в векторах:
-	m_buffer.resize(m_ncoeff);
-	m_poly.resize(maxPolynomsCount);
-	m_dpoly.resize(maxPolynomsCount);
+	return true;
 }
 
-bool dph::EphemerisRelease::isDataCorrect() const
+bool dph::EphemerisRelease::calculateSeries(unsigned calculationResult, unsigned item,
+	unsigned centerBody, const double* JEDs, size_t count, unsigned componentsCount,
+		double* resultArray, CalculationContext& context) const
 {
-	// В данном методе проверяются только те параметры, которые
-	// могут повлиять непосредственно на вычисления значений элементов, 
-	// хранящихся в выпуске эфемерид.	
-	
-	if (m_binaryFileStream.is_open() == false)			return false;	// Ошибка открытия файла.
-	if (m_startDate >= m_endDate)						return false;
-	if (m_blockTimeSpan == 0)							return false;
-	if ((m_endDate - m_startDate) < m_blockTimeSpan)	return false;
-	if (m_emrat == 0)									return false;
-	if (m_ncoeff == 0)									return false;
+	// Если моменты времени уже сгруппированы по блокам (монотонный ряд), то
+	// пакеты формируются прямо из исходного массива:
+	bool isIncreasing = true;
+	bool isDecreasing = true;
 
-	if (check_blocksDates() == false)					return false;
+	for (size_t i = 1; i < count && (isIncreasing || isDecreasing); ++i)
+	{
+		size_t previousBlock = blockIndexOf(JEDs[i - 1]);
+		size_t currentBlock = blockIndexOf(JEDs[i]);
 
-	return true;
-}
+		isIncreasing = isIncreasing && currentBlock >= previousBlock;
+		isDecreasing = isDecreasing && currentBlock <= previousBlock;
+	}
 
-bool dph::EphemerisRelease::check_blocksDates() const
-{
-	// Адрес первого блока с коэффициентами в файле:
-	size_t firstBlockAdress = m_blockSize_bytes * 2;
-	
-	// Переход к первому блоку:
-	m_binaryFileStream.seekg(firstBlockAdress, std::ios::beg);
+	if (isIncreasing || isDecreasing)
+	{
+		for (size_t first = 0; first < count; )
+		{
+			size_t chunkBlock = blockIndexOf(JEDs[first]);
+			size_t chunkSize = 1;
+
+			while (first + chunkSize < count && chunkSize < SERIES_CHUNK_SIZE &&
+				blockIndexOf(JEDs[first + chunkSize]) == chunkBlock)
+			{
+				++chunkSize;
+			}
+
+			if (calculateItemChunk(calculationResult, item, centerBody, JEDs + first, 
+				chunkSize, resultArray + first * componentsCount, context) == false)
+			{
+				return false;
+			}
 
-	// Смещение между блоками после чтения двух первых коэффициентов:
-	size_t subBlockOffset = (m_ncoeff - 2) * sizeof(double);
+			first += chunkSize;
+		}
+
+		return true;
+	}
+
+	// Иначе моменты времени сортируются по блокам: пары (номер блока, индекс 
+	// момента).
+	std::vector< std::pair<size_t, size_t> > order(count);
 
-	for (size_t blockIndex = 0; blockIndex < m_blocksCount; ++blockIndex)
+	for (size_t i = 0; i < count; ++i)
 	{
-		// Массив для чтения первых двух коэффициентов из текущего блока:
-		double blockDates[2] = {0.0, 0.0};
+		order[i] = std::make_pair(blockIndexOf(JEDs[i]), i);
+	}
+
+	std::sort(order.begin(), order.end());
+
+	// Пакет моментов времени и результаты вычислений для него:
+	double chunkJEDs[SERIES_CHUNK_SIZE];
+	double chunkResults[SERIES_CHUNK_SIZE * 6];
 
-		// Чтение:
-		m_binaryFileStream.read((char*)& blockDates, sizeof(blockDates));	
+	for (size_t first = 0; first < count; )
+	{
+		// Формирование пакета из моментов времени одного блока:
+		size_t chunkSize = 0;
 
-		// Значения, которые должны быть:
-		double blockStartDate = m_startDate + blockIndex * m_blockTimeSpan;
-		double blockEndDate = blockStartDate + m_blockTimeSpan;
+		while (first + chunkSize < count && chunkSize < SERIES_CHUNK_SIZE &&
+			order[first + chunkSize].first == order[first].first)
+		{
+			chunkJEDs[chunkSize] = JEDs[order[first + chunkSize].second];
+			++chunkSize;
+		}
 
-		if (blockDates[0] != blockStartDate || blockDates[1] != blockEndDate)
+		if (calculateItemChunk(calculationResult, item, centerBody, chunkJEDs, 
+			chunkSize, chunkResults, context) == false)
 		{
 			return false;
 		}
-		
-		// Переход к следующему блоку:
-		m_binaryFileStream.seekg(subBlockOffset, std::ios::cur);
+
+		// Запись результатов по исходным индексам:
+		for (size_t i = 0; i < chunkSize; ++i)
+		{
+			std::memcpy(resultArray + order[first + i].second * componentsCount,
+				chunkResults + i * componentsCount, componentsCount * sizeof(double));
+		}
+
+		first += chunkSize;
 	}
 
 	return true;
 }
 
-void dph::EphemerisRelease::fillBuffer(size_t block_num) const
+
+bool dph::EphemerisRelease::calculateItemChunk(unsigned calculationResult, 
+	unsigned item, unsigned centerBody, const double* JEDs, size_t count,
+		double* resultArray, CalculationContext& context) const
 {
-	size_t adress = (2 + block_num) * m_blockSize_bytes;
+	if (item >= Other::EARTH_NUTATIONS)
+	{
+		return calculateBaseItemChunk(item - 3, JEDs, count, calculationResult, 
+			resultArray, context);
+	}
+	else
+	{
+		return calculateBodyChunk(calculationResult, item, centerBody, JEDs, count, 
+			resultArray, context);
+	}
+}
 
-	m_binaryFileStream.seekg(adress, std::ios::beg);
+size_t dph::EphemerisRelease::sliceStart(size_t count, size_t part, 
+	size_t partsCount)
+{
+	// Первые count % partsCount долей на один элемент больше:
+	size_t remainder = count % partsCount;
 
-	m_binaryFileStream.read((char*)&m_buffer[0], (m_ncoeff) * 8);
+	return part * (count / partsCount) + (part < remainder ? part : remainder);
 }
 
-void dph::EphemerisRelease::interpolatePosition(unsigned baseItemIndex, double normalizedTime,
-	const double* coeffArray, unsigned componentsCount, double* resultArray) const
+void dph::EphemerisRelease::prepareParallelSlice(void* worker)
 {
-	// Копирование значения количества коэффициентов на компоненту:
-	uint32_t cpec = m_keys[baseItemIndex][1];
-	
-	// Предварительное заполнение полиномов (вычисление их сумм):
-	m_poly[1] = normalizedTime;
+	ParallelWorker& self = *static_cast<ParallelWorker*>(worker);
+	const ParallelSeries& series = *self.series;
+	const EphemerisRelease& release = *series.release;
 
-	// Заполнение полиномов (вычисление их сумм):
-	for (uint32_t i = 2; i < cpec; ++i)
+	// Контекст исполнителя (без контекста даты блоков доли проверяет 
+	// вызывающий поток, а части ряда вычисляют остальные исполнители):
+	if (self.context == NULL)
 	{
-		m_poly[i] = 2 * normalizedTime * m_poly[i - 1] - m_poly[i - 2];
+		CalculationContext* context = new CalculationContext;
+
+		if (release.bindContext(*context))
+		{
+			self.context = context;
+		}
+		else
+		{
+			delete context;
+		}
 	}
 
-	// Обнуление массива результата вычислений:
-	memset(resultArray, 0, sizeof(double) * componentsCount);
+	size_t first = sliceStart(series.count, self.index, series.workersCount);
+	size_t last = sliceStart(series.count, self.index + 1, series.workersCount);
 
-	// Вычисление координат:
-	for (unsigned i = 0; i < componentsCount; ++i)
+	size_t previousBlock = 0;
+
+	for (size_t i = first; i < last; ++i)
 	{
-		for (uint32_t j = 0; j < cpec; ++j)
+		double JED = series.JEDs[i];
+
+		if (!(JED >= release.m_startDate && JED <= release.m_endDate))
+		{
+			self.isRejected = true;
+
+			return;
+		}
+
+		size_t blockIndex = release.blockIndexOf(JED);
+
+		series.blocks[i] = blockIndex;
+
+		if (i != first && blockIndex == previousBlock)
+		{
+			continue;
+		}
+
+		// Новый блок: порядок, границы и даты блока (Validation::LAZY):
+		if (i == first)
+		{
+			self.headBlock = blockIndex;
+			self.minBlock = blockIndex;
+			self.maxBlock = blockIndex;
+		}
+		else if (blockIndex < previousBlock)
 		{
-			resultArray[i] += m_poly[j] * coeffArray[i * cpec + j];
+			self.isOrdered = false;
 		}
+
+		self.minBlock = blockIndex < self.minBlock ? blockIndex : self.minBlock;
+		self.maxBlock = blockIndex > self.maxBlock ? blockIndex : self.maxBlock;
+
+		if (self.context != NULL && 
+			release.checkBlockOnce(blockIndex, *self.context) == false)
+		{
+			self.isRejected = true;
+
+			return;
+		}
+
+		previousBlock = blockIndex;
 	}
+
+	self.tailBlock = previousBlock;
 }
 
-void dph::EphemerisRelease::interpolateState(unsigned baseItemIndex, double normalizedTime,
-	const double* coeffArray, unsigned componentsCount, double* resultArray) const
+void dph::EphemerisRelease::countParallelSlice(void* worker)
 {
-	// Копирование значения количества коэффициентов на компоненту:
-	uint32_t cpec = m_keys[baseItemIndex][1];
+	ParallelWorker& self = *static_cast<ParallelWorker*>(worker);
+	const ParallelSeries& series = *self.series;
+
+	size_t* counts = series.counts + self.index * series.blocksWidth;
+
+	std::memset(counts, 0, series.blocksWidth * sizeof(size_t));
 
-	// Предварительное заполнение полиномов (вычисление их сумм):
-	m_poly[1]  = normalizedTime;
-	m_poly[2]  = 2 * normalizedTime * normalizedTime - 1;
-	m_dpoly[2] = 4 * normalizedTime;
+	size_t last = sliceStart(series.count, self.index + 1, series.sortersCount);
 
-	// Заполнение полиномов (вычисление их сумм):
-	for (uint32_t i = 3; i < cpec; ++i)
+	for (size_t i = sliceStart(series.count, self.index, series.sortersCount); 
+		i < last; ++i)
 	{
-		 m_poly[i] = 2 * normalizedTime *  m_poly[i - 1] -  m_poly[i - 2];
-		m_dpoly[i] = 2 * m_poly[i - 1] + 2 * normalizedTime * m_dpoly[i - 1] - m_dpoly[i - 2];
+		++counts[series.blocks[i] - series.firstBlock];
 	}
+}
 
-	// Обнуление массива результата вычислений:
-	memset(resultArray, 0, sizeof(double) * componentsCount * 2);
+void dph::EphemerisRelease::sumParallelSegment(void* worker)
+{
+	ParallelWorker& self = *static_cast<ParallelWorker*>(worker);
+	const ParallelSeries& series = *self.series;
 
-	// Определение переменной для соблюдения размерности:
-	double derivative_units = m_keys[baseItemIndex][2] * m_dimensionFit;
+	size_t first = sliceStart(series.blocksWidth, self.index, series.sortersCount);
+	size_t last = sliceStart(series.blocksWidth, self.index + 1, series.sortersCount);
 
-	// Вычисление координат:
-	for (unsigned i = 0; i < componentsCount; ++i)
+	size_t segmentCount = 0;
+
+	for (unsigned s = 0; s < series.sortersCount; ++s)
 	{
-		for (uint32_t j = 0; j < cpec; ++j, ++coeffArray)
+		const size_t* counts = series.counts + s * series.blocksWidth;
+
+		for (size_t b = first; b < last; ++b)
 		{
-			resultArray[i]                   +=  m_poly[j] * *coeffArray;
-			resultArray[i + componentsCount] += m_dpoly[j] * *coeffArray;
+			segmentCount += counts[b];
 		}
-
-		resultArray[i + componentsCount] *= derivative_units;
 	}
+
+	series.segmentStarts[self.index] = segmentCount;
 }
 
-void dph::EphemerisRelease::calculateBaseItem(unsigned baseItemIndex, double JED, 
-	unsigned calculationResult, double* resultArray) const
+void dph::EphemerisRelease::offsetParallelSegment(void* worker)
 {
-	// Допустимые значения переданных параметров:
-	//	[1]	baseItemIndex - Индекс базового элемента выпуска (от нуля).
-	// 
-	//						Нумерация базовых элементов выпуска
-	//		-------------------------------------------------------------------
-	//		Индекс	Наименование
-	//		-------------------------------------------------------------------
-	//		0		Mercury
-	//		1		Venus
-	//		2		Earth-Moon barycenter
-	//		3		Mars
-	//		4		Jupiter
-	//		5		Saturn
-	//		6		Uranus
-	//		7		Neptune
-	//		8		Pluto
-	//		9		Moon (geocentric)
-	//		10		Sun
-	//		11		Earth Nutations in longitude and obliquity (IAU 1980 model)
-	//		12		Lunar mantle libration
-	//		13		Lunar mantle angular velocity
-	//		14		TT-TDB (at geocenter)
-	//		-------------------------------------------------------------------
-	//	[2] JED - момент времени на который требуется получить требуемые значения.
-	//	[3] calculationResult - индекс результата вычисления (см. dph::Calculate).
-	//	[4] resultArray - указатель на массив для результата вычислений.
-
-	// Внимание! 
-	// В ходе выполнения функции смысл переменных "normalizedTime" и "offset" будет меняться.
+	ParallelWorker& self = *static_cast<ParallelWorker*>(worker);
+	const ParallelSeries& series = *self.series;
 
-	// Норм. время относительно всех блоков в выпуске:
-	double normalizedTime = (JED - m_startDate) / m_blockTimeSpan;
+	size_t first = sliceStart(series.blocksWidth, self.index, series.sortersCount);
+	size_t last = sliceStart(series.blocksWidth, self.index + 1, series.sortersCount);
 
-	// Порядковый номер блока, соотв. заданной дате JED (целая часть от normalizedTime):
-	size_t offset = static_cast<size_t>(normalizedTime);
+	// Моменты блока упорядочиваются по долям ряда (как при 
+	// последовательной сортировке):
+	size_t start = series.segmentStarts[self.index];
 
-	// Заполнение буффера коэффициентами требуемого блока.
-	// Если требуемый блок уже в кэше объекта, то он не заполняется повторно.
-	// m_buffer[0] - дата начала блока.
-	// m_buffer[1] - дата окончания блока.
-	if (JED < m_buffer[0] || JED >= m_buffer[1])
+	for (size_t b = first; b < last; ++b)
 	{
-		// Если JED равна последней доступоной дате для вычислений, то заполняется последний блок.
+		for (unsigned s = 0; s < series.sortersCount; ++s)
+		{
+			size_t& count = series.counts[s * series.blocksWidth + b];
+			size_t blockCount = count;
 
-		fillBuffer(offset - (JED == m_endDate ? 1 : 0));
-	}		
-	
-	if (JED == m_endDate)
-	{
-		// Порядковый номер подблока (последний подблок):
-		offset = m_keys[baseItemIndex][2] - 1;
+			count = start;
+			start += blockCount;
+		}
+	}
+}
 
-		// Норм. время относительно подблока (в диапазоне от -1 до 1):
-		normalizedTime = 1;
+void dph::EphemerisRelease::scatterParallelSlice(void* worker)
+{
+	ParallelWorker& self = *static_cast<ParallelWorker*>(worker);
+	const ParallelSeries& series = *self.series;
+
+	size_t* starts = series.counts + self.index * series.blocksWidth;
+
+	size_t last = sliceStart(series.count, self.index + 1, series.sortersCount);
+
+	for (size_t i = sliceStart(series.count, self.index, series.sortersCount); 
+		i < last; ++i)
+	{
+		series.order[starts[series.blocks[i] - series.firstBlock]++] = i;
 	}
-	else
+}
+
+void dph::EphemerisRelease::runParallelWorker(void* worker)
+{
+	ParallelWorker& self = *static_cast<ParallelWorker*>(worker);
+	const ParallelSeries& series = *self.series;
+	const EphemerisRelease& release = *series.release;
+
+	// Без контекста части не берутся, их вычисляют остальные исполнители
+	// (первый исполнитель всегда с контекстом):
+	if (self.context == NULL)
 	{
-		// Норм. время относительно всех подблоков:
-		normalizedTime = (normalizedTime - offset) * m_keys[baseItemIndex][2];
+		return;
+	}
 
-		// Порядковый номер подблока (целая часть от normalizedTime):
-		offset = static_cast<size_t>(normalizedTime);
+	CalculationContext& context = *self.context;
 
-		// Норм. время относительно подблока (в диапазоне от -1 до 1):
-		normalizedTime = 2 * (normalizedTime - offset) - 1;
+	// Буферы для частей упорядоченного ряда (моменты времени собираются 
+	// подряд, результаты раскладываются по местам):
+	std::vector<double> JEDs;
+	std::vector<double> results;
+
+	if (series.order != NULL)
+	{
+		JEDs.resize(series.unitSize);
+		results.resize(series.unitSize * series.componentsCount);
 	}
-	
-	// Количество компонент для выбранного базового элемента:
-	unsigned componentsCount = baseItemIndex == 11 ? 2 : baseItemIndex == 14 ? 1 : 3;
 
-	// Порядковый номер первого коэффициента в блоке:
-	int coeff_pos  = m_keys[baseItemIndex][0] - 1 + componentsCount * offset * m_keys[baseItemIndex][1];
+	size_t unit;
 
-	// Выбор метода вычисления в зависимости от заданного результата вычислений:
-	switch(calculationResult)
+	while (series.queue->next(self.index, unit))
 	{
-	case Calculate::POSITION : 
-		interpolatePosition(baseItemIndex, normalizedTime, &m_buffer[coeff_pos], componentsCount,
-			resultArray);
-		break;
+		size_t first = unit * series.unitSize;
+		size_t count = series.count - first < series.unitSize ? 
+			series.count - first : series.unitSize;
 
-	case Calculate::STATE :
-		interpolateState(baseItemIndex, normalizedTime, &m_buffer[coeff_pos], componentsCount,
-			resultArray);
-		break;
-		
-	default:
-		memset(resultArray, 0, componentsCount * sizeof(double));
-	}		
-}
+		if (series.order == NULL)
+		{
+			if (release.calculateSeries(series.calculationResult, series.targetBody,
+				series.centerBody, series.JEDs + first, count, series.componentsCount,
+					series.resultArray + first * series.componentsCount, context) == false)
+			{
+				self.isFailed = true;
+			}
 
-void dph::EphemerisRelease::calculateBaseEarth(double JED, unsigned calculationResult, 
-	double* resultArray) const
-{
-	// Получение радиус-вектора (или вектора состояния) барицентра сиситемы Земля-Луна
-	// относительно барицентра Солнечной Системы:
-	calculateBaseItem(2, JED, calculationResult, resultArray);
+			continue;
+		}
 
-	// Получение радиус-вектора (или вектора состояния) Луны относитльно Земли:
-	double MoonRelativeEarth[6];
-	calculateBaseItem(9, JED, calculationResult, MoonRelativeEarth);
+		const size_t* order = series.order + first;
 
-	// Количество компонент:
-	unsigned componentsCount = calculationResult == Calculate::POSITION ? 3 : 6;
+		for (size_t i = 0; i < count; ++i)
+		{
+			JEDs[i] = series.JEDs[order[i]];
+		}
 
-	// Опредление положения Земли относительно барицентра Солнечной Системы:
-	for (unsigned i = 0; i < componentsCount; ++i)
-	{
-		resultArray[i] -= MoonRelativeEarth[i] * m_emrat2;
+		if (release.calculateSeries(series.calculationResult, series.targetBody,
+			series.centerBody, &JEDs[0], count, series.componentsCount, &results[0],
+				context) == false)
+		{
+			self.isFailed = true;
+
+			continue;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			std::memcpy(series.resultArray + order[i] * series.componentsCount,
+				&results[i * series.componentsCount], 
+					series.componentsCount * sizeof(double));
+		}
 	}
 }
 
-void dph::EphemerisRelease::calculateBaseMoon(double JED, unsigned calculationResult,
-	double* resultArray) const
+bool dph::EphemerisRelease::calculateBodyChunk(unsigned calculationResult, 
+	unsigned targetBody, unsigned centerBody, const double* JEDs, size_t count,
+		double* resultArray, CalculationContext& context) const
 {
-	// Получение радиус-вектора (или вектора состояния) барицентра сиситемы Земля-Луна
-	// относительно барицентра Солнечной Системы:
-	calculateBaseItem(2, JED, calculationResult, resultArray);
+	// Ветвление повторяет calculateBody(...), но выполняется один раз на пакет.
 
-	// Получение радиус-вектора (или вектора состояния) Луны относитльно Земли:
-	double MoonRelativeEarth[6];
-	calculateBaseItem(9, JED, calculationResult, MoonRelativeEarth);
+	// Количество значений результата для всего пакета:
+	size_t valuesCount = count * (calculationResult == Calculate::STATE ? 6 : 3);
 
-	// Количество компонент:
-	unsigned componentsCount = calculationResult == Calculate::POSITION ? 3 : 6;
+	if (targetBody == centerBody)
+	{
+		std::memset(resultArray, 0, sizeof(double) * valuesCount);
+	}
+	else if (targetBody == Body::SSBARY || centerBody == Body::SSBARY)
+	{
+		unsigned notSSBARY = targetBody == Body::SSBARY ? centerBody : targetBody;
 
-	// Определение относительного положения:
-	for (unsigned i = 0; i < componentsCount; ++i)
+		if (calculateBaseBodyChunk(notSSBARY, JEDs, count, calculationResult, 
+			resultArray, context) == false)
+		{
+			return false;
+		}
+
+		if (targetBody == Body::SSBARY)
+		{
+			for (size_t i = 0; i < valuesCount; ++i)
+			{
+				resultArray[i] = -resultArray[i];
+			}
+		}
+	}
+	else if (targetBody * centerBody == 30 && targetBody + centerBody == 13)
 	{
-		resultArray[i] += MoonRelativeEarth[i] * (1 - m_emrat2);
-	}	
+		if (calculateBaseItemChunk(9, JEDs, count, calculationResult, resultArray, 
+			context) == false)
+		{
+			return false;
+		}
+
+		if (targetBody == Body::EARTH)
+		{
+			for (size_t i = 0; i < valuesCount; ++i)
+			{
+				resultArray[i] = -resultArray[i];
+			}
+		}
+	}
+	else
+	{
+		double centerBodyArray[SERIES_CHUNK_SIZE * 6];
+
+		if (calculateBaseBodyChunk(centerBody, JEDs, count, calculationResult, 
+				centerBodyArray, context) == false ||
+			calculateBaseBodyChunk(targetBody, JEDs, count, calculationResult, 
+				resultArray, context) == false)
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < valuesCount; ++i)
+		{
+			resultArray[i] -= centerBodyArray[i];
+		}
+	}
+
+	return true;
 }
 
 #endif // DEPHEM_EPHEMERIS_RELEASE_HPP
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef DEPHEM_EPOCH_HPP
+#define DEPHEM_EPOCH_HPP
+
+#include <cstddef>
+
+namespace dph
+{
+
+class EphemerisRelease;
+
+// ************************************************************************** //
+//                                  Epoch                                     //
+//                                                                            //
+//                  Момент времени, привязанный к блоку выпуска               //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Объект данного класса хранит момент времени в виде, готовом для            //
+// вычислений: порядковый номер блока выпуска и нормированное время внутри    //
+// блока. Создаётся методом dph::EphemerisRelease::makeEpoch(...), в том      //
+// числе по двухчастной Юлианской дате (JED = JED1 + JED2), и передаётся в    //
+// методы calculateBody/calculateOther вместо JED.                            //
+//                                                                            //
+// При вычислении нескольких тел на один момент времени номер блока и время   //
+// внутри него определяются один раз. Время внутри блока вычисляется от даты  //
+// начала блока, поэтому точность двухчастной даты не теряется (для одного    //
+// числа double при JED ~ 2.45e6 шаг составляет около 40 мкс).                //
+//                                                                            //
+// Момент подходит для любого выпуска с теми же датой начала и длительностью  //
+// блока (например, для копий выпуска). Для остальных выпусков вычисления не  //
+// выполняются.                                                               //
+//                                                                            //
+// ************************************************************************** //
+class Epoch
+{
+public:
+
+	// Конструктор по умолчанию (момент не задан).
+	Epoch();
+
+	// Задан ли момент.
+	bool isValid() const;
+
+	// Момент времени в формате JED (одним числом).
+	double JED() const;
+
+private:
+
+	friend class EphemerisRelease;
+
+	double	m_JED;				// Момент времени (одним числом).
+	double	m_startDate;		// Дата начала выпуска.
+	double	m_blockTimeSpan;	// Временная протяжённость блока выпуска.
+	size_t	m_blockIndex;		// Порядковый номер блока.
+
+	// Нормированное время внутри блока: [0 : 1]. Значение 1 - конец блока
+	// (например, дата окончания выпуска).
+	double	m_blockTime;
+};
+
+} // namespace dph
+
+dph::Epoch::Epoch()
+{
+	m_JED = 0;
+	m_startDate = 0;
+	m_blockTimeSpan = 0;
+	m_blockIndex = 0;
+	m_blockTime = 0;
+}
+
+bool dph::Epoch::isValid() const
+{
+	return m_blockTimeSpan != 0;
+}
+
+double dph::Epoch::JED() const
+{
+	return m_JED;
+}
+
+#endif // DEPHEM_EPOCH_HPP
@@ -0,0 +1,641 @@
+#ifndef DEPHEM_LOADED_FILE_HPP
+#define DEPHEM_LOADED_FILE_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Thread.hpp"
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                                LoadedFile                                  //
+//                                                                            //
+//                  Содержимое файла, загруженное в память                    //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс, считывающий файл целиком в одну непрерывную         //
+// область памяти. После загрузки обращения к файлу не выполняются.           //
+//                                                                            //
+// Память выделяется страницами (mmap / VirtualAlloc), поэтому начало         //
+// области выровнено не менее чем на ALIGNMENT байт. По запросу используются  //
+// большие страницы:                                                          //
+//    - Linux:   MAP_HUGETLB, при неудаче - прозрачные большие страницы       //
+//               (madvise(MADV_HUGEPAGE));                                    //
+//    - Windows: MEM_LARGE_PAGES (требуется привилегия SeLockMemoryPrivilege).//
+// Если большие страницы недоступны, используются обычные.                    //
+//                                                                            //
+// Файл читается параллельно несколькими потоками (dph::Thread), каждый       //
+// поток читает свою непрерывную часть файла.                                 //
+//                                                                            //
+// Файл, состоящий из записей одного размера, можно загрузить выборочно       //
+// (loadRecords(...)): из каждой записи в памяти сохраняются только заданные  //
+// участки, записи располагаются подряд. Файл при этом читается целиком       //
+// (порциями), но занимает в памяти только выбранные участки.                 //
+//                                                                            //
+// Объект не копируется.                                                      //
+//                                                                            //
+// ************************************************************************** //
+class LoadedFile
+{
+public:
+
+	// Минимальное выравнивание начала загруженной области (байт).
+	static const size_t ALIGNMENT = 64;
+
+	// Максимальное количество участков записи (см. RecordSelection).
+	static const size_t MAX_RANGES = 16;
+
+	// Участки записей, загружаемые loadRecords(...).
+	struct RecordSelection
+	{
+		size_t recordSize;				// Размер записи (байт).
+		size_t rangesCount;				// Количество участков.
+		size_t ranges[MAX_RANGES][2];	// Смещения и размеры участков (байт).
+	};
+
+	// Конструктор по умолчанию (файл не загружен).
+	LoadedFile();
+
+	// Деструктор (освобождение памяти).
+	~LoadedFile();
+
+	// Загрузить файл по пути "filePath" с помощью "threadsCount" потоков
+	// (0 - по количеству логических процессоров). Если "hugePages" - true,
+	// то для области памяти запрашиваются большие страницы. Предыдущая
+	// загрузка освобождается. Возвращает true в случае успеха.
+	bool load(const std::string& filePath, unsigned threadsCount, bool hugePages);
+
+	// Загрузить из файла "filePath" участки "selection" каждой из
+	// "recordsCount" записей, первая из которых начинается со смещения
+	// "offset". Участки записей располагаются в памяти подряд, в порядке
+	// записей. Параметры "threadsCount" и "hugePages" - как у load(...).
+	// Возвращает false, если файл короче требуемого.
+	bool loadRecords(const std::string& filePath, size_t offset, size_t recordsCount,
+		const RecordSelection& selection, unsigned threadsCount, bool hugePages);
+
+	// Освободить память.
+	void close();
+
+	// Файл загружен?
+	bool isOpen() const;
+
+	// Указатель на начало загруженного файла.
+	const char* data() const;
+
+	// Размер загруженного файла (выбранных участков записей) в байтах.
+	size_t size() const;
+
+	// Область памяти расположена на больших страницах?
+	bool hugePages() const;
+
+private:
+
+	// Запрет на копирование.
+	LoadedFile(const LoadedFile&);
+	LoadedFile& operator=(const LoadedFile&);
+
+#ifdef _WIN32
+	typedef HANDLE	FileHandle;	// Дескриптор файла.
+#else
+	typedef int		FileHandle;	// Дескриптор файла.
+#endif
+
+	// Часть файла, загружаемая одним потоком.
+	struct Part
+	{
+		FileHandle	file;			// Дескриптор файла.
+		char*		destination;	// Куда читать.
+		size_t		offset;			// Смещение части от начала файла.
+		size_t		size;			// Размер части.
+		bool		isRead;			// Часть прочитана полностью?
+
+		// Участки записей (NULL - часть читается целиком). Часть состоит из
+		// целого количества записей.
+		const RecordSelection* selection;
+	};
+
+	// Открыть файл "filePath" и определить его размер "size".
+	static bool openFile(const std::string& filePath, FileHandle& file, size_t& size);
+
+	// Закрыть файл "file".
+	static void closeFile(FileHandle file);
+
+	// Прочитать "size" байт файла "file" со смещения "offset" в "destination".
+	static bool readAt(FileHandle file, char* destination, size_t offset, size_t size);
+
+	// Чтение части файла (выполняется в потоке, "part" - указатель на Part).
+	static void readPart(void* part);
+
+	// Прочитать части "parts" (количество - "partsCount") параллельно.
+	// Возвращает true, если все части прочитаны полностью.
+	static bool readParts(Part* parts, size_t partsCount);
+
+	// Количество частей для загрузки "size" байт "threadsCount" потоками.
+	static size_t partsCountOf(size_t size, unsigned threadsCount);
+
+	// Выделить "size" байт (по возможности на больших страницах).
+	bool allocate(size_t size, bool hugePages);
+
+	char*	m_data;			// Начало области памяти.
+	size_t	m_size;			// Размер файла в байтах.
+	size_t	m_capacity;		// Размер выделенной области в байтах.
+	bool	m_hugePages;	// Используются большие страницы?
+};
+
+} // namespace dph
+
+dph::LoadedFile::LoadedFile()
+	: m_data(NULL), m_size(0), m_capacity(0), m_hugePages(false)
+{
+}
+
+dph::LoadedFile::~LoadedFile()
+{
+	close();
+}
+
+bool dph::LoadedFile::load(const std::string& filePath, unsigned threadsCount,
+	bool hugePages)
+{
+	close();
+
+	// Открытие файла и определение его размера:
+	FileHandle file;
+	size_t size = 0;
+
+	if (openFile(filePath, file, size) == false)
+	{
+		return false;
+	}
+
+	if (allocate(size, hugePages) == false)
+	{
+		closeFile(file);
+		return false;
+	}
+
+	m_size = size;
+
+	// Разбиение файла на части по количеству потоков:
+	size_t partsCount = partsCountOf(size, threadsCount);
+
+	Part* parts = new Part[partsCount];
+
+	size_t partSize = size / partsCount;
+
+	for (size_t i = 0; i < partsCount; ++i)
+	{
+		parts[i].file = file;
+		parts[i].offset = i * partSize;
+		parts[i].size = i + 1 == partsCount ? size - parts[i].offset : partSize;
+		parts[i].destination = m_data + parts[i].offset;
+		parts[i].isRead = false;
+		parts[i].selection = NULL;
+	}
+
+	bool isRead = readParts(parts, partsCount);
+
+	delete[] parts;
+
+	closeFile(file);
+
+	if (isRead == false)
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+bool dph::LoadedFile::loadRecords(const std::string& filePath, size_t offset,
+	size_t recordsCount, const RecordSelection& selection, unsigned threadsCount,
+		bool hugePages)
+{
+	close();
+
+	// Размер выбранных участков одной записи:
+	size_t selectedSize = 0;
+
+	if (selection.rangesCount == 0 || selection.rangesCount > MAX_RANGES)
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < selection.rangesCount; ++i)
+	{
+		if (selection.ranges[i][0] + selection.ranges[i][1] > selection.recordSize)
+		{
+			return false;
+		}
+
+		selectedSize += selection.ranges[i][1];
+	}
+
+	if (recordsCount == 0 || selectedSize == 0)
+	{
+		return false;
+	}
+
+	FileHandle file;
+	size_t size = 0;
+
+	if (openFile(filePath, file, size) == false)
+	{
+		return false;
+	}
+
+	// Все записи должны умещаться в файле:
+	if (offset > size || (size - offset) / selection.recordSize < recordsCount ||
+		allocate(recordsCount * selectedSize, hugePages) == false)
+	{
+		closeFile(file);
+		return false;
+	}
+
+	m_size = recordsCount * selectedSize;
+
+	// Разбиение записей на части по количеству потоков (по размеру читаемой
+	// части файла):
+	size_t partsCount = partsCountOf(recordsCount * selection.recordSize, threadsCount);
+
+	if (partsCount > recordsCount)
+	{
+		partsCount = recordsCount;
+	}
+
+	Part* parts = new Part[partsCount];
+
+	size_t partRecords = recordsCount / partsCount;
+
+	for (size_t i = 0; i < partsCount; ++i)
+	{
+		size_t firstRecord = i * partRecords;
+		size_t count = i + 1 == partsCount ? recordsCount - firstRecord : partRecords;
+
+		parts[i].file = file;
+		parts[i].offset = offset + firstRecord * selection.recordSize;
+		parts[i].size = count * selection.recordSize;
+		parts[i].destination = m_data + firstRecord * selectedSize;
+		parts[i].isRead = false;
+		parts[i].selection = &selection;
+	}
+
+	bool isRead = readParts(parts, partsCount);
+
+	delete[] parts;
+
+	closeFile(file);
+
+	if (isRead == false)
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void dph::LoadedFile::close()
+{
+	if (m_data != NULL)
+	{
+#ifdef _WIN32
+		VirtualFree(m_data, 0, MEM_RELEASE);
+#else
+		munmap(m_data, m_capacity);
+#endif
+	}
+
+	m_data = NULL;
+	m_size = 0;
+	m_capacity = 0;
+	m_hugePages = false;
+}
+
+bool dph::LoadedFile::isOpen() const
+{
+	return m_data != NULL;
+}
+
+const char* dph::LoadedFile::data() const
+{
+	return m_data;
+}
+
+size_t dph::LoadedFile::size() const
+{
+	return m_size;
+}
+
+bool dph::LoadedFile::hugePages() const
+{
+	return m_hugePages;
+}
+
+bool dph::LoadedFile::openFile(const std::string& filePath, FileHandle& file,
+	size_t& size)
+{
+#ifdef _WIN32
+	file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+
+	if (GetFileSizeEx(file, &fileSize) == 0 || fileSize.QuadPart == 0 ||
+		static_cast<unsigned long long>(fileSize.QuadPart) > size_t(-1))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	file = ::open(filePath.c_str(), O_RDONLY);
+
+	if (file == -1)
+	{
+		return false;
+	}
+
+	struct stat fileInfo;
+
+	if (fstat(file, &fileInfo) != 0 || fileInfo.st_size <= 0)
+	{
+		::close(file);
+		return false;
+	}
+
+	size = static_cast<size_t>(fileInfo.st_size);
+#endif
+
+	return true;
+}
+
+void dph::LoadedFile::closeFile(FileHandle file)
+{
+#ifdef _WIN32
+	CloseHandle(file);
+#else
+	::close(file);
+#endif
+}
+
+bool dph::LoadedFile::readAt(FileHandle file, char* destination, size_t offset,
+	size_t size)
+{
+	size_t done = 0;
+
+	while (done < size)
+	{
+		// Чтение порциями не более 1 Гб:
+		size_t portion = size - done < (1u << 30) ? size - done : (1u << 30);
+
+#ifdef _WIN32
+		unsigned long long position = offset + done;
+
+		OVERLAPPED overlapped;
+		ZeroMemory(&overlapped, sizeof(overlapped));
+		overlapped.Offset = static_cast<DWORD>(position & 0xFFFFFFFF);
+		overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+		DWORD count = 0;
+
+		if (ReadFile(file, destination + done, static_cast<DWORD>(portion), &count,
+			&overlapped) == 0 || count == 0)
+		{
+			return false;
+		}
+#else
+		ssize_t count = pread(file, destination + done, portion,
+			static_cast<off_t>(offset + done));
+
+		if (count < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		else if (count <= 0)
+		{
+			return false;
+		}
+#endif
+
+		done += static_cast<size_t>(count);
+	}
+
+	return true;
+}
+
+void dph::LoadedFile::readPart(void* part)
+{
+	Part& p = *static_cast<Part*>(part);
+
+	if (p.selection == NULL)
+	{
+		p.isRead = readAt(p.file, p.destination, p.offset, p.size);
+
+		return;
+	}
+
+	// Записи читаются порциями (не менее одной записи) во временный буффер,
+	// из которого копируются выбранные участки:
+	const RecordSelection& selection = *p.selection;
+
+	const size_t PORTION_SIZE = 4 * 1024 * 1024;
+
+	size_t portionRecords = PORTION_SIZE / selection.recordSize;
+
+	if (portionRecords == 0)
+	{
+		portionRecords = 1;
+	}
+
+	size_t recordsCount = p.size / selection.recordSize;
+
+	std::vector<char> buffer((recordsCount < portionRecords ? recordsCount : 
+		portionRecords) * selection.recordSize);
+
+	char* destination = p.destination;
+
+	for (size_t first = 0; first < recordsCount; first += portionRecords)
+	{
+		size_t count = recordsCount - first < portionRecords ? recordsCount - first : 
+			portionRecords;
+
+		if (readAt(p.file, &buffer[0], p.offset + first * selection.recordSize,
+			count * selection.recordSize) == false)
+		{
+			return;
+		}
+
+		for (size_t r = 0; r < count; ++r)
+		{
+			const char* record = &buffer[r * selection.recordSize];
+
+			for (size_t i = 0; i < selection.rangesCount; ++i)
+			{
+				std::memcpy(destination, record + selection.ranges[i][0], 
+					selection.ranges[i][1]);
+
+				destination += selection.ranges[i][1];
+			}
+		}
+	}
+
+	p.isRead = true;
+}
+
+bool dph::LoadedFile::readParts(Part* parts, size_t partsCount)
+{
+	Thread* threads = new Thread[partsCount];
+
+	// Первая часть читается в текущем потоке, остальные - в отдельных (если
+	// поток запустить не удалось, часть также читается в текущем потоке):
+	for (size_t i = 1; i < partsCount; ++i)
+	{
+		if (threads[i].start(readPart, &parts[i]) == false)
+		{
+			readPart(&parts[i]);
+		}
+	}
+
+	readPart(&parts[0]);
+
+	bool isRead = true;
+
+	for (size_t i = 0; i < partsCount; ++i)
+	{
+		threads[i].join();
+
+		isRead = isRead && parts[i].isRead;
+	}
+
+	delete[] threads;
+
+	return isRead;
+}
+
+size_t dph::LoadedFile::partsCountOf(size_t size, unsigned threadsCount)
+{
+	// Части не короче MIN_PART_SIZE, чтобы не запускать потоки ради малых
+	// файлов:
+	const size_t MIN_PART_SIZE = 16 * 1024 * 1024;
+
+	if (threadsCount == 0)
+	{
+		threadsCount = Thread::hardwareConcurrency();
+	}
+
+	size_t partsCount = size / MIN_PART_SIZE + 1;
+
+	if (partsCount > threadsCount)
+	{
+		partsCount = threadsCount;
+	}
+
+	return partsCount == 0 ? 1 : partsCount;
+}
+
+bool dph::LoadedFile::allocate(size_t size, bool hugePages)
+{
+#ifdef _WIN32
+	if (hugePages)
+	{
+		SIZE_T largePageSize = GetLargePageMinimum();
+
+		if (largePageSize != 0)
+		{
+			size_t capacity = (size + largePageSize - 1) / largePageSize * largePageSize;
+
+			m_data = static_cast<char*>(VirtualAlloc(NULL, capacity,
+				MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE));
+
+			if (m_data != NULL)
+			{
+				m_capacity = capacity;
+				m_hugePages = true;
+
+				return true;
+			}
+		}
+	}
+
+	m_data = static_cast<char*>(VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT,
+		PAGE_READWRITE));
+
+	m_capacity = size;
+#else
+	void* address = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+	if (hugePages)
+	{
+		// Размер кратен большой странице (2 Мб):
+		const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+		size_t capacity = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+
+		address = mmap(NULL, capacity, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+		if (address != MAP_FAILED)
+		{
+			m_data = static_cast<char*>(address);
+			m_capacity = capacity;
+			m_hugePages = true;
+
+			return true;
+		}
+	}
+#endif
+
+	address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+		-1, 0);
+
+	if (address == MAP_FAILED)
+	{
+		return false;
+	}
+
+	m_data = static_cast<char*>(address);
+	m_capacity = size;
+
+#ifdef MADV_HUGEPAGE
+	// Прозрачные большие страницы (до заполнения области):
+	if (hugePages)
+	{
+		m_hugePages = madvise(address, size, MADV_HUGEPAGE) == 0;
+	}
+#endif
+#endif
+
+	return m_data != NULL;
+}
+
+#endif // DEPHEM_LOADED_FILE_HPP
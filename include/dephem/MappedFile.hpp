@@ -0,0 +1,248 @@
+#ifndef DEPHEM_MAPPED_FILE_HPP
+#define DEPHEM_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                                MappedFile                                  //
+//                                                                            //
+//             Отображение файла в память (только для чтения)                 //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс для доступа к содержимому файла через отображение    //
+// в адресное пространство процесса (mmap / MapViewOfFile).                   //
+//                                                                            //
+// Отображение разделяемое: несколько объектов (и процессов), отобразивших    //
+// один и тот же файл, используют одну копию страниц в кэше ОС.               //
+//                                                                            //
+// Объект не копируется.                                                      //
+//                                                                            //
+// ************************************************************************** //
+class MappedFile
+{
+public:
+
+	// Конструктор по умолчанию (файл не отображён).
+	MappedFile();
+
+	// Деструктор (снятие отображения).
+	~MappedFile();
+
+	// Отобразить файл по пути "filePath". Предыдущее отображение снимается.
+	// Возвращает true в случае успеха.
+	bool open(const std::string& filePath);
+
+	// Снять отображение.
+	void close();
+
+	// Файл отображён?
+	bool isOpen() const;
+
+	// Указатель на начало отображённого файла.
+	const char* data() const;
+
+	// Размер отображённого файла в байтах.
+	size_t size() const;
+
+	// Запросить фоновую загрузку в память "size" байт отображения, начиная с
+	// "offset" (madvise с MADV_WILLNEED, PrefetchVirtualMemory). Вызов не
+	// ожидает окончания загрузки.
+	void willNeed(size_t offset, size_t size) const;
+
+private:
+
+	// Запрет на копирование.
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	const char*	m_data;	// Начало отображения.
+	size_t		m_size;	// Размер отображения в байтах.
+
+#ifdef _WIN32
+	HANDLE m_file;		// Дескриптор файла.
+	HANDLE m_mapping;	// Дескриптор объекта отображения.
+#endif
+};
+
+} // namespace dph
+
+dph::MappedFile::MappedFile()
+	: m_data(NULL), m_size(0)
+#ifdef _WIN32
+	, m_file(INVALID_HANDLE_VALUE), m_mapping(NULL)
+#endif
+{
+}
+
+dph::MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool dph::MappedFile::open(const std::string& filePath)
+{
+	close();
+
+#ifdef _WIN32
+	m_file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (m_file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+
+	if (GetFileSizeEx(m_file, &fileSize) == 0 || fileSize.QuadPart == 0 ||
+		static_cast<unsigned long long>(fileSize.QuadPart) > size_t(-1))
+	{
+		close();
+		return false;
+	}
+
+	m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+	if (m_mapping == NULL)
+	{
+		close();
+		return false;
+	}
+
+	m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+
+	if (m_data == NULL)
+	{
+		close();
+		return false;
+	}
+
+	m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int fd = ::open(filePath.c_str(), O_RDONLY);
+
+	if (fd == -1)
+	{
+		return false;
+	}
+
+	struct stat fileInfo;
+
+	if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size <= 0)
+	{
+		::close(fd);
+		return false;
+	}
+
+	void* address = mmap(NULL, static_cast<size_t>(fileInfo.st_size), PROT_READ,
+		MAP_SHARED, fd, 0);
+
+	// Отображение остаётся действительным и после закрытия дескриптора:
+	::close(fd);
+
+	if (address == MAP_FAILED)
+	{
+		return false;
+	}
+
+	m_data = static_cast<const char*>(address);
+	m_size = static_cast<size_t>(fileInfo.st_size);
+#endif
+
+	return true;
+}
+
+void dph::MappedFile::close()
+{
+#ifdef _WIN32
+	if (m_data != NULL)
+	{
+		UnmapViewOfFile(m_data);
+	}
+
+	if (m_mapping != NULL)
+	{
+		CloseHandle(m_mapping);
+	}
+
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_file);
+	}
+
+	m_file = INVALID_HANDLE_VALUE;
+	m_mapping = NULL;
+#else
+	if (m_data != NULL)
+	{
+		munmap(const_cast<char*>(m_data), m_size);
+	}
+#endif
+
+	m_data = NULL;
+	m_size = 0;
+}
+
+bool dph::MappedFile::isOpen() const
+{
+	return m_data != NULL;
+}
+
+const char* dph::MappedFile::data() const
+{
+	return m_data;
+}
+
+size_t dph::MappedFile::size() const
+{
+	return m_size;
+}
+
+void dph::MappedFile::willNeed(size_t offset, size_t size) const
+{
+	if (m_data == NULL || offset >= m_size)
+	{
+		return;
+	}
+
+	size = size > m_size - offset ? m_size - offset : size;
+
+#ifdef _WIN32
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+	WIN32_MEMORY_RANGE_ENTRY range;
+	range.VirtualAddress = const_cast<char*>(m_data + offset);
+	range.NumberOfBytes = size;
+
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#endif
+#elif defined(MADV_WILLNEED)
+	// Адрес должен быть выровнен по границе страницы:
+	size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t alignedOffset = offset - offset % pageSize;
+
+	madvise(const_cast<char*>(m_data + alignedOffset), size + offset - alignedOffset,
+		MADV_WILLNEED);
+#endif
+}
+
+#endif // DEPHEM_MAPPED_FILE_HPP
@@ -0,0 +1,113 @@
+#ifndef DEPHEM_PACKED_FORMAT_HPP
+#define DEPHEM_PACKED_FORMAT_HPP
+
+#include <cstring>
+#include <istream>
+#include <stdint.h>
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                               PackedFormat                                 //
+//                                                                            //
+//                  Упакованный формат файла эфемерид (dephem)                //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// В формате JPL коэффициенты всех элементов чередуются внутри каждого блока  //
+// (записи), поэтому коэффициенты одного элемента для соседних блоков         //
+// разнесены на размер записи (ncoeff * 8 байт). Упакованный формат хранит    //
+// коэффициенты каждого базового элемента отдельным массивом, непрерывным по  //
+// времени: блок за блоком. Начало каждого массива и каждой записи элемента   //
+// выровнено на ALIGNMENT байт.                                               //
+//                                                                            //
+// Структура файла (смещения - от начала файла, в байтах):                    //
+//    - Header             : заголовок-индекс (см. ниже);                     //
+//    - jplHeaderOffset    : заголовок и блок констант исходного файла JPL    //
+//                           без изменений (2 * ncoeff * 8 байт);             //
+//    - datesOffset        : даты начала и окончания блоков (по 2 double на   //
+//                           блок);                                           //
+//    - itemOffsets[i]     : коэффициенты элемента i, запись блока b          //
+//                           начинается с itemOffsets[i] + b * itemStrides[i].//
+//                           Для отсутствующих элементов - 0.                 //
+//                                                                            //
+// Числа записаны в порядке байт платформы, на которой создан файл (как и в   //
+// файлах JPL). Файл создаётся dph::PackedWriter и открывается                //
+// dph::EphemerisRelease через отображение в память (без разбора и            //
+// копирования коэффициентов).                                                //
+//                                                                            //
+// ************************************************************************** //
+class PackedFormat
+{
+public:
+
+	// Версия формата.
+	static const uint32_t VERSION = 1;
+
+	// Выравнивание массивов и записей элементов (байт).
+	static const uint64_t ALIGNMENT = 64;
+
+	// Заголовок-индекс упакованного файла.
+	struct Header
+	{
+		char		magic[8];			// Сигнатура "DEPHPACK".
+		uint32_t	version;			// Версия формата (VERSION).
+		uint32_t	ncoeff;				// Количество коэффициентов в записи JPL.
+		uint64_t	blocksCount;		// Количество блоков.
+		uint64_t	jplHeaderOffset;	// Смещение заголовка JPL.
+		uint64_t	datesOffset;		// Смещение дат блоков.
+		uint64_t	itemOffsets[15];	// Смещения массивов элементов.
+		uint64_t	itemStrides[15];	// Шаг между записями элемента (байт).
+		uint64_t	fileSize;			// Размер файла (байт).
+	};
+
+	// Заполнить сигнатуру и версию заголовка "header".
+	static void initHeader(Header& header);
+
+	// Заголовок "header" - заголовок упакованного файла поддерживаемой версии?
+	static bool isHeader(const Header& header);
+
+	// Прочитать заголовок упакованного файла из начала потока "stream".
+	// Возвращает false, если файл не упакованного формата (позиция потока
+	// и флаги ошибок при этом сбрасываются).
+	static bool readHeader(std::istream& stream, Header& header);
+
+	// Размер "size", округлённый вверх до ALIGNMENT.
+	static uint64_t align(uint64_t size);
+};
+
+} // namespace dph
+
+void dph::PackedFormat::initHeader(Header& header)
+{
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, "DEPHPACK", sizeof(header.magic));
+	header.version = VERSION;
+}
+
+bool dph::PackedFormat::isHeader(const Header& header)
+{
+	return std::memcmp(header.magic, "DEPHPACK", sizeof(header.magic)) == 0 &&
+		header.version == VERSION;
+}
+
+bool dph::PackedFormat::readHeader(std::istream& stream, Header& header)
+{
+	stream.seekg(0, std::ios::beg);
+	stream.read((char*)&header, sizeof(header));
+
+	bool isPacked = stream.good() && isHeader(header);
+
+	stream.clear();
+	stream.seekg(0, std::ios::beg);
+
+	return isPacked;
+}
+
+uint64_t dph::PackedFormat::align(uint64_t size)
+{
+	return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+#endif // DEPHEM_PACKED_FORMAT_HPP
@@ -0,0 +1,210 @@
+#ifndef DEPHEM_PACKED_WRITER_HPP
+#define DEPHEM_PACKED_WRITER_HPP
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "EphemerisRelease.hpp"
+#include "PackedFormat.hpp"
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                               PackedWriter                                 //
+//                                                                            //
+//               Запись выпуска эфемерид в упакованном формате                //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс для преобразования выпуска эфемерид (файла формата   //
+// JPL или упакованного файла) в упакованный формат dph::PackedFormat.        //
+//                                                                            //
+// Коэффициенты копируются без изменений, поэтому результаты вычислений по    //
+// исходному и упакованному файлам совпадают. Заголовок и константы исходного //
+// файла сохраняются. Блоки исходного выпуска читаются один раз, по порядку.  //
+// Выпуск должен быть открыт без выбора элементов (см.                        //
+// dph::ReleaseOptions::items).                                               //
+//                                                                            //
+// ************************************************************************** //
+class PackedWriter
+{
+public:
+
+	// Записать выпуск "release" в файл "packedFilePath" в упакованном
+	// формате. Возвращает false, если выпуск не готов или файл не удалось
+	// записать (частично записанный файл удаляется).
+	static bool write(const EphemerisRelease& release, const std::string& packedFilePath);
+
+private:
+
+	// Записать "size" нулевых байт в поток "stream".
+	static void writeZeros(std::ofstream& stream, uint64_t size);
+};
+
+} // namespace dph
+
+bool dph::PackedWriter::write(const EphemerisRelease& release,
+	const std::string& packedFilePath)
+{
+	if (release.isReady() == false || release.m_blocksCount == 0)
+	{
+		return false;
+	}
+
+	// ------------------------------- Заголовок JPL -------------------------------- //
+
+	// Заголовок и блок констант исходного файла (две записи JPL):
+	std::vector<char> jplHeader(2 * release.m_ncoeff * sizeof(double));
+
+	std::ifstream source(release.m_binaryFilePath.c_str(), std::ios::binary);
+
+	PackedFormat::Header sourceHeader;
+	std::streamoff sourceOffset = PackedFormat::readHeader(source, sourceHeader) ?
+		static_cast<std::streamoff>(sourceHeader.jplHeaderOffset) : 0;
+
+	source.seekg(sourceOffset, std::ios::beg);
+	source.read(&jplHeader[0], static_cast<std::streamsize>(jplHeader.size()));
+
+	if (source.good() == false)
+	{
+		return false;
+	}
+
+	source.close();
+
+	// ------------------------------ Расположение ---------------------------------- //
+
+	uint64_t blocksCount = release.m_blocksCount;
+
+	PackedFormat::Header header;
+	PackedFormat::initHeader(header);
+
+	header.ncoeff = release.m_ncoeff;
+	header.blocksCount = blocksCount;
+	header.jplHeaderOffset = PackedFormat::align(sizeof(header));
+	header.datesOffset = PackedFormat::align(header.jplHeaderOffset + jplHeader.size());
+
+	uint64_t position = PackedFormat::align(header.datesOffset +
+		blocksCount * 2 * sizeof(double));
+
+	// Размеры записей элементов (байт):
+	uint64_t itemSizes[15];
+
+	for (unsigned i = 0; i < 15; ++i)
+	{
+		itemSizes[i] = (i == 11 ? 2 : i == 14 ? 1 : 3) * uint64_t(release.m_keys[i][1]) *
+			release.m_keys[i][2] * sizeof(double);
+
+		// Записываются все элементы выпуска, поэтому все они должны быть
+		// доступны (см. dph::ReleaseOptions::items):
+		if (itemSizes[i] != 0 && ((release.m_residentItems >> i) & 1) == 0)
+		{
+			return false;
+		}
+
+		if (itemSizes[i] != 0)
+		{
+			header.itemOffsets[i] = position;
+			header.itemStrides[i] = PackedFormat::align(itemSizes[i]);
+
+			position += header.itemStrides[i] * blocksCount;
+		}
+	}
+
+	header.fileSize = position;
+
+	// ---------------------------------- Запись ------------------------------------ //
+
+	std::ofstream file(packedFilePath.c_str(), std::ios::binary);
+
+	if (file.is_open() == false)
+	{
+		return false;
+	}
+
+	file.write((const char*)&header, sizeof(header));
+	writeZeros(file, header.jplHeaderOffset - sizeof(header));
+
+	file.write(&jplHeader[0], static_cast<std::streamsize>(jplHeader.size()));
+	writeZeros(file, header.datesOffset - header.jplHeaderOffset - jplHeader.size());
+
+	// Блоки читаются через отдельный контекст (объект выпуска не изменяется).
+	// Даты блока записываются подряд, записи элементов - по своим смещениям:
+	CalculationContext context;
+
+	if (release.bindContext(context) == false)
+	{
+		file.close();
+		std::remove(packedFilePath.c_str());
+
+		return false;
+	}
+
+	for (uint64_t b = 0; b < blocksCount && file.good(); ++b)
+	{
+		const double* block = release.loadBlock(static_cast<size_t>(b), context);
+
+		if (block == NULL)
+		{
+			file.setstate(std::ios::failbit);
+			break;
+		}
+
+		file.seekp(static_cast<std::streamoff>(header.datesOffset + b * 2 * sizeof(double)),
+			std::ios::beg);
+		file.write((const char*)block, 2 * sizeof(double));
+
+		for (unsigned i = 0; i < 15; ++i)
+		{
+			if (itemSizes[i] == 0)
+			{
+				continue;
+			}
+
+			file.seekp(static_cast<std::streamoff>(header.itemOffsets[i] +
+				b * header.itemStrides[i]), std::ios::beg);
+			file.write((const char*)release.itemBlock(i, context),
+				static_cast<std::streamsize>(itemSizes[i]));
+			writeZeros(file, header.itemStrides[i] - itemSizes[i]);
+		}
+	}
+
+	// Выравнивание после массива дат (если за ним нет элементов):
+	file.seekp(0, std::ios::end);
+
+	uint64_t writtenSize = static_cast<uint64_t>(file.tellp());
+
+	if (file.good() && writtenSize < header.fileSize)
+	{
+		writeZeros(file, header.fileSize - writtenSize);
+	}
+
+	bool isWritten = file.good();
+
+	file.close();
+
+	if (isWritten == false)
+	{
+		std::remove(packedFilePath.c_str());
+	}
+
+	return isWritten;
+}
+
+void dph::PackedWriter::writeZeros(std::ofstream& stream, uint64_t size)
+{
+	static const char zeros[PackedFormat::ALIGNMENT] = { 0 };
+
+	while (size > 0)
+	{
+		uint64_t chunkSize = size < sizeof(zeros) ? size : sizeof(zeros);
+
+		stream.write(zeros, static_cast<std::streamsize>(chunkSize));
+		size -= chunkSize;
+	}
+}
+
+#endif // DEPHEM_PACKED_WRITER_HPP
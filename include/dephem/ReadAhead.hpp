@@ -0,0 +1,116 @@
+#ifndef DEPHEM_READ_AHEAD_HPP
+#define DEPHEM_READ_AHEAD_HPP
+
+#include <cstddef>
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                                 ReadAhead                                  //
+//                                                                            //
+//                  Упреждающее чтение участков файла силами ОС               //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс для предварительной загрузки участков файла в кэш    //
+// ОС (posix_fadvise с POSIX_FADV_WILLNEED). Загрузка выполняется ОС в фоне,  //
+// вызов willNeed(...) не ожидает её окончания. Последующее чтение участка    //
+// через std::ifstream обращается уже к кэшу ОС, а не к диску.                //
+//                                                                            //
+// Используется контекстом вычислений при доступе Access::STREAM (см.         //
+// dph::ReleaseOptions::prefetchBlocksCount). На платформах без               //
+// posix_fadvise (в том числе Windows) методы ничего не делают.               //
+//                                                                            //
+// Объект не копируется.                                                      //
+//                                                                            //
+// ************************************************************************** //
+class ReadAhead
+{
+public:
+
+	// Конструктор по умолчанию (файл не открыт).
+	ReadAhead();
+
+	// Деструктор (закрытие файла).
+	~ReadAhead();
+
+	// Открыть файл по пути "filePath" для подсказок ОС. Возвращает true в
+	// случае успеха (на платформах без поддержки - всегда false).
+	bool open(const std::string& filePath);
+
+	// Закрыть файл.
+	void close();
+
+	// Запросить фоновую загрузку "size" байт файла, начиная с "offset".
+	void willNeed(size_t offset, size_t size) const;
+
+private:
+
+	// Запрет на копирование.
+	ReadAhead(const ReadAhead&);
+	ReadAhead& operator=(const ReadAhead&);
+
+	int m_file;	// Дескриптор файла (-1 - не открыт).
+};
+
+} // namespace dph
+
+dph::ReadAhead::ReadAhead()
+	: m_file(-1)
+{
+}
+
+dph::ReadAhead::~ReadAhead()
+{
+	close();
+}
+
+bool dph::ReadAhead::open(const std::string& filePath)
+{
+	close();
+
+#if !defined(_WIN32) && defined(POSIX_FADV_WILLNEED)
+	m_file = ::open(filePath.c_str(), O_RDONLY);
+
+	return m_file != -1;
+#else
+	(void)filePath;
+
+	return false;
+#endif
+}
+
+void dph::ReadAhead::close()
+{
+#ifndef _WIN32
+	if (m_file != -1)
+	{
+		::close(m_file);
+	}
+#endif
+
+	m_file = -1;
+}
+
+void dph::ReadAhead::willNeed(size_t offset, size_t size) const
+{
+#if !defined(_WIN32) && defined(POSIX_FADV_WILLNEED)
+	if (m_file != -1)
+	{
+		posix_fadvise(m_file, static_cast<off_t>(offset), static_cast<off_t>(size),
+			POSIX_FADV_WILLNEED);
+	}
+#else
+	(void)offset;
+	(void)size;
+#endif
+}
+
+#endif // DEPHEM_READ_AHEAD_HPP
@@ -0,0 +1,140 @@
+#ifndef DEPHEM_RELEASE_CORE_HPP
+#define DEPHEM_RELEASE_CORE_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+#include "MappedFile.hpp"
+#include "LoadedFile.hpp"
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                               ReleaseCore                                  //
+//                                                                            //
+//                Разделяемые неизменяемые данные выпуска эфемерид            //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс, хранящий "тяжёлую" часть выпуска эфемерид:          //
+// отображение файла (Access::MMAP), загруженный в память файл                //
+// (Access::MEMORY) и константы выпуска. После открытия выпуска данные не     //
+// изменяются, поэтому копии dph::EphemerisRelease используют одно ядро, а    //
+// не открывают и не проверяют файл заново.                                   //
+//                                                                            //
+// Время жизни ядра определяется счётчиком ссылок: ядро создаётся с одной     //
+// ссылкой и удаляется при освобождении последней (removeReference()).        //
+// Счётчик изменяется атомарно (Interlocked... на Windows, __sync_... в       //
+// GCC/Clang), поэтому копии выпуска можно создавать и уничтожать в разных    //
+// потоках.                                                                   //
+//                                                                            //
+// Объект не копируется.                                                      //
+//                                                                            //
+// ************************************************************************** //
+class ReleaseCore
+{
+public:
+
+	// Конструктор (ядро пустое, одна ссылка).
+	ReleaseCore();
+
+	// Привести ядро к изначальному состоянию (счётчик ссылок не изменяется).
+	void clear();
+
+	// Добавить ссылку на ядро.
+	void addReference();
+
+	// Освободить ссылку на ядро. Возвращает true, если ссылок не осталось (и
+	// ядро должно быть удалено).
+	bool removeReference();
+
+	// Ядро используется несколькими объектами? Счётчик читается атомарно.
+	bool isShared() const;
+
+	MappedFile	mappedFile;		// Отображение файла в память.
+	LoadedFile	loadedFile;		// Загруженный в память файл.
+
+	// Константы выпуска в порядке файла (плоская таблица) и индекс имён
+	// (номер константы в таблице по её имени):
+	std::vector<std::string>		constantsNames;		// Имена констант.
+	std::vector<double>				constantsValues;	// Значения констант.
+	std::map<std::string, size_t>	constantsIndex;		// Номера констант.
+
+private:
+
+	// Запрет на копирование.
+	ReleaseCore(const ReleaseCore&);
+	ReleaseCore& operator=(const ReleaseCore&);
+
+	// Количество ссылок (mutable: атомарное чтение в isShared() выполняется
+	// операцией, формально изменяющей значение).
+#ifdef _WIN32
+	mutable volatile LONG m_references;
+#else
+	mutable volatile long m_references;
+#endif
+};
+
+} // namespace dph
+
+dph::ReleaseCore::ReleaseCore()
+	: m_references(1)
+{
+}
+
+void dph::ReleaseCore::clear()
+{
+	mappedFile.close();
+	loadedFile.close();
+	std::vector<std::string>().swap(constantsNames);		// SWAP TRICK
+	std::vector<double>().swap(constantsValues);			// SWAP TRICK
+	std::map<std::string, size_t>().swap(constantsIndex);	// SWAP TRICK
+}
+
+void dph::ReleaseCore::addReference()
+{
+#if defined(_WIN32)
+	InterlockedIncrement(&m_references);
+#elif defined(__GNUC__)
+	__sync_add_and_fetch(&m_references, 1);
+#else
+	++m_references;
+#endif
+}
+
+bool dph::ReleaseCore::removeReference()
+{
+#if defined(_WIN32)
+	return InterlockedDecrement(&m_references) == 0;
+#elif defined(__GNUC__)
+	return __sync_sub_and_fetch(&m_references, 1) == 0;
+#else
+	return --m_references == 0;
+#endif
+}
+
+bool dph::ReleaseCore::isShared() const
+{
+	// Атомарное чтение счётчика (сравнение с обменом, не изменяющее значение):
+#if defined(_WIN32)
+	return InterlockedCompareExchange(&m_references, 0, 0) > 1;
+#elif defined(__GNUC__)
+	return __sync_fetch_and_add(&m_references, 0) > 1;
+#else
+	return m_references > 1;
+#endif
+}
+
+#endif // DEPHEM_RELEASE_CORE_HPP
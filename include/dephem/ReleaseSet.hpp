@@ -0,0 +1,756 @@
+#ifndef DEPHEM_RELEASE_SET_HPP
+#define DEPHEM_RELEASE_SET_HPP
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "EphemerisRelease.hpp"
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                                ReleaseSet                                  //
+//                                                                            //
+//             Набор файлов эфемерид с общей шкалой времени                   //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Объект данного класса объединяет несколько бинарных файлов эфемерид        //
+// (например, части выпуска DE431 или точный современный выпуск и выпуск на   //
+// длительный промежуток) в один промежуток времени. Каждый момент времени    //
+// вычисляется по одному из файлов, покрывающих его.                          //
+//                                                                            //
+// Приоритет файлов определяется порядком добавления: на пересечении          //
+// промежутков (и на их общей границе) используется файл, добавленный раньше. //
+// По датам файлов строится индекс - упорядоченный набор непересекающихся     //
+// отрезков с номером файла для каждого, поиск файла для момента времени -    //
+// двоичный поиск по отрезкам (O(log n)).                                     //
+//                                                                            //
+// При добавлении из файла читаются только даты начала и окончания. Сам файл  //
+// открывается (dph::EphemerisRelease) при первом обращении к нему. Открытие  //
+// при вычислениях не синхронизируется: перед вычислениями из нескольких      //
+// потоков открой все файлы методом openAll().                                //
+//                                                                            //
+// Методы вычислений совпадают с методами dph::EphemerisRelease. Результаты   //
+// совпадают с результатами вычислений по выбранному файлу. Контекст          //
+// вычислений (dph::CalculationContext) передаётся выбранному выпуску и при   //
+// переходе к моменту времени из другого файла привязывается заново.          //
+//                                                                            //
+// Объект не копируется.                                                      //
+//                                                                            //
+// ************************************************************************** //
+class ReleaseSet
+{
+public:
+
+// ------------------------ Стандартные методы класса ----------------------- //
+
+	// Конструктор по умолчанию (набор пуст).
+	ReleaseSet();
+
+	// Деструктор (закрытие открытых файлов).
+	~ReleaseSet();
+
+// ---------------------------- Состав набора ------------------------------- //
+
+	// Добавить в набор бинарный файл "binaryFilePath" с параметрами открытия
+	// "options" (см. dph::ReleaseOptions).
+	// -----------------
+	// Примечание: читаются только даты файла, файл открывается при первом
+	// обращении. Возвращает false, если даты прочитать не удалось или они
+	// неверны (файл не добавляется).
+	// -----------------
+	bool add(const std::string& binaryFilePath,
+		const ReleaseOptions& options = ReleaseOptions());
+
+	// Открыть все файлы набора. Возвращает false, если хотя бы один файл не
+	// удалось открыть (такой файл не используется при вычислениях).
+	bool openAll();
+
+	// Удалить все файлы из набора.
+	void clear();
+
+// ---------------------------- Методы вычислений ----------------------------//
+
+	// См. dph::EphemerisRelease::calculateBody(...).
+	// -----------------
+	// Примечание: если момент времени не покрыт ни одним файлом набора (или
+	// файл не удалось открыть), то метод просто прервётся.
+	// -----------------
+	void calculateBody(unsigned calculationResult, unsigned targetBody,
+		unsigned centerBody, double JED, double* resultArray) const;
+
+	void calculateBody(unsigned calculationResult, unsigned targetBody,
+		unsigned centerBody, double JED, double* resultArray,
+			CalculationContext& context) const;
+
+	// См. dph::EphemerisRelease::calculateBody(...) для двухчастной 
+	// Юлианской даты JED = JED1 + JED2. Файл выбирается по сумме частей.
+	void calculateBody(unsigned calculationResult, unsigned targetBody,
+		unsigned centerBody, double JED1, double JED2, double* resultArray) const;
+
+	void calculateBody(unsigned calculationResult, unsigned targetBody,
+		unsigned centerBody, double JED1, double JED2, double* resultArray,
+			CalculationContext& context) const;
+
+	// См. dph::EphemerisRelease::calculateBodies(...).
+	void calculateBodies(unsigned calculationResult, const unsigned* targetBodies,
+		size_t count, unsigned centerBody, double JED, double* resultArray) const;
+
+	void calculateBodies(unsigned calculationResult, const unsigned* targetBodies,
+		size_t count, unsigned centerBody, double JED, double* resultArray,
+			CalculationContext& context) const;
+
+	// См. dph::EphemerisRelease::calculateBodySeries(...).
+	// -----------------
+	// Примечания:
+	//	1. Если хотя бы один момент времени не покрыт файлами набора, то метод
+	//	   просто прервётся, не записав ни одного значения.
+	//	2. Идущие подряд моменты времени одного файла вычисляются одним вызовом
+	//	   метода выпуска.
+	// -----------------
+	void calculateBodySeries(unsigned calculationResult, unsigned targetBody,
+		unsigned centerBody, const double* JEDs, size_t count,
+			double* resultArray) const;
+
+	void calculateBodySeries(unsigned calculationResult, unsigned targetBody,
+		unsigned centerBody, const double* JEDs, size_t count,
+			double* resultArray, CalculationContext& context) const;
+
+	// См. dph::EphemerisRelease::calculateBodySeries(...) для равномерного
+	// ряда моментов времени.
+	void calculateBodySeries(unsigned calculationResult, unsigned targetBody,
+		unsigned centerBody, double startJED, double step, size_t count,
+			double* resultArray) const;
+
+	void calculateBodySeries(unsigned calculationResult, unsigned targetBody,
+		unsigned centerBody, double startJED, double step, size_t count,
+			double* resultArray, CalculationContext& context) const;
+
+	// См. dph::EphemerisRelease::calculateOther(...).
+	void calculateOther(unsigned calculationResult, unsigned otherItem,
+		double JED, double* resultArray) const;
+
+	void calculateOther(unsigned calculationResult, unsigned otherItem,
+		double JED, double* resultArray, CalculationContext& context) const;
+
+	// См. dph::EphemerisRelease::calculateApparent(...).
+	// -----------------
+	// Примечание: используется файл, покрывающий момент наблюдения. Если
+	// момент излучения света вне этого файла, то метод просто прервётся.
+	// -----------------
+	void calculateApparent(unsigned correction, unsigned targetBody,
+		unsigned observerBody, double JED, double* resultArray) const;
+
+	void calculateApparent(unsigned correction, unsigned targetBody,
+		unsigned observerBody, double JED, double* resultArray,
+			CalculationContext& context) const;
+
+	// См. dph::EphemerisRelease::calculateApparentBodies(...).
+	void calculateApparentBodies(unsigned correction, const unsigned* targetBodies,
+		size_t count, unsigned observerBody, double JED, double* resultArray) const;
+
+	void calculateApparentBodies(unsigned correction, const unsigned* targetBodies,
+		size_t count, unsigned observerBody, double JED, double* resultArray,
+			CalculationContext& context) const;
+
+// --------------------------------- ГЕТТЕРЫ -------------------------------- //
+
+	// В наборе есть хотя бы один файл?
+	bool isReady() const;
+
+	// Количество файлов в наборе.
+	size_t releasesCount() const;
+
+	// Первая доступная дата для рассчётов (по всем файлам).
+	double startDate() const;
+
+	// Последняя доступная дата для рассчётов (по всем файлам).
+	double endDate() const;
+
+	// Момент времени JED покрыт файлами набора?
+	bool contains(double JED) const;
+
+	// Выпуск, используемый для момента времени JED (открывается при
+	// необходимости). NULL, если момент не покрыт или файл не открыт.
+	const EphemerisRelease* releaseFor(double JED) const;
+
+	// Выпуск с порядковым номером "index" (в порядке добавления,
+	// открывается при необходимости). NULL, если файл не открыт.
+	const EphemerisRelease* release(size_t index) const;
+
+private:
+
+	// Запрет на копирование.
+	ReleaseSet(const ReleaseSet&);
+	ReleaseSet& operator=(const ReleaseSet&);
+
+	// Файл набора.
+	struct Entry
+	{
+		std::string		binaryFilePath;	// Путь к файлу.
+		ReleaseOptions	options;		// Параметры открытия.
+		double			startDate;		// Дата начала (из заголовка).
+		double			endDate;		// Дата окончания (из заголовка).
+
+		mutable EphemerisRelease*	release;		// Открытый выпуск.
+		mutable bool				isOpenFailed;	// Открыть не удалось?
+	};
+
+	// Отрезок индекса: промежуток [startDate : endDate], вычисляемый по
+	// файлу "entry".
+	struct Segment
+	{
+		double	startDate;
+		double	endDate;
+		size_t	entry;
+	};
+
+	// Для сравнения момента времени с началом отрезка (двоичный поиск).
+	static bool isBefore(double JED, const Segment& segment);
+
+	// Чтение дат начала и окончания из заголовка файла "binaryFilePath".
+	static bool readDates(const std::string& binaryFilePath, double& startDate,
+		double& endDate);
+
+	// Построение индекса по датам файлов.
+	void buildIndex();
+
+	// Номер отрезка индекса для момента времени JED (size_t(-1), если не 
+	// покрыт).
+	size_t segmentIndexOf(double JED) const;
+
+	// Номер файла для момента времени JED (size_t(-1), если не покрыт).
+	size_t entryIndexOf(double JED) const;
+
+	// Открытый выпуск файла "entryIndex" (NULL, если файл не открыт).
+	const EphemerisRelease* openEntry(size_t entryIndex) const;
+
+	// Проверка покрытия и открытие файлов для моментов времени "JEDs" (массив
+	// размера "count").
+	bool prepareSeries(const double* JEDs, size_t count) const;
+
+	std::vector<Entry>		m_entries;	// Файлы в порядке добавления.
+	std::vector<Segment>	m_segments;	// Индекс (по возрастанию дат).
+};
+
+} // namespace dph
+
+dph::ReleaseSet::ReleaseSet()
+{
+}
+
+dph::ReleaseSet::~ReleaseSet()
+{
+	clear();
+}
+
+bool dph::ReleaseSet::add(const std::string& binaryFilePath,
+	const ReleaseOptions& options)
+{
+	Entry entry;
+	entry.binaryFilePath = binaryFilePath;
+	entry.options = options;
+	entry.release = NULL;
+	entry.isOpenFailed = false;
+
+	if (readDates(binaryFilePath, entry.startDate, entry.endDate) == false)
+	{
+		return false;
+	}
+
+	m_entries.push_back(entry);
+
+	buildIndex();
+
+	return true;
+}
+
+bool dph::ReleaseSet::openAll()
+{
+	bool isAllOpen = true;
+
+	for (size_t i = 0; i < m_entries.size(); ++i)
+	{
+		if (openEntry(i) == NULL)
+		{
+			isAllOpen = false;
+		}
+	}
+
+	return isAllOpen;
+}
+
+void dph::ReleaseSet::clear()
+{
+	for (size_t i = 0; i < m_entries.size(); ++i)
+	{
+		delete m_entries[i].release;
+	}
+
+	std::vector<Entry>().swap(m_entries);		// SWAP TRICK
+	std::vector<Segment>().swap(m_segments);	// SWAP TRICK
+}
+
+void dph::ReleaseSet::calculateBody(unsigned calculationResult, unsigned targetBody,
+	unsigned centerBody, double JED, double* resultArray) const
+{
+	const EphemerisRelease* release = releaseFor(JED);
+
+	if (release != NULL)
+	{
+		release->calculateBody(calculationResult, targetBody, centerBody, JED,
+			resultArray);
+	}
+}
+
+void dph::ReleaseSet::calculateBody(unsigned calculationResult, unsigned targetBody,
+	unsigned centerBody, double JED, double* resultArray,
+		CalculationContext& context) const
+{
+	const EphemerisRelease* release = releaseFor(JED);
+
+	if (release != NULL)
+	{
+		release->calculateBody(calculationResult, targetBody, centerBody, JED,
+			resultArray, context);
+	}
+}
+
+void dph::ReleaseSet::calculateBody(unsigned calculationResult, unsigned targetBody,
+	unsigned centerBody, double JED1, double JED2, double* resultArray) const
+{
+	const EphemerisRelease* release = releaseFor(JED1 + JED2);
+
+	if (release != NULL)
+	{
+		release->calculateBody(calculationResult, targetBody, centerBody, JED1, JED2,
+			resultArray);
+	}
+}
+
+void dph::ReleaseSet::calculateBody(unsigned calculationResult, unsigned targetBody,
+	unsigned centerBody, double JED1, double JED2, double* resultArray,
+		CalculationContext& context) const
+{
+	const EphemerisRelease* release = releaseFor(JED1 + JED2);
+
+	if (release != NULL)
+	{
+		release->calculateBody(calculationResult, targetBody, centerBody, JED1, JED2,
+			resultArray, context);
+	}
+}
+
+void dph::ReleaseSet::calculateBodies(unsigned calculationResult,
+	const unsigned* targetBodies, size_t count, unsigned centerBody, double JED,
+		double* resultArray) const
+{
+	const EphemerisRelease* release = releaseFor(JED);
+
+	if (release != NULL)
+	{
+		release->calculateBodies(calculationResult, targetBodies, count, centerBody,
+			JED, resultArray);
+	}
+}
+
+void dph::ReleaseSet::calculateBodies(unsigned calculationResult,
+	const unsigned* targetBodies, size_t count, unsigned centerBody, double JED,
+		double* resultArray, CalculationContext& context) const
+{
+	const EphemerisRelease* release = releaseFor(JED);
+
+	if (release != NULL)
+	{
+		release->calculateBodies(calculationResult, targetBodies, count, centerBody,
+			JED, resultArray, context);
+	}
+}
+
+void dph::ReleaseSet::calculateBodySeries(unsigned calculationResult,
+	unsigned targetBody, unsigned centerBody, const double* JEDs, size_t count,
+		double* resultArray) const
+{
+	if (JEDs == NULL || resultArray == NULL || count == 0 ||
+		prepareSeries(JEDs, count) == false)
+	{
+		return;
+	}
+
+	unsigned componentsCount = calculationResult == Calculate::STATE ? 6 : 3;
+
+	// Идущие подряд моменты времени одного файла:
+	for (size_t first = 0; first < count; )
+	{
+		size_t entryIndex = entryIndexOf(JEDs[first]);
+		size_t runSize = 1;
+
+		while (first + runSize < count && 
+			entryIndexOf(JEDs[first + runSize]) == entryIndex)
+		{
+			++runSize;
+		}
+
+		m_entries[entryIndex].release->calculateBodySeries(calculationResult,
+			targetBody, centerBody, JEDs + first, runSize,
+				resultArray + first * componentsCount);
+
+		first += runSize;
+	}
+}
+
+void dph::ReleaseSet::calculateBodySeries(unsigned calculationResult,
+	unsigned targetBody, unsigned centerBody, const double* JEDs, size_t count,
+		double* resultArray, CalculationContext& context) const
+{
+	if (JEDs == NULL || resultArray == NULL || count == 0 ||
+		prepareSeries(JEDs, count) == false)
+	{
+		return;
+	}
+
+	unsigned componentsCount = calculationResult == Calculate::STATE ? 6 : 3;
+
+	// Идущие подряд моменты времени одного файла:
+	for (size_t first = 0; first < count; )
+	{
+		size_t entryIndex = entryIndexOf(JEDs[first]);
+		size_t runSize = 1;
+
+		while (first + runSize < count && 
+			entryIndexOf(JEDs[first + runSize]) == entryIndex)
+		{
+			++runSize;
+		}
+
+		m_entries[entryIndex].release->calculateBodySeries(calculationResult,
+			targetBody, centerBody, JEDs + first, runSize,
+				resultArray + first * componentsCount, context);
+
+		first += runSize;
+	}
+}
+
+void dph::ReleaseSet::calculateBodySeries(unsigned calculationResult,
+	unsigned targetBody, unsigned centerBody, double startJED, double step,
+		size_t count, double* resultArray) const
+{
+	const EphemerisRelease* release = count == 0 ? NULL : releaseFor(startJED);
+
+	// Ряд целиком в одном отрезке индекса:
+	if (release != NULL &&
+		segmentIndexOf(startJED) == segmentIndexOf(startJED + (count - 1) * step))
+	{
+		release->calculateBodySeries(calculationResult, targetBody, centerBody,
+			startJED, step, count, resultArray);
+	}
+	else if (count != 0)
+	{
+		// Иначе ряд вычисляется по явным моментам времени:
+		std::vector<double> JEDs(count);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			JEDs[i] = startJED + i * step;
+		}
+
+		calculateBodySeries(calculationResult, targetBody, centerBody, &JEDs[0],
+			count, resultArray);
+	}
+}
+
+void dph::ReleaseSet::calculateBodySeries(unsigned calculationResult,
+	unsigned targetBody, unsigned centerBody, double startJED, double step,
+		size_t count, double* resultArray, CalculationContext& context) const
+{
+	const EphemerisRelease* release = count == 0 ? NULL : releaseFor(startJED);
+
+	// Ряд целиком в одном отрезке индекса:
+	if (release != NULL &&
+		segmentIndexOf(startJED) == segmentIndexOf(startJED + (count - 1) * step))
+	{
+		release->calculateBodySeries(calculationResult, targetBody, centerBody,
+			startJED, step, count, resultArray, context);
+	}
+	else if (count != 0)
+	{
+		// Иначе ряд вычисляется по явным моментам времени:
+		std::vector<double> JEDs(count);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			JEDs[i] = startJED + i * step;
+		}
+
+		calculateBodySeries(calculationResult, targetBody, centerBody, &JEDs[0],
+			count, resultArray, context);
+	}
+}
+
+void dph::ReleaseSet::calculateOther(unsigned calculationResult, unsigned otherItem,
+	double JED, double* resultArray) const
+{
+	const EphemerisRelease* release = releaseFor(JED);
+
+	if (release != NULL)
+	{
+		release->calculateOther(calculationResult, otherItem, JED, resultArray);
+	}
+}
+
+void dph::ReleaseSet::calculateOther(unsigned calculationResult, unsigned otherItem,
+	double JED, double* resultArray, CalculationContext& context) const
+{
+	const EphemerisRelease* release = releaseFor(JED);
+
+	if (release != NULL)
+	{
+		release->calculateOther(calculationResult, otherItem, JED, resultArray, context);
+	}
+}
+
+void dph::ReleaseSet::calculateApparent(unsigned correction, unsigned targetBody,
+	unsigned observerBody, double JED, double* resultArray) const
+{
+	const EphemerisRelease* release = releaseFor(JED);
+
+	if (release != NULL)
+	{
+		release->calculateApparent(correction, targetBody, observerBody, JED,
+			resultArray);
+	}
+}
+
+void dph::ReleaseSet::calculateApparent(unsigned correction, unsigned targetBody,
+	unsigned observerBody, double JED, double* resultArray,
+		CalculationContext& context) const
+{
+	const EphemerisRelease* release = releaseFor(JED);
+
+	if (release != NULL)
+	{
+		release->calculateApparent(correction, targetBody, observerBody, JED,
+			resultArray, context);
+	}
+}
+
+void dph::ReleaseSet::calculateApparentBodies(unsigned correction,
+	const unsigned* targetBodies, size_t count, unsigned observerBody, double JED,
+		double* resultArray) const
+{
+	const EphemerisRelease* release = releaseFor(JED);
+
+	if (release != NULL)
+	{
+		release->calculateApparentBodies(correction, targetBodies, count, observerBody,
+			JED, resultArray);
+	}
+}
+
+void dph::ReleaseSet::calculateApparentBodies(unsigned correction,
+	const unsigned* targetBodies, size_t count, unsigned observerBody, double JED,
+		double* resultArray, CalculationContext& context) const
+{
+	const EphemerisRelease* release = releaseFor(JED);
+
+	if (release != NULL)
+	{
+		release->calculateApparentBodies(correction, targetBodies, count, observerBody,
+			JED, resultArray, context);
+	}
+}
+
+bool dph::ReleaseSet::isReady() const
+{
+	return m_entries.empty() == false;
+}
+
+size_t dph::ReleaseSet::releasesCount() const
+{
+	return m_entries.size();
+}
+
+double dph::ReleaseSet::startDate() const
+{
+	return m_segments.empty() ? 0.0 : m_segments.front().startDate;
+}
+
+double dph::ReleaseSet::endDate() const
+{
+	return m_segments.empty() ? 0.0 : m_segments.back().endDate;
+}
+
+bool dph::ReleaseSet::contains(double JED) const
+{
+	return entryIndexOf(JED) != size_t(-1);
+}
+
+const dph::EphemerisRelease* dph::ReleaseSet::releaseFor(double JED) const
+{
+	size_t entryIndex = entryIndexOf(JED);
+
+	return entryIndex == size_t(-1) ? NULL : openEntry(entryIndex);
+}
+
+const dph::EphemerisRelease* dph::ReleaseSet::release(size_t index) const
+{
+	return index < m_entries.size() ? openEntry(index) : NULL;
+}
+
+bool dph::ReleaseSet::isBefore(double JED, const Segment& segment)
+{
+	return JED < segment.startDate;
+}
+
+bool dph::ReleaseSet::readDates(const std::string& binaryFilePath, double& startDate,
+	double& endDate)
+{
+	std::ifstream file(binaryFilePath.c_str(), std::ios::binary);
+
+	if (file.is_open() == false)
+	{
+		return false;
+	}
+
+	// Заголовок JPL упакованного файла следует за заголовком-индексом:
+	PackedFormat::Header packedHeader;
+	std::streamoff headerOffset = PackedFormat::readHeader(file, packedHeader) ?
+		static_cast<std::streamoff>(packedHeader.jplHeaderOffset) : 0;
+
+	// Даты следуют за строковой информацией о выпуске и именами констант
+	// (см. EphemerisRelease::readAndPackData()):
+	file.seekg(headerOffset + EphemerisRelease::RLS_LABELS_COUNT * 
+		EphemerisRelease::RLS_LABEL_SIZE + EphemerisRelease::CCOUNT_MAX_OLD * 
+			EphemerisRelease::CNAME_SIZE, std::ios::beg);
+
+	file.read((char*)&startDate, 8);
+	file.read((char*)&endDate, 8);
+
+	return file.good() && startDate < endDate;
+}
+
+void dph::ReleaseSet::buildIndex()
+{
+	m_segments.clear();
+
+	// Границы всех промежутков по возрастанию:
+	std::vector<double> bounds;
+
+	for (size_t i = 0; i < m_entries.size(); ++i)
+	{
+		bounds.push_back(m_entries[i].startDate);
+		bounds.push_back(m_entries[i].endDate);
+	}
+
+	std::sort(bounds.begin(), bounds.end());
+	bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+	// Для каждого промежутка между соседними границами - первый (по порядку
+	// добавления) покрывающий его файл:
+	for (size_t b = 0; b + 1 < bounds.size(); ++b)
+	{
+		size_t entryIndex = size_t(-1);
+
+		for (size_t i = 0; i < m_entries.size() && entryIndex == size_t(-1); ++i)
+		{
+			if (m_entries[i].startDate <= bounds[b] && m_entries[i].endDate >= bounds[b + 1])
+			{
+				entryIndex = i;
+			}
+		}
+
+		if (entryIndex == size_t(-1))
+		{
+			continue;	// Разрыв между файлами.
+		}
+
+		// Смежные промежутки одного файла объединяются:
+		if (m_segments.empty() == false && m_segments.back().entry == entryIndex &&
+			m_segments.back().endDate == bounds[b])
+		{
+			m_segments.back().endDate = bounds[b + 1];
+		}
+		else
+		{
+			Segment segment;
+			segment.startDate = bounds[b];
+			segment.endDate = bounds[b + 1];
+			segment.entry = entryIndex;
+
+			m_segments.push_back(segment);
+		}
+	}
+}
+
+size_t dph::ReleaseSet::segmentIndexOf(double JED) const
+{
+	// Последний отрезок, начинающийся не позже JED:
+	std::vector<Segment>::const_iterator it = std::upper_bound(m_segments.begin(),
+		m_segments.end(), JED, isBefore);
+
+	if (it == m_segments.begin())
+	{
+		return size_t(-1);
+	}
+
+	--it;
+
+	// На общей границе смежных отрезков - отрезок файла, добавленного раньше:
+	if (it != m_segments.begin() && JED == it->startDate &&
+		(it - 1)->endDate == JED && (it - 1)->entry < it->entry)
+	{
+		--it;
+	}
+
+	return JED <= it->endDate ? size_t(it - m_segments.begin()) : size_t(-1);
+}
+
+size_t dph::ReleaseSet::entryIndexOf(double JED) const
+{
+	size_t segmentIndex = segmentIndexOf(JED);
+
+	return segmentIndex == size_t(-1) ? size_t(-1) : m_segments[segmentIndex].entry;
+}
+
+const dph::EphemerisRelease* dph::ReleaseSet::openEntry(size_t entryIndex) const
+{
+	const Entry& entry = m_entries[entryIndex];
+
+	if (entry.release == NULL && entry.isOpenFailed == false)
+	{
+		EphemerisRelease* release = new EphemerisRelease(entry.binaryFilePath,
+			entry.options);
+
+		if (release->isReady())
+		{
+			entry.release = release;
+		}
+		else
+		{
+			delete release;
+
+			entry.isOpenFailed = true;
+		}
+	}
+
+	return entry.release;
+}
+
+bool dph::ReleaseSet::prepareSeries(const double* JEDs, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (releaseFor(JEDs[i]) == NULL)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+#endif // DEPHEM_RELEASE_SET_HPP
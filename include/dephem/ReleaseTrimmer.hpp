@@ -0,0 +1,254 @@
+#ifndef DEPHEM_RELEASE_TRIMMER_HPP
+#define DEPHEM_RELEASE_TRIMMER_HPP
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "EphemerisRelease.hpp"
+#include "BinaryWriter.hpp"
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                              ReleaseTrimmer                                //
+//                                                                            //
+//                      "Обрезка" бинарных файлов эфемерид                    //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс для создания уменьшенной копии выпуска эфемерид:     //
+// только блоки, покрывающие заданный промежуток времени, и только выбранные  //
+// базовые элементы выпуска (индексы ключей m_keys, от нуля).                 //
+//                                                                            //
+// Результат - корректный бинарный файл формата JPL (см. dph::BinaryWriter),  //
+// который открывается dph::EphemerisRelease. Ключи и количество              //
+// коэффициентов в блоке (ncoeff) пересчитываются, константы выпуска          //
+// сохраняются. Коэффициенты выбранных элементов копируются без изменений,    //
+// поэтому результаты вычислений по исходному и "обрезанному" файлам          //
+// совпадают.                                                                 //
+//                                                                            //
+// Нумерация базовых элементов - см. EphemerisRelease::calculateBaseItem(...).//
+// Для Земли и Луны требуются элементы 2 (барицентр Земля-Луна) и 9 (Луна     //
+// относительно Земли), см. bodyItems(...).                                   //
+//                                                                            //
+// ************************************************************************** //
+class ReleaseTrimmer
+{
+public:
+
+	// Записать в файл "binaryFilePath" выпуск "release", обрезанный до
+	// промежутка [startJED : endJED] (с точностью до блока) и базовых
+	// элементов "baseItems" (массив размера "itemsCount").
+	// ---------------------
+	// Примечания:
+	//	1. Промежуток ограничивается датами выпуска.
+	//	2. Элементы, отсутствующие в выпуске, и повторы игнорируются.
+	//	3. Возвращает false, если выпуск не готов, параметры неверны, ни
+	//	   один элемент не выбран или файл не удалось записать.
+	static bool trim(const EphemerisRelease& release, const std::string& binaryFilePath,
+		double startJED, double endJED, const unsigned* baseItems, size_t itemsCount);
+
+	// Записать в массив "baseItems" (не менее двух элементов) индексы базовых
+	// элементов, необходимых для вычисления положения тела "body"
+	// (используй dph::Body) относительно барицентра СС. Возвращает
+	// количество записанных индексов.
+	static size_t bodyItems(unsigned body, unsigned* baseItems);
+
+private:
+	ReleaseTrimmer(); // Запрет на создание объекта типа ReleaseTrimmer.
+};
+
+} // namespace dph
+
+bool dph::ReleaseTrimmer::trim(const EphemerisRelease& release,
+	const std::string& binaryFilePath, double startJED, double endJED,
+		const unsigned* baseItems, size_t itemsCount)
+{
+	//Условия недопустимые для данного метода:
+	if (release.m_ready == false)
+	{
+		return false;
+	}
+	else if (baseItems == NULL || itemsCount == 0 || startJED > endJED)
+	{
+		return false;
+	}
+	else if (binaryFilePath == release.m_binaryFilePath)
+	{
+		return false;
+	}
+
+	// Промежуток ограничивается датами выпуска:
+	startJED = startJED < release.m_startDate ? release.m_startDate : startJED;
+	endJED = endJED > release.m_endDate ? release.m_endDate : endJED;
+
+	if (startJED > endJED)
+	{
+		return false;
+	}
+
+	size_t firstBlock = release.blockIndexOf(startJED);
+	size_t lastBlock = release.blockIndexOf(endJED);
+
+	// Выбранные элементы (присутствующие в выпуске и используемые им, см.
+	// dph::ReleaseOptions::items):
+	bool isSelected[15] = { false };
+
+	for (size_t i = 0; i < itemsCount; ++i)
+	{
+		unsigned item = baseItems[i];
+
+		if (item < 15 && ((release.m_residentItems >> item) & 1))
+		{
+			isSelected[item] = true;
+		}
+	}
+
+	// --------------------------------- Заголовок ---------------------------------- //
+
+	BinaryWriter writer;
+
+	// Новые ключи: выбранные элементы располагаются подряд в исходном порядке.
+	uint32_t position = 3;
+
+	for (unsigned i = 0; i < 15; ++i)
+	{
+		if (isSelected[i])
+		{
+			writer.inputKeys[i][0] = position;
+			writer.inputKeys[i][1] = release.m_keys[i][1];
+			writer.inputKeys[i][2] = release.m_keys[i][2];
+
+			position += BinaryWriter::componentsCount(i) * release.m_keys[i][1] *
+				release.m_keys[i][2];
+		}
+	}
+
+	if (position == 3)
+	{
+		return false;
+	}
+
+	writer.startDate = release.m_startDate + firstBlock * release.m_blockTimeSpan;
+	writer.endDate = release.m_startDate + (lastBlock + 1) * release.m_blockTimeSpan;
+	writer.blockTimeSpan = release.m_blockTimeSpan;
+	writer.releaseIndex = release.m_releaseIndex;
+	writer.au = release.m_au;
+	writer.emrat = release.m_emrat;
+
+	// Первая строка информации о выпуске сохраняется, вторая и третья -
+	// новые даты начала и окончания:
+	writer.releaseLabel[0] = release.m_releaseLabel.substr(0,
+		release.m_releaseLabel.find('\n'));
+
+	char dateLabel[84];
+
+	std::sprintf(dateLabel, "Start Epoch: JED= %11.1f", writer.startDate);
+	writer.releaseLabel[1] = dateLabel;
+
+	std::sprintf(dateLabel, "Final Epoch: JED= %11.1f", writer.endDate);
+	writer.releaseLabel[2] = dateLabel;
+
+	// Константы (в порядке исходного файла, кроме константы заполнителя -
+	// при необходимости writer добавляет свою):
+	for (size_t i = 0; i < release.m_core->constantsNames.size(); ++i)
+	{
+		if (release.m_core->constantsNames[i] != BinaryWriter::FILLER_CONSTANT)
+		{
+			writer.constantsNames.push_back(release.m_core->constantsNames[i]);
+			writer.constantsValues.push_back(release.m_core->constantsValues[i]);
+		}
+	}
+
+	if (writer.open(binaryFilePath) == false)
+	{
+		return false;
+	}
+
+	// ---------------------------------- Блоки ------------------------------------- //
+
+	// Блоки читаются через отдельный контекст (объект выпуска не изменяется):
+	CalculationContext context;
+
+	if (release.bindContext(context) == false)
+	{
+		writer.close();
+		std::remove(binaryFilePath.c_str());
+
+		return false;
+	}
+
+	std::vector<double> payload(writer.payloadCoeffCount());
+
+	for (size_t blockIndex = firstBlock; blockIndex <= lastBlock; ++blockIndex)
+	{
+		const double* block = release.loadBlock(blockIndex, context);
+
+		if (block == NULL)
+		{
+			writer.close();
+			std::remove(binaryFilePath.c_str());
+
+			return false;
+		}
+
+		// Даты блока:
+		payload[0] = block[0];
+		payload[1] = block[1];
+
+		// Коэффициенты выбранных элементов:
+		for (unsigned i = 0; i < 15; ++i)
+		{
+			if (isSelected[i])
+			{
+				size_t count = BinaryWriter::componentsCount(i) * release.m_keys[i][1] *
+					release.m_keys[i][2];
+
+				std::memcpy(&payload[writer.inputKeys[i][0] - 1],
+					release.itemBlock(i, context), count * sizeof(double));
+			}
+		}
+
+		writer.writeBlock(&payload[0]);
+	}
+
+	if (writer.close() == false)
+	{
+		std::remove(binaryFilePath.c_str());
+
+		return false;
+	}
+
+	return true;
+}
+
+size_t dph::ReleaseTrimmer::bodyItems(unsigned body, unsigned* baseItems)
+{
+	if (baseItems == NULL || body == 0 || body > 13 || body == Body::SSBARY)
+	{
+		return 0;
+	}
+	else if (body == Body::EARTH || body == Body::MOON)
+	{
+		baseItems[0] = 2;
+		baseItems[1] = 9;
+
+		return 2;
+	}
+	else if (body == Body::EMBARY)
+	{
+		baseItems[0] = 2;
+
+		return 1;
+	}
+	else
+	{
+		baseItems[0] = body - 1;
+
+		return 1;
+	}
+}
+
+#endif // DEPHEM_RELEASE_TRIMMER_HPP
@@ -0,0 +1,112 @@
+#ifndef DEPHEM_STATISTICS_HPP
+#define DEPHEM_STATISTICS_HPP
+
+#include <cstring>
+#include <stdint.h>
+
+#ifdef DEPHEM_ENABLE_STATS
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#endif
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                                Statistics                                  //
+//                                                                            //
+//                       Счётчики процесса вычислений                         //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Снимок счётчиков контекста вычислений (см. dph::CalculationContext и       //
+// dph::EphemerisRelease::statistics()).                                      //
+//                                                                            //
+// Сбор счётчиков включается определением DEPHEM_ENABLE_STATS до включения    //
+// заголовочных файлов библиотеки (по умолчанию отключён и не влияет на       //
+// скорость вычислений). Без DEPHEM_ENABLE_STATS заполняются только           //
+// счётчики кэша блоков (cacheHits, cacheMisses и cacheEvictions), остальные  //
+// поля равны нулю.                                                           //
+//                                                                            //
+// bytesRead и seeksCount учитывают только чтение через поток                 //
+// (Access::STREAM): при Access::MMAP и Access::MEMORY коэффициенты           //
+// используются на месте. ioTime_s - время чтения блоков (и дат блоков при    //
+// Validation::LAZY), mathTime_s - время интерполяции (вычисление полиномов   //
+// и их сумм), в секундах.                                                    //
+//                                                                            //
+// ************************************************************************** //
+class Statistics
+{
+public:
+
+	Statistics()
+	{
+		reset();
+	}
+
+	// Обнулить все счётчики.
+	void reset()
+	{
+		fillBufferCalls = 0;
+		cacheHits = 0;
+		cacheMisses = 0;
+		cacheEvictions = 0;
+		bytesRead = 0;
+		seeksCount = 0;
+		std::memset(interpolations, 0, sizeof(interpolations));
+		ioTime_s = 0;
+		mathTime_s = 0;
+	}
+
+	// Сбор счётчиков включён (определён DEPHEM_ENABLE_STATS)?
+	static bool isEnabled()
+	{
+#ifdef DEPHEM_ENABLE_STATS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+#ifdef DEPHEM_ENABLE_STATS
+	// Монотонное время в секундах (для замеров ioTime_s и mathTime_s).
+	static double currentTime()
+	{
+#ifdef _WIN32
+		LARGE_INTEGER frequency, counter;
+		QueryPerformanceFrequency(&frequency);
+		QueryPerformanceCounter(&counter);
+
+		return double(counter.QuadPart) / double(frequency.QuadPart);
+#else
+		timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+
+		return now.tv_sec + now.tv_nsec * 1e-9;
+#endif
+	}
+#endif
+
+	uint64_t fillBufferCalls;		// Количество переходов к другому блоку.
+	uint64_t cacheHits;				// Попадания в кэш блоков.
+	uint64_t cacheMisses;			// Промахи кэша блоков.
+	uint64_t cacheEvictions;		// Вытеснения блоков из кэша.
+	uint64_t bytesRead;				// Прочитано байт из файла.
+	uint64_t seeksCount;			// Количество позиционирований в файле.
+	uint64_t interpolations[15];	// Интерполяций по базовым элементам.
+	double	 ioTime_s;				// Время чтения (сек.).
+	double	 mathTime_s;			// Время интерполяции (сек.).
+};
+
+} // namespace dph
+
+#endif // DEPHEM_STATISTICS_HPP
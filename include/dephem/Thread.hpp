@@ -0,0 +1,183 @@
+#ifndef DEPHEM_THREAD_HPP
+#define DEPHEM_THREAD_HPP
+
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                                  Thread                                    //
+//                                                                            //
+//                           Поток выполнения                                 //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс для запуска функции в отдельном потоке (pthreads /   //
+// Win32). Используется библиотекой для параллельной загрузки и обработки     //
+// файлов эфемерид.                                                           //
+//                                                                            //
+// Если поток не был присоединён явно (join()), он присоединяется в           //
+// деструкторе.                                                               //
+//                                                                            //
+// Объект не копируется.                                                      //
+//                                                                            //
+// ************************************************************************** //
+class Thread
+{
+public:
+
+	// Тип функции, выполняемой в потоке.
+	typedef void (*Function)(void* argument);
+
+	// Конструктор по умолчанию (поток не запущен).
+	Thread();
+
+	// Деструктор (ожидание завершения потока).
+	~Thread();
+
+	// Запустить функцию "function" с аргументом "argument" в новом потоке.
+	// Возвращает true в случае успеха. Если поток уже запущен, то
+	// возвращает false.
+	bool start(Function function, void* argument);
+
+	// Ожидать завершения потока.
+	void join();
+
+	// Поток запущен и не присоединён?
+	bool isRunning() const;
+
+	// Количество логических процессоров (не менее одного).
+	static unsigned hardwareConcurrency();
+
+private:
+
+	// Запрет на копирование.
+	Thread(const Thread&);
+	Thread& operator=(const Thread&);
+
+	Function	m_function;	// Выполняемая функция.
+	void*		m_argument;	// Аргумент функции.
+	bool		m_running;	// Поток запущен?
+
+#ifdef _WIN32
+	HANDLE m_handle;		// Дескриптор потока.
+
+	// Точка входа потока.
+	static DWORD WINAPI entry(LPVOID thread);
+#else
+	pthread_t m_handle;		// Идентификатор потока.
+
+	// Точка входа потока.
+	static void* entry(void* thread);
+#endif
+};
+
+} // namespace dph
+
+dph::Thread::Thread()
+	: m_function(NULL), m_argument(NULL), m_running(false)
+#ifdef _WIN32
+	, m_handle(NULL)
+#endif
+{
+}
+
+dph::Thread::~Thread()
+{
+	join();
+}
+
+bool dph::Thread::start(Function function, void* argument)
+{
+	if (m_running || function == NULL)
+	{
+		return false;
+	}
+
+	m_function = function;
+	m_argument = argument;
+
+#ifdef _WIN32
+	m_handle = CreateThread(NULL, 0, entry, this, 0, NULL);
+
+	m_running = m_handle != NULL;
+#else
+	m_running = pthread_create(&m_handle, NULL, entry, this) == 0;
+#endif
+
+	return m_running;
+}
+
+void dph::Thread::join()
+{
+	if (m_running == false)
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	WaitForSingleObject(m_handle, INFINITE);
+	CloseHandle(m_handle);
+
+	m_handle = NULL;
+#else
+	pthread_join(m_handle, NULL);
+#endif
+
+	m_running = false;
+}
+
+bool dph::Thread::isRunning() const
+{
+	return m_running;
+}
+
+unsigned dph::Thread::hardwareConcurrency()
+{
+#ifdef _WIN32
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+
+	long count = static_cast<long>(systemInfo.dwNumberOfProcessors);
+#else
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+	return count < 1 ? 1 : static_cast<unsigned>(count);
+}
+
+#ifdef _WIN32
+DWORD WINAPI dph::Thread::entry(LPVOID thread)
+{
+	Thread* self = static_cast<Thread*>(thread);
+
+	self->m_function(self->m_argument);
+
+	return 0;
+}
+#else
+void* dph::Thread::entry(void* thread)
+{
+	Thread* self = static_cast<Thread*>(thread);
+
+	self->m_function(self->m_argument);
+
+	return NULL;
+}
+#endif
+
+#endif // DEPHEM_THREAD_HPP
@@ -0,0 +1,366 @@
+#ifndef DEPHEM_THREAD_POOL_HPP
+#define DEPHEM_THREAD_POOL_HPP
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+#include "Thread.hpp"
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                                ThreadPool                                  //
+//                                                                            //
+//                             Пул потоков                                    //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс для многократного параллельного выполнения функции   //
+// без запуска потоков при каждом вызове. Потоки (dph::Thread) запускаются    //
+// при первой необходимости и ожидают задач до уничтожения пула.              //
+//                                                                            //
+// Вызов run(...) выполняет функцию для каждого аргумента из массива:         //
+// первый аргумент - в вызывающем потоке, остальные - в потоках пула.         //
+// Одновременно выполняется не более одного вызова run(...): если пул занят   //
+// (например, вызовом из другого потока), то все задачи выполняются           //
+// вызывающим потоком по порядку. Задачи, для которых не удалось запустить    //
+// поток, также выполняются вызывающим потоком.                               //
+//                                                                            //
+// shared() - общий пул библиотеки (используется                              //
+// dph::EphemerisRelease::calculateBodySeriesParallel(...)).                  //
+//                                                                            //
+// Объект не копируется.                                                      //
+//                                                                            //
+// ************************************************************************** //
+class ThreadPool
+{
+public:
+
+	// Конструктор (потоки не запущены).
+	ThreadPool();
+
+	// Деструктор (завершение потоков пула).
+	~ThreadPool();
+
+	// Выполнить функцию "function" для аргументов "arguments" (количество -
+	// "count") и дождаться завершения всех задач. Все задачи выполняются в
+	// любом случае (см. описание класса).
+	void run(Thread::Function function, void* const* arguments, unsigned count);
+
+	// Количество запущенных потоков пула.
+	unsigned threadsCount() const;
+
+	// Общий пул библиотеки.
+	static ThreadPool& shared();
+
+private:
+
+	// Запрет на копирование.
+	ThreadPool(const ThreadPool&);
+	ThreadPool& operator=(const ThreadPool&);
+
+	// Поток пула.
+	struct Member
+	{
+		Thread		thread;
+		ThreadPool*	pool;
+		unsigned	index;			// Номер потока (задача index + 1).
+		uint64_t	generation;		// Поколение задач при запуске потока.
+	};
+
+	// Цикл ожидания и выполнения задач потоком "member" (функция потока,
+	// аргумент - Member).
+	static void work(void* member);
+
+	// Запустить потоки так, чтобы их было не менее "count" (если возможно).
+	void grow(unsigned count);
+
+	// Синхронизация.
+	void lock();
+	void unlock();
+	bool tryLockRun();
+	void unlockRun();
+	void waitWake();
+	void waitDone();
+	void notifyWake();
+	void notifyDone();
+
+	std::vector<Member*>	m_members;		// Потоки пула.
+
+	Thread::Function	m_function;		// Выполняемая функция.
+	void* const*		m_arguments;	// Аргументы задач.
+	unsigned			m_tasksCount;	// Задач для потоков пула.
+	unsigned			m_pending;		// Невыполненных задач потоков пула.
+	uint64_t			m_generation;	// Поколение задач (номер вызова run).
+	bool				m_stopping;		// Завершение потоков?
+
+#ifdef _WIN32
+	CRITICAL_SECTION	m_mutex;		// Состояние пула.
+	CRITICAL_SECTION	m_runMutex;		// Выполняемый вызов run(...).
+	CONDITION_VARIABLE	m_wake;			// Новые задачи или завершение.
+	CONDITION_VARIABLE	m_done;			// Задачи потоков выполнены.
+#else
+	pthread_mutex_t		m_mutex;
+	pthread_mutex_t		m_runMutex;
+	pthread_cond_t		m_wake;
+	pthread_cond_t		m_done;
+#endif
+};
+
+} // namespace dph
+
+dph::ThreadPool::ThreadPool()
+	: m_function(NULL), m_arguments(NULL), m_tasksCount(0), m_pending(0),
+	m_generation(0), m_stopping(false)
+{
+#ifdef _WIN32
+	InitializeCriticalSection(&m_mutex);
+	InitializeCriticalSection(&m_runMutex);
+	InitializeConditionVariable(&m_wake);
+	InitializeConditionVariable(&m_done);
+#else
+	pthread_mutex_init(&m_mutex, NULL);
+	pthread_mutex_init(&m_runMutex, NULL);
+	pthread_cond_init(&m_wake, NULL);
+	pthread_cond_init(&m_done, NULL);
+#endif
+}
+
+dph::ThreadPool::~ThreadPool()
+{
+	lock();
+	m_stopping = true;
+	notifyWake();
+	unlock();
+
+	for (size_t i = 0; i < m_members.size(); ++i)
+	{
+		m_members[i]->thread.join();
+
+		delete m_members[i];
+	}
+
+#ifdef _WIN32
+	DeleteCriticalSection(&m_mutex);
+	DeleteCriticalSection(&m_runMutex);
+#else
+	pthread_mutex_destroy(&m_mutex);
+	pthread_mutex_destroy(&m_runMutex);
+	pthread_cond_destroy(&m_wake);
+	pthread_cond_destroy(&m_done);
+#endif
+}
+
+void dph::ThreadPool::run(Thread::Function function, void* const* arguments,
+	unsigned count)
+{
+	if (function == NULL || count == 0)
+	{
+		return;
+	}
+
+	// Одна задача или пул занят - все задачи в вызывающем потоке:
+	if (count == 1 || tryLockRun() == false)
+	{
+		for (unsigned i = 0; i < count; ++i)
+		{
+			function(arguments[i]);
+		}
+
+		return;
+	}
+
+	grow(count - 1);
+
+	lock();
+
+	unsigned tasksCount = static_cast<unsigned>(m_members.size()) < count - 1 ?
+		static_cast<unsigned>(m_members.size()) : count - 1;
+
+	m_function = function;
+	m_arguments = arguments;
+	m_tasksCount = tasksCount;
+	m_pending = tasksCount;
+	++m_generation;
+
+	notifyWake();
+	unlock();
+
+	// Первая задача и задачи без потоков - в вызывающем потоке:
+	function(arguments[0]);
+
+	for (unsigned i = tasksCount + 1; i < count; ++i)
+	{
+		function(arguments[i]);
+	}
+
+	lock();
+
+	while (m_pending != 0)
+	{
+		waitDone();
+	}
+
+	m_function = NULL;
+	m_arguments = NULL;
+	m_tasksCount = 0;
+
+	unlock();
+	unlockRun();
+}
+
+unsigned dph::ThreadPool::threadsCount() const
+{
+	return static_cast<unsigned>(m_members.size());
+}
+
+dph::ThreadPool& dph::ThreadPool::shared()
+{
+	static ThreadPool pool;
+
+	return pool;
+}
+
+void dph::ThreadPool::work(void* member)
+{
+	Member& self = *static_cast<Member*>(member);
+	ThreadPool& pool = *self.pool;
+
+	uint64_t seenGeneration = self.generation;
+
+	pool.lock();
+
+	for (;;)
+	{
+		while (pool.m_stopping == false && pool.m_generation == seenGeneration)
+		{
+			pool.waitWake();
+		}
+
+		if (pool.m_stopping)
+		{
+			break;
+		}
+
+		seenGeneration = pool.m_generation;
+
+		if (self.index < pool.m_tasksCount)
+		{
+			Thread::Function function = pool.m_function;
+			void* argument = pool.m_arguments[self.index + 1];
+
+			pool.unlock();
+
+			function(argument);
+
+			pool.lock();
+
+			if (--pool.m_pending == 0)
+			{
+				pool.notifyDone();
+			}
+		}
+	}
+
+	pool.unlock();
+}
+
+void dph::ThreadPool::grow(unsigned count)
+{
+	while (m_members.size() < count)
+	{
+		Member* member = new Member;
+		member->pool = this;
+		member->index = static_cast<unsigned>(m_members.size());
+
+		// Поколение читается до запуска потока, чтобы поток не пропустил
+		// следующий вызов run(...):
+		lock();
+		member->generation = m_generation;
+		unlock();
+
+		if (member->thread.start(work, member) == false)
+		{
+			delete member;
+			return;
+		}
+
+		m_members.push_back(member);
+	}
+}
+
+void dph::ThreadPool::lock()
+{
+#ifdef _WIN32
+	EnterCriticalSection(&m_mutex);
+#else
+	pthread_mutex_lock(&m_mutex);
+#endif
+}
+
+void dph::ThreadPool::unlock()
+{
+#ifdef _WIN32
+	LeaveCriticalSection(&m_mutex);
+#else
+	pthread_mutex_unlock(&m_mutex);
+#endif
+}
+
+bool dph::ThreadPool::tryLockRun()
+{
+#ifdef _WIN32
+	return TryEnterCriticalSection(&m_runMutex) != 0;
+#else
+	return pthread_mutex_trylock(&m_runMutex) == 0;
+#endif
+}
+
+void dph::ThreadPool::unlockRun()
+{
+#ifdef _WIN32
+	LeaveCriticalSection(&m_runMutex);
+#else
+	pthread_mutex_unlock(&m_runMutex);
+#endif
+}
+
+void dph::ThreadPool::waitWake()
+{
+#ifdef _WIN32
+	SleepConditionVariableCS(&m_wake, &m_mutex, INFINITE);
+#else
+	pthread_cond_wait(&m_wake, &m_mutex);
+#endif
+}
+
+void dph::ThreadPool::waitDone()
+{
+#ifdef _WIN32
+	SleepConditionVariableCS(&m_done, &m_mutex, INFINITE);
+#else
+	pthread_cond_wait(&m_done, &m_mutex);
+#endif
+}
+
+void dph::ThreadPool::notifyWake()
+{
+#ifdef _WIN32
+	WakeAllConditionVariable(&m_wake);
+#else
+	pthread_cond_broadcast(&m_wake);
+#endif
+}
+
+void dph::ThreadPool::notifyDone()
+{
+#ifdef _WIN32
+	WakeConditionVariable(&m_done);
+#else
+	pthread_cond_signal(&m_done);
+#endif
+}
+
+#endif // DEPHEM_THREAD_POOL_HPP
@@ -0,0 +1,514 @@
+#ifndef DEPHEM_TIME_SCALES_HPP
+#define DEPHEM_TIME_SCALES_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "EphemerisRelease.hpp"
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                                TimeScales                                  //
+//                                                                            //
+//                       Преобразование шкал времени                          //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Объект данного класса переводит моменты времени (Юлианские даты) между     //
+// шкалами UTC, TAI, TT и TDB (см. dph::TimeScale), в том числе массивами за  //
+// один проход, и вычисляет положения тел на моменты времени, заданные в      //
+// любой из этих шкал.                                                        //
+//                                                                            //
+// Разность TT - TDB берётся из элемента dph::Other::TTmTDB выпуска эфемерид, //
+// если он есть в выпуске, а момент времени принадлежит промежутку выпуска.   //
+// Иначе используется аналитическая формула (USNO Circular 179, погрешность   //
+// около 10 мкс на 1600 - 2200 гг.).                                          //
+//                                                                            //
+// Разность TAI - UTC определяется по встроенной таблице дополнительных       //
+// секунд (1972 - 2017 гг.). Новые дополнительные секунды добавляются         //
+// методом addLeapSecond(...). До 1972 г. используется значение 10 с.         //
+//                                                                            //
+// Объект хранит указатель на выпуск: выпуск должен существовать, пока        //
+// используется объект. Методы без контекста используют внутренний контекст   //
+// выпуска (см. dph::EphemerisRelease::calculateBody(...)).                   //
+//                                                                            //
+// ************************************************************************** //
+class TimeScales
+{
+public:
+
+	// Конструктор по выпуску эфемерид "release" (может быть NULL: тогда
+	// используется только аналитическая формула TT - TDB).
+	explicit TimeScales(const EphemerisRelease* release = NULL);
+
+	// Выпуск эфемерид.
+	const EphemerisRelease* release() const;
+
+	// Установить выпуск эфемерид "release" (может быть NULL).
+	void setRelease(const EphemerisRelease* release);
+
+	// Берётся ли разность TT - TDB из выпуска эфемерид.
+	bool usesRelease() const;
+
+	// Добавить дополнительную секунду: начиная с момента "utcJD" (UTC)
+	// разность TAI - UTC равна "TAImUTC" секунд. Если момент уже есть в
+	// таблице, то значение заменяется.
+	void addLeapSecond(double utcJD, double TAImUTC);
+
+	// Разность TAI - UTC (с) на момент "utcJD" (UTC).
+	double TAImUTC(double utcJD) const;
+
+	// Разность TT - TDB (с) на момент "JD" (TDB или TT).
+	double TTmTDB(double JD) const;
+
+	// Разность TT - TDB (с) на момент "JD" по аналитической формуле.
+	static double analyticTTmTDB(double JD);
+
+	// Перевести момент времени "JD" из шкалы "fromScale" в шкалу "toScale"
+	// (используй dph::TimeScale). Возвращает 0, если индексы шкал неверны.
+	double convert(unsigned fromScale, unsigned toScale, double JD) const;
+
+	// То же, что и convert(...) выше, но с контекстом "context" (см.
+	// dph::EphemerisRelease::calculateBody(...)).
+	double convert(unsigned fromScale, unsigned toScale, double JD,
+		CalculationContext& context) const;
+
+	// Перевести моменты времени "JDs" (количество - "count") из шкалы
+	// "fromScale" в шкалу "toScale". Результат для JDs[i] записывается в
+	// resultArray[i]. Массивы "JDs" и "resultArray" могут совпадать.
+	// -----------------
+	// Примечания:
+	//	1. Если в метод поданы неверные параметры, то он просто прервётся.
+	//	2. Разность TT - TDB вычисляется для всего массива одним рядом (см.
+	//	   dph::EphemerisRelease::calculateOtherSeries(...)).
+	// -----------------
+	void convert(unsigned fromScale, unsigned toScale, const double* JDs,
+		size_t count, double* resultArray) const;
+
+	// То же, что и convert(...) выше, но с контекстом "context".
+	void convert(unsigned fromScale, unsigned toScale, const double* JDs,
+		size_t count, double* resultArray, CalculationContext& context) const;
+
+	// Получить положения (состояния) тела на ряд моментов времени "JDs",
+	// заданных в шкале "scale" (используй dph::TimeScale). Моменты
+	// переводятся в TDB, затем вычисляются одним рядом (параметры и
+	// результат - см. dph::EphemerisRelease::calculateBodySeries(...)).
+	void calculateBodySeries(unsigned scale, unsigned calculationResult,
+		unsigned targetBody, unsigned centerBody, const double* JDs, size_t count,
+			double* resultArray) const;
+
+	// То же, что и calculateBodySeries(...) выше, но с контекстом "context".
+	void calculateBodySeries(unsigned scale, unsigned calculationResult,
+		unsigned targetBody, unsigned centerBody, const double* JDs, size_t count,
+			double* resultArray, CalculationContext& context) const;
+
+private:
+
+	// Количество моментов времени, для которых разность TT - TDB вычисляется
+	// за один вызов выпуска (размер буферов).
+	static const size_t CHUNK_SIZE = 1024;
+
+	// Количество секунд в сутках.
+	static const double SECONDS_PER_DAY;
+
+	// Разность TT - TAI (с).
+	static const double TTmTAI;
+
+	const EphemerisRelease* m_release;	// Выпуск эфемерид (может быть NULL).
+
+	std::vector<double> m_leapDates;	// Моменты (UTC) дополнительных секунд.
+	std::vector<double> m_leapDatesTAI;	// Те же моменты в шкале TAI.
+	std::vector<double> m_leapValues;	// Разности TAI - UTC (с) с этих моментов.
+
+	// Перевести моменты "JDs" (на месте) из шкалы "scale" в соседнюю шкалу
+	// (scale + 1 при "forward", иначе scale - 1).
+	void convertStep(unsigned scale, bool forward, double* JDs, size_t count,
+		CalculationContext* context) const;
+
+	// Прибавить к моментам "JDs" (на месте) разность TT - TDB, умноженную на
+	// "sign" (TDB -> TT: +1, TT -> TDB: -1).
+	void addTTmTDB(double sign, double* JDs, size_t count,
+		CalculationContext* context) const;
+
+	// Перевести моменты (на месте) из UTC в TAI ("forward") или обратно.
+	void addTAImUTC(bool forward, double* JDs, size_t count) const;
+
+	// Общая часть методов convert(...).
+	void convertSeries(unsigned fromScale, unsigned toScale, const double* JDs,
+		size_t count, double* resultArray, CalculationContext* context) const;
+
+	// Общая часть методов calculateBodySeries(...).
+	void calculateSeries(unsigned scale, unsigned calculationResult,
+		unsigned targetBody, unsigned centerBody, const double* JDs, size_t count,
+			double* resultArray, CalculationContext* context) const;
+};
+
+} // namespace dph
+
+const double dph::TimeScales::SECONDS_PER_DAY = 86400.0;
+
+const double dph::TimeScales::TTmTAI = 32.184;
+
+dph::TimeScales::TimeScales(const EphemerisRelease* release)
+{
+	m_release = release;
+
+	// Дополнительные секунды: момент (UTC) и разность TAI - UTC с него (с).
+	static const double leapSeconds[][2] = {
+		{ 2441317.5, 10 },	// 1972-01-01
+		{ 2441499.5, 11 },	// 1972-07-01
+		{ 2441683.5, 12 },	// 1973-01-01
+		{ 2442048.5, 13 },	// 1974-01-01
+		{ 2442413.5, 14 },	// 1975-01-01
+		{ 2442778.5, 15 },	// 1976-01-01
+		{ 2443144.5, 16 },	// 1977-01-01
+		{ 2443509.5, 17 },	// 1978-01-01
+		{ 2443874.5, 18 },	// 1979-01-01
+		{ 2444239.5, 19 },	// 1980-01-01
+		{ 2444786.5, 20 },	// 1981-07-01
+		{ 2445151.5, 21 },	// 1982-07-01
+		{ 2445516.5, 22 },	// 1983-07-01
+		{ 2446247.5, 23 },	// 1985-07-01
+		{ 2447161.5, 24 },	// 1988-01-01
+		{ 2447892.5, 25 },	// 1990-01-01
+		{ 2448257.5, 26 },	// 1991-01-01
+		{ 2448804.5, 27 },	// 1992-07-01
+		{ 2449169.5, 28 },	// 1993-07-01
+		{ 2449534.5, 29 },	// 1994-07-01
+		{ 2450083.5, 30 },	// 1996-01-01
+		{ 2450630.5, 31 },	// 1997-07-01
+		{ 2451179.5, 32 },	// 1999-01-01
+		{ 2453736.5, 33 },	// 2006-01-01
+		{ 2454832.5, 34 },	// 2009-01-01
+		{ 2456109.5, 35 },	// 2012-07-01
+		{ 2457204.5, 36 },	// 2015-07-01
+		{ 2457754.5, 37 }	// 2017-01-01
+	};
+
+	for (size_t i = 0; i < sizeof(leapSeconds) / sizeof(leapSeconds[0]); ++i)
+	{
+		addLeapSecond(leapSeconds[i][0], leapSeconds[i][1]);
+	}
+}
+
+const dph::EphemerisRelease* dph::TimeScales::release() const
+{
+	return m_release;
+}
+
+void dph::TimeScales::setRelease(const EphemerisRelease* release)
+{
+	m_release = release;
+}
+
+bool dph::TimeScales::usesRelease() const
+{
+	return m_release != NULL && m_release->hasItem(Other::TTmTDB);
+}
+
+void dph::TimeScales::addLeapSecond(double utcJD, double TAImUTC)
+{
+	size_t index = std::lower_bound(m_leapDates.begin(), m_leapDates.end(), utcJD) -
+		m_leapDates.begin();
+
+	if (index < m_leapDates.size() && m_leapDates[index] == utcJD)
+	{
+		m_leapValues[index] = TAImUTC;
+	}
+	else
+	{
+		m_leapDates.insert(m_leapDates.begin() + index, utcJD);
+		m_leapValues.insert(m_leapValues.begin() + index, TAImUTC);
+		m_leapDatesTAI.insert(m_leapDatesTAI.begin() + index, 0.0);
+	}
+
+	m_leapDatesTAI[index] = utcJD + TAImUTC / SECONDS_PER_DAY;
+}
+
+double dph::TimeScales::TAImUTC(double utcJD) const
+{
+	size_t index = std::upper_bound(m_leapDates.begin(), m_leapDates.end(), utcJD) -
+		m_leapDates.begin();
+
+	return m_leapValues[index == 0 ? 0 : index - 1];
+}
+
+double dph::TimeScales::TTmTDB(double JD) const
+{
+	if (usesRelease() && JD >= m_release->startDate() && JD <= m_release->endDate())
+	{
+		double result = std::numeric_limits<double>::quiet_NaN();
+
+		m_release->calculateOther(Calculate::POSITION, Other::TTmTDB, JD, &result);
+
+		if (result == result)
+		{
+			return result;
+		}
+	}
+
+	return analyticTTmTDB(JD);
+}
+
+double dph::TimeScales::analyticTTmTDB(double JD)
+{
+	// Юлианские столетия от J2000:
+	double T = (JD - 2451545.0) / 36525.0;
+
+	// USNO Circular 179, (2.6) (TDB - TT):
+	double TDBmTT = 0.001657 * std::sin(628.3076 * T + 6.2401) +
+		0.000022 * std::sin(575.3385 * T + 4.2970) +
+		0.000014 * std::sin(1256.6152 * T + 6.1969) +
+		0.000005 * std::sin(606.9777 * T + 4.0212) +
+		0.000005 * std::sin(52.9691 * T + 0.4444) +
+		0.000002 * std::sin(21.3299 * T + 5.5431) +
+		0.000010 * T * std::sin(628.3076 * T + 4.2490);
+
+	return -TDBmTT;
+}
+
+double dph::TimeScales::convert(unsigned fromScale, unsigned toScale, double JD) const
+{
+	double result = 0;
+
+	convertSeries(fromScale, toScale, &JD, 1, &result, NULL);
+
+	return result;
+}
+
+double dph::TimeScales::convert(unsigned fromScale, unsigned toScale, double JD,
+	CalculationContext& context) const
+{
+	double result = 0;
+
+	convertSeries(fromScale, toScale, &JD, 1, &result, &context);
+
+	return result;
+}
+
+void dph::TimeScales::convert(unsigned fromScale, unsigned toScale,
+	const double* JDs, size_t count, double* resultArray) const
+{
+	convertSeries(fromScale, toScale, JDs, count, resultArray, NULL);
+}
+
+void dph::TimeScales::convert(unsigned fromScale, unsigned toScale,
+	const double* JDs, size_t count, double* resultArray,
+		CalculationContext& context) const
+{
+	convertSeries(fromScale, toScale, JDs, count, resultArray, &context);
+}
+
+void dph::TimeScales::calculateBodySeries(unsigned scale,
+	unsigned calculationResult, unsigned targetBody, unsigned centerBody,
+		const double* JDs, size_t count, double* resultArray) const
+{
+	calculateSeries(scale, calculationResult, targetBody, centerBody, JDs, count,
+		resultArray, NULL);
+}
+
+void dph::TimeScales::calculateBodySeries(unsigned scale,
+	unsigned calculationResult, unsigned targetBody, unsigned centerBody,
+		const double* JDs, size_t count, double* resultArray,
+			CalculationContext& context) const
+{
+	calculateSeries(scale, calculationResult, targetBody, centerBody, JDs, count,
+		resultArray, &context);
+}
+
+void dph::TimeScales::convertStep(unsigned scale, bool forward, double* JDs,
+	size_t count, CalculationContext* context) const
+{
+	// Переход между соседними шкалами: UTC <-> TAI <-> TT <-> TDB.
+	unsigned lowerScale = forward ? scale : scale - 1;
+
+	if (lowerScale == TimeScale::UTC)
+	{
+		addTAImUTC(forward, JDs, count);
+	}
+	else if (lowerScale == TimeScale::TAI)
+	{
+		double shift = (forward ? TTmTAI : -TTmTAI) / SECONDS_PER_DAY;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			JDs[i] += shift;
+		}
+	}
+	else
+	{
+		addTTmTDB(forward ? -1.0 : 1.0, JDs, count, context);
+	}
+}
+
+void dph::TimeScales::addTTmTDB(double sign, double* JDs, size_t count,
+	CalculationContext* context) const
+{
+	// Аргумент элемента TT - TDB - момент в шкале TDB. При переводе TT -> TDB
+	// вместо него используется момент в шкале TT: погрешность от этого
+	// порядка 1e-12 с.
+	double factor = sign / SECONDS_PER_DAY;
+
+	if (usesRelease() == false)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			JDs[i] += factor * analyticTTmTDB(JDs[i]);
+		}
+
+		return;
+	}
+
+	double startDate = m_release->startDate();
+	double endDate = m_release->endDate();
+
+	// Моменты внутри промежутка выпуска собираются в буфер и вычисляются
+	// одним рядом, остальные - по аналитической формуле:
+	std::vector<double> dates(count < CHUNK_SIZE ? count : size_t(CHUNK_SIZE));
+	std::vector<double> values(dates.size());
+	std::vector<size_t> indexes(dates.size());
+
+	for (size_t first = 0; first < count; first += CHUNK_SIZE)
+	{
+		size_t last = count - first < CHUNK_SIZE ? count : first + CHUNK_SIZE;
+		size_t inside = 0;
+
+		for (size_t i = first; i < last; ++i)
+		{
+			if (JDs[i] >= startDate && JDs[i] <= endDate)
+			{
+				dates[inside] = JDs[i];
+				indexes[inside] = i;
+				++inside;
+			}
+			else
+			{
+				JDs[i] += factor * analyticTTmTDB(JDs[i]);
+			}
+		}
+
+		if (inside == 0)
+		{
+			continue;
+		}
+
+		// Ряд может не записать часть значений (например, если блок не прошёл
+		// проверку или не был прочитан): для них используется аналитическая
+		// формула.
+		std::fill(values.begin(), values.begin() + inside, 
+			std::numeric_limits<double>::quiet_NaN());
+
+		if (context == NULL)
+		{
+			m_release->calculateOtherSeries(Calculate::POSITION, Other::TTmTDB,
+				&dates[0], inside, &values[0]);
+		}
+		else
+		{
+			m_release->calculateOtherSeries(Calculate::POSITION, Other::TTmTDB,
+				&dates[0], inside, &values[0], *context);
+		}
+
+		for (size_t j = 0; j < inside; ++j)
+		{
+			bool isCalculated = values[j] == values[j];
+
+			JDs[indexes[j]] += factor *
+				(isCalculated ? values[j] : analyticTTmTDB(dates[j]));
+		}
+	}
+}
+
+void dph::TimeScales::addTAImUTC(bool forward, double* JDs, size_t count) const
+{
+	const std::vector<double>& leapDates = forward ? m_leapDates : m_leapDatesTAI;
+
+	// Промежуток [lower : upper) с постоянной разностью TAI - UTC, найденный
+	// для предыдущего момента (упорядоченные моменты не требуют поиска):
+	double lower = 1;
+	double upper = 0;
+	double shift = 0;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (JDs[i] < lower || JDs[i] >= upper)
+		{
+			size_t index = std::upper_bound(leapDates.begin(), leapDates.end(), JDs[i]) -
+				leapDates.begin();
+
+			lower = index == 0 ? -HUGE_VAL : leapDates[index - 1];
+			upper = index == leapDates.size() ? HUGE_VAL : leapDates[index];
+			shift = m_leapValues[index == 0 ? 0 : index - 1] / SECONDS_PER_DAY;
+		}
+
+		JDs[i] += forward ? shift : -shift;
+	}
+}
+
+void dph::TimeScales::convertSeries(unsigned fromScale, unsigned toScale,
+	const double* JDs, size_t count, double* resultArray,
+		CalculationContext* context) const
+{
+	//Условия недопустимые для данного метода:
+	if (fromScale > TimeScale::TDB || toScale > TimeScale::TDB)
+	{
+		return;
+	}
+	else if (JDs == NULL || resultArray == NULL || count == 0)
+	{
+		return;
+	}
+
+	if (resultArray != JDs)
+	{
+		std::copy(JDs, JDs + count, resultArray);
+	}
+
+	for (unsigned scale = fromScale; scale < toScale; ++scale)
+	{
+		convertStep(scale, true, resultArray, count, context);
+	}
+
+	for (unsigned scale = fromScale; scale > toScale; --scale)
+	{
+		convertStep(scale, false, resultArray, count, context);
+	}
+}
+
+void dph::TimeScales::calculateSeries(unsigned scale, unsigned calculationResult,
+	unsigned targetBody, unsigned centerBody, const double* JDs, size_t count,
+		double* resultArray, CalculationContext* context) const
+{
+	//Условия недопустимые для данного метода:
+	if (m_release == NULL || scale > TimeScale::TDB)
+	{
+		return;
+	}
+	else if (JDs == NULL || resultArray == NULL || count == 0)
+	{
+		return;
+	}
+
+	// Моменты переводятся в TDB целиком, чтобы ряд проверялся выпуском один
+	// раз (см. dph::EphemerisRelease::calculateBodySeries(...)):
+	std::vector<double> JEDs(count);
+
+	convertSeries(scale, TimeScale::TDB, JDs, count, &JEDs[0], context);
+
+	if (context == NULL)
+	{
+		m_release->calculateBodySeries(calculationResult, targetBody, centerBody,
+			&JEDs[0], count, resultArray);
+	}
+	else
+	{
+		m_release->calculateBodySeries(calculationResult, targetBody, centerBody,
+			&JEDs[0], count, resultArray, *context);
+	}
+}
+
+#endif // DEPHEM_TIME_SCALES_HPP
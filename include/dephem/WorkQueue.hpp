@@ -0,0 +1,213 @@
+#ifndef DEPHEM_WORK_QUEUE_HPP
+#define DEPHEM_WORK_QUEUE_HPP
+
+#include <cstddef>
+#include <stdint.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace dph
+{
+
+// ************************************************************************** //
+//                                 WorkQueue                                  //
+//                                                                            //
+//               Распределение работы между потоками (work stealing)          //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс для распределения единиц работы (номера от нуля до   //
+// unitsCount - 1) между несколькими исполнителями (потоками).                //
+//                                                                            //
+// Изначально каждый исполнитель получает непрерывный диапазон единиц         //
+// работы (равные части по порядку) и берёт единицы из начала своего          //
+// диапазона. Исполнитель, выполнивший свой диапазон, забирает половину       //
+// оставшегося диапазона другого исполнителя (с конца). Поэтому при           //
+// неравномерной нагрузке потоки не простаивают, а единицы работы,            //
+// выполняемые одним потоком, остаются соседними.                             //
+//                                                                            //
+// Диапазон каждого исполнителя хранится одним 64-битным словом (начало и     //
+// конец) и изменяется атомарно (Interlocked... на Windows, __sync_... в      //
+// GCC/Clang), блокировки не используются. Слова исполнителей расположены в   //
+// разных строках кэша. Количество единиц работы - не более 2^32 - 1.         //
+//                                                                            //
+// Объект не копируется.                                                      //
+//                                                                            //
+// ************************************************************************** //
+class WorkQueue
+{
+public:
+
+	// Конструктор: "unitsCount" единиц работы, "workersCount" исполнителей
+	// (не менее одного).
+	WorkQueue(size_t unitsCount, unsigned workersCount);
+
+	// Деструктор.
+	~WorkQueue();
+
+	// Количество исполнителей.
+	unsigned workersCount() const;
+
+	// Получить очередную единицу работы "unit" для исполнителя "worker".
+	// Возвращает false, если работы не осталось.
+	// -----------------
+	// Примечание: метод вызывается одновременно из нескольких потоков, каждый
+	// поток - со своим номером исполнителя.
+	// -----------------
+	bool next(unsigned worker, size_t& unit);
+
+private:
+
+	// Запрет на копирование.
+	WorkQueue(const WorkQueue&);
+	WorkQueue& operator=(const WorkQueue&);
+
+	// Количество 64-битных слов на исполнителя (строка кэша - 64 байта).
+	static const size_t RANGE_STRIDE = 8;
+
+	// Диапазон исполнителя "worker": начало - старшие 32 бита, конец -
+	// младшие.
+	volatile uint64_t* rangeOf(unsigned worker) const;
+
+	// Атомарно прочитать слово "value".
+	static uint64_t load(volatile uint64_t* value);
+
+	// Атомарно заменить слово "value" на "desired", если оно равно
+	// "expected". Возвращает true в случае замены.
+	static bool compareAndSwap(volatile uint64_t* value, uint64_t expected,
+		uint64_t desired);
+
+	// Упаковать диапазон [first : last) в одно слово.
+	static uint64_t makeRange(uint64_t first, uint64_t last);
+
+	uint64_t*	m_ranges;			// Диапазоны исполнителей.
+	unsigned	m_workersCount;		// Количество исполнителей.
+};
+
+} // namespace dph
+
+dph::WorkQueue::WorkQueue(size_t unitsCount, unsigned workersCount)
+{
+	m_workersCount = workersCount == 0 ? 1 : workersCount;
+	m_ranges = new uint64_t[m_workersCount * RANGE_STRIDE];
+
+	// Равные непрерывные части по порядку:
+	for (unsigned i = 0; i < m_workersCount; ++i)
+	{
+		uint64_t first = uint64_t(unitsCount) * i / m_workersCount;
+		uint64_t last = uint64_t(unitsCount) * (i + 1) / m_workersCount;
+
+		m_ranges[i * RANGE_STRIDE] = makeRange(first, last);
+	}
+}
+
+dph::WorkQueue::~WorkQueue()
+{
+	delete[] m_ranges;
+}
+
+unsigned dph::WorkQueue::workersCount() const
+{
+	return m_workersCount;
+}
+
+bool dph::WorkQueue::next(unsigned worker, size_t& unit)
+{
+	volatile uint64_t* ownRange = rangeOf(worker);
+
+	// Единица работы из начала собственного диапазона:
+	for (;;)
+	{
+		uint64_t range = load(ownRange);
+		uint64_t first = range >> 32;
+		uint64_t last = range & 0xFFFFFFFFu;
+
+		if (first >= last)
+		{
+			break;
+		}
+		else if (compareAndSwap(ownRange, range, makeRange(first + 1, last)))
+		{
+			unit = static_cast<size_t>(first);
+
+			return true;
+		}
+	}
+
+	// Половина оставшегося диапазона другого исполнителя (с конца). Пустой
+	// диапазон другими исполнителями не изменяется, поэтому забранная часть
+	// записывается в собственный диапазон без конфликтов:
+	for (unsigned i = 1; i < m_workersCount; ++i)
+	{
+		volatile uint64_t* victimRange = rangeOf((worker + i) % m_workersCount);
+
+		for (;;)
+		{
+			uint64_t range = load(victimRange);
+			uint64_t first = range >> 32;
+			uint64_t last = range & 0xFFFFFFFFu;
+
+			if (first >= last)
+			{
+				break;
+			}
+
+			uint64_t stolenFirst = last - (last - first + 1) / 2;
+
+			if (compareAndSwap(victimRange, range, makeRange(first, stolenFirst)))
+			{
+				uint64_t ownValue = load(ownRange);
+
+				compareAndSwap(ownRange, ownValue, makeRange(stolenFirst + 1, last));
+
+				unit = static_cast<size_t>(stolenFirst);
+
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+volatile uint64_t* dph::WorkQueue::rangeOf(unsigned worker) const
+{
+	return m_ranges + worker * RANGE_STRIDE;
+}
+
+uint64_t dph::WorkQueue::load(volatile uint64_t* value)
+{
+#if defined(_WIN32)
+	return static_cast<uint64_t>(InterlockedCompareExchange64(
+		reinterpret_cast<volatile LONG64*>(value), 0, 0));
+#else
+	return __sync_val_compare_and_swap(value, uint64_t(0), uint64_t(0));
+#endif
+}
+
+bool dph::WorkQueue::compareAndSwap(volatile uint64_t* value, uint64_t expected,
+	uint64_t desired)
+{
+#if defined(_WIN32)
+	return static_cast<uint64_t>(InterlockedCompareExchange64(
+		reinterpret_cast<volatile LONG64*>(value), static_cast<LONG64>(desired),
+			static_cast<LONG64>(expected))) == expected;
+#else
+	return __sync_bool_compare_and_swap(value, expected, desired);
+#endif
+}
+
+uint64_t dph::WorkQueue::makeRange(uint64_t first, uint64_t last)
+{
+	return (first << 32) | last;
+}
+
+#endif // DEPHEM_WORK_QUEUE_HPP
@@ -1,6 +1,8 @@
 #ifndef DEPHEM_HELP_HPP
 #define DEPHEM_HELP_HPP
 
+#include <cstddef>
+
 namespace dph
 {
 
@@ -92,6 +94,225 @@ private:
 	Calculate(); // Запрет на создание объекта типа Calculate.
 };
 
+// ************************************************************************** //
+//                                Correction                                  //
+//                                                                            //
+//                  Индексы поправок видимого положения тел                   //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс, хранящий значения параметров для метода             //
+// dph::EphemerisReelase::calculateApparent(...).                             //
+//                                                                            //
+//    GEOMETRIC  - без поправок: положение тела на момент наблюдения.         //
+//    LIGHT_TIME - поправка за время распространения света: положение тела    //
+//                 на момент излучения света, принятого наблюдателем в        //
+//                 момент наблюдения.                                         //
+//    ABERRATION - поправка за время распространения света и звёздная         //
+//                 аберрация (по скорости наблюдателя относительно            //
+//                 барицентра Солнечной Системы).                             //
+//                                                                            //
+// ************************************************************************** //
+class Correction
+{
+public:
+
+	static const unsigned GEOMETRIC		= 0;
+	static const unsigned LIGHT_TIME	= 1;
+	static const unsigned ABERRATION	= 2;
+
+private:
+	Correction(); // Запрет на создание объекта типа Correction.
+};
+
+// ************************************************************************** //
+//                                 TimeScale                                  //
+//                                                                            //
+//                           Индексы шкал времени                             //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс, хранящий значения параметров для методов класса     //
+// dph::TimeScales.                                                           //
+//                                                                            //
+//    UTC - всемирное координированное время.                                 //
+//    TAI - международное атомное время.                                      //
+//    TT  - земное время (TT = TAI + 32.184 с).                               //
+//    TDB - барицентрическое динамическое время (аргумент эфемерид, JED).     //
+//                                                                            //
+// ************************************************************************** //
+class TimeScale
+{
+public:
+
+	static const unsigned UTC	= 0;
+	static const unsigned TAI	= 1;
+	static const unsigned TT	= 2;
+	static const unsigned TDB	= 3;
+
+private:
+	TimeScale(); // Запрет на создание объекта типа TimeScale.
+};
+
+// ************************************************************************** //
+//                                  Access                                    //
+//                                                                            //
+//                      Индексы способов доступа к файлу                      //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс, хранящий значения поля accessMode класса            //
+// dph::ReleaseOptions.                                                       //
+//                                                                            //
+//    STREAM - каждый блок коэффициентов считывается из файла в буффер        //
+//             (seekg + read).                                                //
+//    MMAP   - файл отображается в память, коэффициенты используются на       //
+//             месте, без копирования в буффер.                               //
+//    MEMORY - файл при открытии целиком загружается в память (см.            //
+//             dph::LoadedFile), после чего обращения к файлу не              //
+//             выполняются.                                                   //
+//                                                                            //
+// ************************************************************************** //
+class Access
+{
+public:
+
+	static const unsigned STREAM	= 0;
+	static const unsigned MMAP		= 1;
+	static const unsigned MEMORY	= 2;
+
+private:
+	Access(); // Запрет на создание объекта типа Access.
+};
+
+// ************************************************************************** //
+//                              InstructionSet                                //
+//                                                                            //
+//                      Индексы наборов инструкций SIMD                       //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс, хранящий значения поля instructionSet класса        //
+// dph::ReleaseOptions.                                                       //
+//                                                                            //
+// Значения упорядочены по возрастанию. Используется запрошенный набор, но    //
+// не выше поддерживаемого процессором (AUTO - лучший доступный). Результаты  //
+// вычислений от набора инструкций не зависят.                                //
+//                                                                            //
+// ************************************************************************** //
+class InstructionSet
+{
+public:
+
+	static const unsigned SCALAR	= 0;
+	static const unsigned SSE2		= 1;
+	static const unsigned AVX2		= 2;
+	static const unsigned AVX512	= 3;
+	static const unsigned AUTO		= 3;
+
+private:
+	InstructionSet(); // Запрет на создание объекта типа InstructionSet.
+};
+
+// ************************************************************************** //
+//                                Validation                                  //
+//                                                                            //
+//                   Индексы уровней проверки файла эфемерид                  //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс, хранящий значения поля validation класса            //
+// dph::ReleaseOptions.                                                       //
+//                                                                            //
+//    HEADER  - проверяются только значения заголовка и размер файла.         //
+//    SAMPLED - дополнительно проверяются даты выборки блоков (первый,        //
+//              последний и SAMPLED_BLOCKS_COUNT равномерно распределённых).  //
+//    LAZY    - при открытии как HEADER, даты блока проверяются при первой    //
+//              загрузке блока в контекст вычислений.                         //
+//    FULL    - при открытии проверяются даты всех блоков файла.              //
+//                                                                            //
+// ************************************************************************** //
+class Validation
+{
+public:
+
+	static const unsigned HEADER	= 0;
+	static const unsigned SAMPLED	= 1;
+	static const unsigned LAZY		= 2;
+	static const unsigned FULL		= 3;
+
+	// Количество проверяемых блоков (кроме первого и последнего) для SAMPLED.
+	static const unsigned SAMPLED_BLOCKS_COUNT = 64;
+
+private:
+	Validation(); // Запрет на создание объекта типа Validation.
+};
+
+// ************************************************************************** //
+//                               ReleaseOptions                               //
+//                                                                            //
+//                  Параметры открытия выпуска эфемерид                       //
+// -------------------------------------------------------------------------- //
+//                                 Описание                                   //
+// -------------------------------------------------------------------------- //
+// Вспомогательный класс, передаваемый в конструктор                          //
+// dph::EphemerisRelease(...). Значения по умолчанию соответствуют            //
+// стандартному поведению объекта.                                            //
+//                                                                            //
+// cacheSize_bytes - объём кэша блоков коэффициентов каждого контекста        //
+// вычислений (Access::STREAM). Количество блоков в кэше - объём, делённый на //
+// размер блока, но не менее двух (0 - два блока: блок момента наблюдения и   //
+// блок момента излучения видимого положения).                                //
+//                                                                            //
+// loadThreadsCount и hugePages используются при доступе Access::MEMORY:      //
+// количество потоков загрузки (0 - по количеству логических процессоров) и   //
+// запрос больших страниц для загруженного файла.                             //
+//                                                                            //
+// prefetchBlocksCount - количество блоков, загрузка которых запрашивается    //
+// заранее при последовательном обходе выпуска (вперёд или назад по времени). //
+// Загрузка выполняется ОС в фоне (Access::STREAM - posix_fadvise,            //
+// Access::MMAP - madvise), при Access::MEMORY не требуется. 0 - отключено.   //
+//                                                                            //
+// items - тела (dph::Body) и прочие элементы (dph::Other), для которых       //
+// выполняются вычисления: бит с номером индекса тела или элемента (см.       //
+// useItem(...)), 0 - все. Из блоков читаются и хранятся в памяти только      //
+// коэффициенты требуемых базовых элементов (Access::STREAM - в кэше          //
+// контекста, Access::MEMORY - в загруженном файле, Access::MMAP - ОС         //
+// загружает только страницы этих элементов). Вычисления для остальных тел и  //
+// элементов не выполняются.                                                  //
+//                                                                            //
+// ************************************************************************** //
+class ReleaseOptions
+{
+public:
+
+	ReleaseOptions()
+		: accessMode(Access::STREAM), instructionSet(InstructionSet::AUTO),
+		validation(Validation::FULL), cacheSize_bytes(0), loadThreadsCount(0),
+		hugePages(false), prefetchBlocksCount(0), items(0)
+	{
+	}
+
+	// Добавить тело (dph::Body) или прочий элемент (dph::Other) "item" к
+	// используемым (см. items).
+	void useItem(unsigned item)
+	{
+		if (item >= Body::MERCURY && item <= Other::TTmTDB)
+		{
+			items |= 1ul << item;
+		}
+	}
+
+	unsigned accessMode;		// Способ доступа к файлу. Используй dph::Access.
+	unsigned instructionSet;	// Набор инструкций. Используй dph::InstructionSet.
+	unsigned validation;		// Уровень проверки файла. Используй dph::Validation.
+	size_t	 cacheSize_bytes;	// Объём кэша блоков контекста (байт).
+	unsigned loadThreadsCount;	// Количество потоков загрузки (Access::MEMORY).
+	bool	 hugePages;			// Большие страницы (Access::MEMORY).
+	unsigned prefetchBlocksCount;	// Упреждающая загрузка блоков (0 - нет).
+	unsigned long items;			// Используемые тела и элементы (0 - все).
+};
+
 } // namespace dph
 
 #endif // DEPHEM_HELP_HPP
\ No newline at end of file
@@ -0,0 +1,183 @@
+// ************************************************************************** //
+//                                  apparent                                  //
+//                                                                            //
+//             calculateApparent против итераций по calculateBody             //
+// -------------------------------------------------------------------------- //
+// Эталон видимого положения строится по барицентрическим положениям          //
+// скалярного выпуска: момент излучения уточняется простыми итерациями        //
+// светового времени, аберрация - по той же формуле. Сравнение - с допуском   //
+// (порядок действий в эталоне другой). calculateApparentBodies сравнивается  //
+// с calculateApparent побитово. При кэше по умолчанию блоки моментов         //
+// наблюдения и излучения не читаются повторно.                               //
+// ************************************************************************** //
+
+#include <cmath>
+
+#include "common.hpp"
+
+// Относительная погрешность "value" относительно эталона "expected" (по
+// модулю вектора из трёх компонент).
+static double relativeError(const double* value, const double* expected)
+{
+	double difference = 0, norm = 0;
+
+	for (unsigned k = 0; k < 3; ++k)
+	{
+		difference += (value[k] - expected[k]) * (value[k] - expected[k]);
+		norm += expected[k] * expected[k];
+	}
+
+	return norm > 0 ? std::sqrt(difference / norm) : std::sqrt(difference);
+}
+
+int main()
+{
+	const char* filePath = "dephem_test_apparent.999";
+
+	if (writeFixture(filePath) == false)
+	{
+		return 2;
+	}
+
+	dph::EphemerisRelease reference(filePath, scalarOptions());
+	dph::EphemerisRelease release(filePath);
+
+	if (reference.isReady() == false || release.isReady() == false)
+	{
+		return 2;
+	}
+
+	double c = reference.constant("CLIGHT");
+
+	std::vector<double> dates = testDates(reference, 60);
+
+	// Первый момент - дата начала выпуска, момент излучения вне выпуска:
+	dates[0] = reference.startDate() + 1;
+
+	for (size_t i = 0; i < dates.size(); ++i)
+	{
+		for (unsigned observer = dph::Body::MERCURY; observer <= dph::Body::EMBARY;
+			++observer)
+		{
+			double observerState[6];
+
+			reference.calculateBody(dph::Calculate::STATE, observer, dph::Body::SSBARY,
+				dates[i], observerState);
+
+			for (unsigned target = dph::Body::MERCURY; target <= dph::Body::EMBARY;
+				++target)
+			{
+				// Геометрическое положение и время распространения света:
+				double geometric[4], position[3], lightTime = 0;
+
+				reference.calculateBody(dph::Calculate::POSITION, target, observer,
+					dates[i], geometric);
+
+				for (unsigned n = 0; n < 30; ++n)
+				{
+					double targetPosition[3];
+
+					reference.calculateBody(dph::Calculate::POSITION, target,
+						dph::Body::SSBARY, dates[i] - lightTime / 86400, targetPosition);
+
+					for (unsigned k = 0; k < 3; ++k)
+					{
+						position[k] = targetPosition[k] - observerState[k];
+					}
+
+					lightTime = std::sqrt(position[0] * position[0] +
+						position[1] * position[1] + position[2] * position[2]) / c;
+				}
+
+				double result[4];
+
+				release.calculateApparent(dph::Correction::GEOMETRIC, target, observer,
+					dates[i], result);
+
+				check(relativeError(result, geometric) < 1e-12, "geometric position");
+
+				release.calculateApparent(dph::Correction::LIGHT_TIME, target, observer,
+					dates[i], result);
+
+				check(relativeError(result, position) < 1e-12 &&
+					std::fabs(result[3] - lightTime) <= 1e-12 * lightTime, "light time");
+
+				// Звёздная аберрация:
+				double beta[3] = { observerState[3] / c, observerState[4] / c,
+					observerState[5] / c };
+
+				double distance = lightTime * c;
+				double cosine = (position[0] * beta[0] + position[1] * beta[1] +
+					position[2] * beta[2]) / distance;
+				double gammaInverse = std::sqrt(1 - beta[0] * beta[0] -
+					beta[1] * beta[1] - beta[2] * beta[2]);
+
+				double aberrated[3];
+
+				for (unsigned k = 0; k < 3; ++k)
+				{
+					aberrated[k] = (gammaInverse * position[k] +
+						(1 + cosine / (1 + gammaInverse)) * distance * beta[k]) /
+							(1 + cosine);
+				}
+
+				release.calculateApparent(dph::Correction::ABERRATION, target, observer,
+					dates[i], result);
+
+				check(distance == 0 || relativeError(result, aberrated) < 1e-12,
+					"aberration");
+			}
+
+			// Несколько тел - как по одному:
+			const unsigned targets[] = { 3, 10, 5, 11, 12 };
+
+			double bodies[5 * 4], single[4];
+
+			release.calculateApparentBodies(dph::Correction::ABERRATION, targets, 5,
+				observer, dates[i], bodies);
+
+			for (unsigned t = 0; t < 5; ++t)
+			{
+				release.calculateApparent(dph::Correction::ABERRATION, targets[t],
+					observer, dates[i], single);
+
+				check(isSame(single, &bodies[t * 4], 4), "apparent bodies");
+			}
+		}
+	}
+
+	// Момент излучения раньше даты начала выпуска - значения не записываются:
+	double untouched[4] = { -1, -1, -1, -1 };
+
+	release.calculateApparent(dph::Correction::LIGHT_TIME, dph::Body::SATURN,
+		dph::Body::EARTH, release.startDate(), untouched);
+
+	check(untouched[0] == -1, "emission before start");
+
+	// Момент излучения в предыдущем блоке: при кэше по умолчанию оба блока
+	// остаются в кэше, повторные вычисления не читают файл:
+	{
+		double blockStart = release.startDate() + release.blockTimeSpan() * 7;
+		double JED = blockStart + 1e-6;
+		double result[4];
+
+		release.calculateApparent(dph::Correction::LIGHT_TIME, dph::Body::MARS,
+			dph::Body::EARTH, JED, result);
+		release.resetCacheCounters();
+
+		check(JED - result[3] / 86400 < blockStart, "emission in previous block");
+
+		for (unsigned n = 0; n < 5; ++n)
+		{
+			release.calculateApparent(dph::Correction::LIGHT_TIME, dph::Body::MARS,
+				dph::Body::EARTH, JED, result);
+		}
+
+		check(release.cacheBlocksCount() == 2 && release.cacheHits() > 0 &&
+			release.cacheMisses() == 0, "both blocks resident");
+	}
+
+	std::remove(filePath);
+
+	return testResult("apparent");
+}
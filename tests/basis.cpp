@@ -0,0 +1,81 @@
+// ************************************************************************** //
+//                                   basis                                    //
+//                                                                            //
+//        Переиспользование полиномов Чебышёва в контексте вычислений         //
+// -------------------------------------------------------------------------- //
+// Последовательности вызовов с общим контекстом (разные элементы, степени,   //
+// координаты и скорости на один момент времени, повторы и возвраты к         //
+// прежним моментам) сравниваются побитово с вызовами, каждый из которых      //
+// выполняется с новым контекстом скалярного выпуска.                         //
+// ************************************************************************** //
+
+#include "common.hpp"
+
+int main()
+{
+	const char* filePath = "dephem_test_basis.999";
+
+	if (writeFixture(filePath) == false)
+	{
+		return 2;
+	}
+
+	dph::EphemerisRelease reference(filePath, scalarOptions());
+
+	if (reference.isReady() == false)
+	{
+		return 2;
+	}
+
+	std::vector<double> dates = testDates(reference, 200);
+
+	for (unsigned instructionSet = dph::InstructionSet::SCALAR;
+		instructionSet <= dph::InstructionSet::AUTO; ++instructionSet)
+	{
+		dph::ReleaseOptions options;
+		options.instructionSet = instructionSet;
+
+		dph::EphemerisRelease release(filePath, options);
+
+		dph::CalculationContext context;
+
+		uint32_t state = 7;
+
+		for (size_t i = 0; i < dates.size(); ++i)
+		{
+			// Несколько запросов на момент dates[i] и один - на предыдущий:
+			for (unsigned k = 0; k < 40; ++k)
+			{
+				double date = k == 39 && i > 0 ? dates[i - 1] : dates[i];
+
+				unsigned calc = nextRandom(state) < 0 ? dph::Calculate::POSITION :
+					dph::Calculate::STATE;
+				unsigned item = 1 + unsigned((nextRandom(state) + 1) * 8.5);
+
+				double expected[6] = { 0 }, result[6] = { 0 };
+
+				dph::CalculationContext fresh;
+
+				if (item <= dph::Body::EMBARY)
+				{
+					unsigned center = item == dph::Body::EARTH ? dph::Body::SUN :
+						dph::Body::EARTH;
+
+					reference.calculateBody(calc, item, center, date, expected, fresh);
+					release.calculateBody(calc, item, center, date, result, context);
+				}
+				else
+				{
+					reference.calculateOther(calc, item, date, expected, fresh);
+					release.calculateOther(calc, item, date, result, context);
+				}
+
+				check(isSame(expected, result, 6), "reused basis");
+			}
+		}
+	}
+
+	std::remove(filePath);
+
+	return testResult("basis");
+}
@@ -0,0 +1,70 @@
+// ************************************************************************** //
+//                                   bodies                                   //
+//                                                                            //
+//              calculateBodies против calculateBody для каждого тела         //
+// -------------------------------------------------------------------------- //
+// Наборы тел (с повторами, центральным телом и общими базовыми элементами    //
+// Земли и Луны) вычисляются на одни моменты времени и сравниваются побитово  //
+// с calculateBody скалярного выпуска.                                        //
+// ************************************************************************** //
+
+#include "common.hpp"
+
+int main()
+{
+	const char* filePath = "dephem_test_bodies.999";
+
+	if (writeFixture(filePath) == false)
+	{
+		return 2;
+	}
+
+	dph::EphemerisRelease reference(filePath, scalarOptions());
+	dph::EphemerisRelease release(filePath);
+
+	if (reference.isReady() == false || release.isReady() == false)
+	{
+		return 2;
+	}
+
+	const unsigned targets[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 10, 3 };
+	const size_t targetsCount = sizeof(targets) / sizeof(targets[0]);
+
+	std::vector<double> dates = testDates(reference, 300);
+	std::vector<double> expected(targetsCount * 6), result(targetsCount * 6);
+
+	for (size_t i = 0; i < dates.size(); ++i)
+	{
+		for (unsigned calc = dph::Calculate::POSITION; calc <= dph::Calculate::STATE; ++calc)
+		{
+			size_t n = calc == dph::Calculate::STATE ? 6 : 3;
+
+			for (unsigned center = dph::Body::MERCURY; center <= dph::Body::EMBARY; ++center)
+			{
+				for (size_t t = 0; t < targetsCount; ++t)
+				{
+					reference.calculateBody(calc, targets[t], center, dates[i],
+						&expected[t * n]);
+				}
+
+				release.calculateBodies(calc, targets, targetsCount, center, dates[i],
+					&result[0]);
+
+				check(isSame(&expected[0], &result[0], targetsCount * n), "bodies");
+			}
+		}
+	}
+
+	// Неверное тело в наборе - ни одного значения не записывается:
+	const unsigned wrongTargets[] = { 3, 14 };
+
+	result.assign(targetsCount * 6, -1.0);
+	release.calculateBodies(dph::Calculate::STATE, wrongTargets, 2, dph::Body::SUN,
+		dates[1], &result[0]);
+
+	check(result[0] == -1.0, "rejected bodies");
+
+	std::remove(filePath);
+
+	return testResult("bodies");
+}
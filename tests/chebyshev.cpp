@@ -0,0 +1,146 @@
+// ************************************************************************** //
+//                                 chebyshev                                  //
+//                                                                            //
+//            Ядра dph::Chebyshev против скалярных сумм рядов                 //
+// -------------------------------------------------------------------------- //
+// Для количеств коэффициентов от 1 до 24 и компонент от 1 до 3 на случайных  //
+// коэффициентах и моментах времени (включая границы -1 и 1) сравниваются     //
+// побитово со скалярными sumPosition(...)/sumState(...):                     //
+//    - шаблонные ядра (positionKernel(...), stateKernel(...)), в том числе   //
+//      записанные ими значения полиномов;                                    //
+//    - ядра на пакет моментов времени (positionChunk(...), stateChunk(...)). //
+// Ядра обоих видов проверяются для каждого набора инструкций,                //
+// поддерживаемого процессором.                                               //
+// ************************************************************************** //
+
+#include "common.hpp"
+#include "dephem/Chebyshev.hpp"
+
+int main()
+{
+	const uint32_t CPEC_MAX = 24;
+	const size_t TIMES_COUNT = 37;	// Не кратно количеству элементов регистров.
+
+	unsigned bestInstructionSet = dph::Chebyshev::detectInstructionSet();
+
+	uint32_t state = 11;
+
+	for (uint32_t cpec = 1; cpec <= CPEC_MAX; ++cpec)
+	{
+		for (unsigned componentsCount = 1; componentsCount <= 3; ++componentsCount)
+		{
+			size_t coeffCount = cpec * componentsCount;
+			size_t valuesCount = componentsCount * 2;
+
+			std::vector<double> times(TIMES_COUNT);
+			std::vector<double> coeffs(TIMES_COUNT * coeffCount);
+			std::vector<const double*> coeffArrays(TIMES_COUNT);
+
+			for (size_t e = 0; e < TIMES_COUNT; ++e)
+			{
+				times[e] = e == 0 ? -1 : e == 1 ? 1 : e == 2 ? 0 : nextRandom(state);
+				coeffArrays[e] = &coeffs[e * coeffCount];
+
+				for (size_t k = 0; k < coeffCount; ++k)
+				{
+					coeffs[e * coeffCount + k] = nextRandom(state) * 1e8 / (k % cpec + 1);
+				}
+			}
+
+			double derivativeUnits = 2 / 16.0;
+
+			// Эталон: полиномы по рекуррентным формулам и скалярные суммы.
+			std::vector<double> positions(TIMES_COUNT * componentsCount);
+			std::vector<double> states(TIMES_COUNT * valuesCount);
+			std::vector<double> polys(TIMES_COUNT * CPEC_MAX);
+			std::vector<double> dpolys(TIMES_COUNT * CPEC_MAX);
+
+			for (size_t e = 0; e < TIMES_COUNT; ++e)
+			{
+				double* poly = &polys[e * CPEC_MAX];
+				double* dpoly = &dpolys[e * CPEC_MAX];
+
+				poly[0] = 1;
+				poly[1] = times[e];
+				dpoly[0] = 0;
+				dpoly[1] = 1;
+
+				dph::Chebyshev::fillPolynoms(times[e], 2, cpec < 3 ? 3 : cpec, poly);
+				dph::Chebyshev::fillDerivatives(times[e], 2, cpec < 3 ? 3 : cpec, poly,
+					dpoly);
+
+				dph::Chebyshev::sumPosition(poly, coeffArrays[e], cpec, componentsCount,
+					&positions[e * componentsCount]);
+				dph::Chebyshev::sumState(poly, dpoly, coeffArrays[e], cpec,
+					componentsCount, derivativeUnits, &states[e * valuesCount]);
+			}
+
+			// Шаблонные ядра:
+			for (unsigned instructionSet = dph::InstructionSet::SCALAR;
+				instructionSet <= bestInstructionSet; ++instructionSet)
+			{
+				dph::Chebyshev::PositionKernel positionKernel =
+					dph::Chebyshev::positionKernel(instructionSet, cpec, componentsCount);
+				dph::Chebyshev::StateKernel stateKernel =
+					dph::Chebyshev::stateKernel(instructionSet, cpec, componentsCount);
+
+				check((positionKernel != NULL) == (cpec >= dph::Chebyshev::FIXED_CPEC_MIN &&
+					cpec <= dph::Chebyshev::FIXED_CPEC_MAX), "template kernel range");
+
+				for (size_t e = 0; positionKernel != NULL && e < TIMES_COUNT; ++e)
+				{
+					double poly[CPEC_MAX], dpoly[CPEC_MAX], result[6];
+
+					positionKernel(times[e], false, poly, coeffArrays[e], result);
+
+					check(isSame(result, &positions[e * componentsCount], componentsCount) &&
+						isSame(poly, &polys[e * CPEC_MAX], cpec), "template position");
+
+					positionKernel(times[e], true, poly, coeffArrays[e], result);
+
+					check(isSame(result, &positions[e * componentsCount], componentsCount),
+						"template position with ready polynoms");
+
+					stateKernel(times[e], false, poly, dpoly, coeffArrays[e], derivativeUnits,
+						result);
+
+					check(isSame(result, &states[e * valuesCount], valuesCount) &&
+						isSame(poly, &polys[e * CPEC_MAX], cpec) &&
+						isSame(dpoly, &dpolys[e * CPEC_MAX], cpec), "template state");
+
+					stateKernel(times[e], true, poly, dpoly, coeffArrays[e], derivativeUnits,
+						result);
+
+					check(isSame(result, &states[e * valuesCount], valuesCount),
+						"template state with ready polynoms");
+				}
+			}
+
+			// Ядра на пакет моментов времени:
+			for (unsigned instructionSet = dph::InstructionSet::SCALAR;
+				instructionSet <= bestInstructionSet; ++instructionSet)
+			{
+				std::vector<double> result(TIMES_COUNT * valuesCount);
+
+				for (size_t count = 1; count <= TIMES_COUNT; count += TIMES_COUNT - 1)
+				{
+					dph::Chebyshev::positionChunk(instructionSet, &times[0], &coeffArrays[0],
+						count, cpec, componentsCount, &result[0]);
+
+					check(isSame(&result[0], &positions[0], count * componentsCount),
+						"position chunk");
+
+					dph::Chebyshev::stateChunk(instructionSet, &times[0], &coeffArrays[0],
+						count, cpec, componentsCount, derivativeUnits, &result[0]);
+
+					check(isSame(&result[0], &states[0], count * valuesCount),
+						"state chunk");
+				}
+			}
+		}
+	}
+
+	std::printf("instruction set: %u\n", bestInstructionSet);
+
+	return testResult("chebyshev");
+}
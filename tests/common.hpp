@@ -0,0 +1,202 @@
+#ifndef DEPHEM_TESTS_COMMON_HPP
+#define DEPHEM_TESTS_COMMON_HPP
+
+// ************************************************************************** //
+//                     Общие функции регрессионных тестов                     //
+// -------------------------------------------------------------------------- //
+// Тесты работают с небольшим синтетическим выпуском (см. writeFixture(...)), //
+// создаваемым в рабочем каталоге теста. Коэффициенты - псевдослучайные с     //
+// фиксированным начальным значением, поэтому выпуск одинаков при каждом      //
+// запуске. Эталон - calculateBody(...)/calculateOther(...) выпуска,          //
+// открытого со скалярным набором инструкций (см. scalarOptions()).           //
+//                                                                            //
+// Код возврата теста: 0 - все проверки пройдены, 1 - есть ошибки, 2 - не     //
+// удалось создать или открыть выпуск.                                        //
+// ************************************************************************** //
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "dephem/BinaryWriter.hpp"
+#include "dephem/EphemerisRelease.hpp"
+
+// Параметры тестового выпуска.
+static const double FIXTURE_START_DATE = 2451536.5;
+static const double FIXTURE_BLOCK_SPAN = 32.0;
+static const unsigned FIXTURE_BLOCKS_COUNT = 40;
+
+// Количество проверок и ошибок.
+struct TestCounters
+{
+	unsigned long checksCount;
+	unsigned long failuresCount;
+};
+
+// Счётчики теста.
+inline TestCounters& testCounters()
+{
+	static TestCounters counters = { 0, 0 };
+
+	return counters;
+}
+
+// Учесть проверку "isPassed". Первые ошибки выводятся с описанием "what".
+inline void check(bool isPassed, const char* what)
+{
+	TestCounters& counters = testCounters();
+
+	++counters.checksCount;
+
+	if (isPassed == false)
+	{
+		if (counters.failuresCount < 10)
+		{
+			std::printf("FAIL: %s\n", what);
+		}
+
+		++counters.failuresCount;
+	}
+}
+
+// Совпадают ли массивы "a" и "b" из "count" значений побитово.
+inline bool isSame(const double* a, const double* b, size_t count)
+{
+	return std::memcmp(a, b, count * sizeof(double)) == 0;
+}
+
+// Итог теста "testName": вывод количества проверок и код возврата.
+inline int testResult(const char* testName)
+{
+	const TestCounters& counters = testCounters();
+
+	std::printf("%s: %lu checks, %lu failed\n", testName, counters.checksCount,
+		counters.failuresCount);
+
+	return counters.failuresCount == 0 ? 0 : 1;
+}
+
+// Очередное псевдослучайное число из [-1 : 1) (линейный конгруэнтный
+// генератор, одинаковый на всех платформах).
+inline double nextRandom(uint32_t& state)
+{
+	state = state * 1664525u + 1013904223u;
+
+	return (state >> 8) / double(1u << 23) - 1.0;
+}
+
+// Создать тестовый выпуск по пути "filePath": все 15 базовых элементов с
+// разными количествами коэффициентов и подынтервалов, FIXTURE_BLOCKS_COUNT
+// блоков, константы AU, EMRAT и CLIGHT. Возвращает false при ошибке записи.
+inline bool writeFixture(const std::string& filePath)
+{
+	// Количество коэффициентов и подынтервалов элементов:
+	static const uint32_t ITEMS[15][2] = {
+		{14, 4}, {10, 2}, {13, 2}, {11, 1}, {8, 1}, {7, 1}, {6, 1}, {6, 1},
+		{6, 1}, {13, 8}, {11, 2}, {10, 4}, {10, 4}, {10, 4}, {13, 8} };
+
+	dph::BinaryWriter writer;
+
+	writer.releaseLabel[0] = "JPL Planetary Ephemeris DE999/LE999";
+	writer.releaseLabel[1] = "Start Epoch: JED=  2451536.5";
+	writer.releaseLabel[2] = "Final Epoch: JED=  2452816.5";
+	writer.releaseIndex = 999;
+	writer.startDate = FIXTURE_START_DATE;
+	writer.endDate = FIXTURE_START_DATE + FIXTURE_BLOCK_SPAN * FIXTURE_BLOCKS_COUNT;
+	writer.blockTimeSpan = FIXTURE_BLOCK_SPAN;
+	writer.au = 149597870.7;
+	writer.emrat = 81.30056907419062;
+
+	uint32_t position = 3;
+
+	for (unsigned i = 0; i < 15; ++i)
+	{
+		writer.inputKeys[i][0] = position;
+		writer.inputKeys[i][1] = ITEMS[i][0];
+		writer.inputKeys[i][2] = ITEMS[i][1];
+
+		position += ITEMS[i][0] * ITEMS[i][1] * dph::BinaryWriter::componentsCount(i);
+	}
+
+	writer.constantsNames.push_back("AU");
+	writer.constantsNames.push_back("EMRAT");
+	writer.constantsNames.push_back("CLIGHT");
+	writer.constantsValues.push_back(writer.au);
+	writer.constantsValues.push_back(writer.emrat);
+	writer.constantsValues.push_back(299792.458);
+
+	if (writer.open(filePath) == false)
+	{
+		return false;
+	}
+
+	std::vector<double> block(writer.payloadCoeffCount());
+
+	uint32_t state = 1;
+
+	for (unsigned b = 0; b < FIXTURE_BLOCKS_COUNT; ++b)
+	{
+		block[0] = writer.startDate + b * FIXTURE_BLOCK_SPAN;
+		block[1] = block[0] + FIXTURE_BLOCK_SPAN;
+
+		size_t k = 2;
+
+		for (unsigned i = 0; i < 15; ++i)
+		{
+			size_t polynomsCount = ITEMS[i][1] * dph::BinaryWriter::componentsCount(i);
+
+			for (size_t p = 0; p < polynomsCount; ++p)
+			{
+				for (uint32_t j = 0; j < ITEMS[i][0]; ++j)
+				{
+					block[k++] = nextRandom(state) * 1e6 / ((j + 1.0) * (j + 1.0) * (j + 1.0));
+				}
+			}
+		}
+
+		if (writer.writeBlock(&block[0]) == false)
+		{
+			return false;
+		}
+	}
+
+	return writer.close();
+}
+
+// Параметры эталонного выпуска: скалярный набор инструкций, чтение блоков
+// из файла, полная проверка.
+inline dph::ReleaseOptions scalarOptions()
+{
+	dph::ReleaseOptions options;
+
+	options.instructionSet = dph::InstructionSet::SCALAR;
+
+	return options;
+}
+
+// Моменты времени "count" штук: равномерно по всему выпуску "release" со
+// сдвигом внутри блоков, включая даты начала и окончания выпуска и границы
+// блоков.
+inline std::vector<double> testDates(const dph::EphemerisRelease& release,
+	size_t count)
+{
+	std::vector<double> dates(count);
+
+	double start = release.startDate();
+	double end = release.endDate();
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		dates[i] = start + (end - start) * ((i * 0.618033988749895) -
+			size_t(i * 0.618033988749895));
+	}
+
+	dates[0] = start;
+	dates[count - 1] = end;
+	dates[count / 2] = start + release.blockTimeSpan() * 7;
+
+	return dates;
+}
+
+#endif // DEPHEM_TESTS_COMMON_HPP
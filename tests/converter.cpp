@@ -0,0 +1,266 @@
+// ************************************************************************** //
+//                                 converter                                  //
+//                                                                            //
+//            dph::AsciiConverter: разбор чисел и обратное преобразование     //
+// -------------------------------------------------------------------------- //
+// Разбор чисел (parseDouble(...)) сверяется с литералами компилятора и       //
+// strtod: граничные случаи формата, числа ровно посередине между соседними   //
+// значениями double, мантиссы из 19 цифр и длиннее, субнормальные числа,     //
+// десятичный разделитель локали (если в системе есть локаль с запятой).      //
+//                                                                            //
+// Тестовый выпуск записывается в формате ASCII JPL (заголовок и два файла    //
+// коэффициентов с общим блоком на стыке) и преобразуется обратно: бинарный   //
+// файл должен совпасть с исходным побитово.                                  //
+// ************************************************************************** //
+
+#include <clocale>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+#include "common.hpp"
+#include "dephem/AsciiConverter.hpp"
+
+// Разбор "text" совпадает с "expected" побитово, после числа - "rest"?
+static bool isParsed(const char* text, double expected, const char* rest)
+{
+	const char* end = NULL;
+
+	double value = dph::AsciiConverter::parseDouble(text, &end);
+
+	return isSame(&value, &expected, 1) && std::strcmp(end, rest) == 0;
+}
+
+// Число "value" в формате Fortran (17 значащих цифр, экспонента 'D').
+static std::string fortranNumber(double value)
+{
+	char buffer[64];
+
+	std::sprintf(buffer, "%26.16E", value);
+
+	for (char* c = buffer; *c != '\0'; ++c)
+	{
+		*c = *c == 'E' ? 'D' : *c;
+	}
+
+	return buffer;
+}
+
+// Содержимое файла "filePath".
+static std::vector<char> readContent(const char* filePath)
+{
+	std::ifstream file(filePath, std::ios::binary);
+
+	return std::vector<char>((std::istreambuf_iterator<char>(file)),
+		std::istreambuf_iterator<char>());
+}
+
+// Записать выпуск "release" (бинарный файл "content") в формате ASCII:
+// заголовок "headerPath" и файлы коэффициентов "dataPaths" (блоки до
+// "seamBlock" включительно и от "seamBlock").
+static bool writeAscii(const dph::EphemerisRelease& release,
+	const std::vector<char>& content, const char* headerPath, const char* dataPaths[2],
+		size_t seamBlock)
+{
+	// Ключи в заголовке бинарного файла (см. dph::BinaryWriter):
+	uint32_t keys[15][3];
+
+	std::memcpy(keys, &content[2696], 12 * 3 * 4);
+	std::memcpy(keys[12], &content[2844], 3 * 4);
+	std::memcpy(keys[13], &content[2856], 2 * 3 * 4);
+
+	size_t ncoeff = dph::BinaryWriter::coeffCount(keys);
+
+	std::FILE* header = std::fopen(headerPath, "w");
+
+	if (header == NULL)
+	{
+		return false;
+	}
+
+	std::fprintf(header, "KSIZE= %5u    NCOEFF= %5u\n\n", unsigned(ncoeff * 2),
+		unsigned(ncoeff));
+
+	std::fprintf(header, "GROUP   1010\n\n%s\n", release.releaseLabel().c_str());
+
+	std::fprintf(header, "GROUP   1030\n\n%s%s%s\n\n",
+		fortranNumber(release.startDate()).c_str(),
+		fortranNumber(release.endDate()).c_str(),
+		fortranNumber(release.blockTimeSpan()).c_str());
+
+	std::fprintf(header, "GROUP   1040\n\n%6u\n", unsigned(release.constantsCount()));
+
+	for (size_t i = 0; i < release.constantsCount(); ++i)
+	{
+		std::fprintf(header, "  %-8s%s", release.constantName(i).c_str(),
+			i % 10 == 9 || i + 1 == release.constantsCount() ? "\n" : "");
+	}
+
+	std::fprintf(header, "\nGROUP   1041\n\n%6u\n", unsigned(release.constantsCount()));
+
+	for (size_t i = 0; i < release.constantsCount(); ++i)
+	{
+		std::fprintf(header, "%s%s", fortranNumber(release.constantsValues()[i]).c_str(),
+			i % 3 == 2 || i + 1 == release.constantsCount() ? "\n" : "");
+	}
+
+	std::fprintf(header, "\nGROUP   1050\n\n");
+
+	for (unsigned row = 0; row < 3; ++row)
+	{
+		for (unsigned item = 0; item < 15; ++item)
+		{
+			std::fprintf(header, "%6u", unsigned(keys[item][row]));
+		}
+
+		std::fprintf(header, "\n");
+	}
+
+	std::fclose(header);
+
+	// Блоки: строка "номер_блока ncoeff", значения по три в строке:
+	size_t blocksCount = content.size() / (ncoeff * 8) - 2;
+
+	for (unsigned f = 0; f < 2; ++f)
+	{
+		std::FILE* data = std::fopen(dataPaths[f], "w");
+
+		if (data == NULL)
+		{
+			return false;
+		}
+
+		size_t first = f == 0 ? 0 : seamBlock;
+		size_t last = f == 0 ? seamBlock : blocksCount - 1;
+
+		for (size_t b = first; b <= last; ++b)
+		{
+			const double* block = reinterpret_cast<const double*>(
+				&content[(b + 2) * ncoeff * 8]);
+
+			std::fprintf(data, "%6u%6u\n", unsigned(b + 1), unsigned(ncoeff));
+
+			for (size_t i = 0; i < ncoeff; i += 3)
+			{
+				for (size_t j = i; j < i + 3; ++j)
+				{
+					std::fprintf(data, "%s", fortranNumber(j < ncoeff ? block[j] : 0).c_str());
+				}
+
+				std::fprintf(data, "\n");
+			}
+		}
+
+		std::fclose(data);
+	}
+
+	return true;
+}
+
+int main()
+{
+	// Разбор чисел:
+	check(isParsed("0.1D+01", 1.0, ""), "fortran exponent");
+	check(isParsed("  -0.5d-3 1", -0.5e-3, " 1"), "lower case exponent");
+	check(isParsed("+.25E2", 25.0, ""), "sign and leading point");
+	check(isParsed("5.", 5.0, ""), "trailing point");
+	check(isParsed("1.5D", 1.5, "D"), "exponent without digits");
+	check(isParsed("abc", 0.0, "abc") && isParsed("-D5", 0.0, "-D5"), "no digits");
+	check(isParsed("-0.0", -0.0, ""), "negative zero");
+
+	// Мантиссы из 19 цифр (вне быстрого пути одним умножением), числа
+	// посередине между соседними значениями (округление к чётному),
+	// длинные мантиссы и субнормальные числа (общий путь):
+	check(isParsed("0.1234567890123456789D-05", 0.1234567890123456789e-05, ""),
+		"19 digits");
+	check(isParsed("9999999999999999999", 9999999999999999999.0, ""), "19 nines");
+	check(isParsed("9007199254740993", 9007199254740993.0, "") &&
+		isParsed("9007199254740995", 9007199254740995.0, ""), "halfway");
+	check(isParsed("0.4416345262910666D+04", 0.4416345262910666e+04, ""), "JPL number");
+	check(isParsed("1D23", 1e23, "") && isParsed("1D-64", 1e-64, "") &&
+		isParsed("1.7976931348623157D308", 1.7976931348623157e308, ""),
+			"exponent range");
+	check(isParsed("0.12345678901234567890123456789D+00",
+		0.12345678901234567890123456789, ""), "long mantissa");
+	check(isParsed("4.9D-324", 4.9e-324, "") &&
+		isParsed("2.2250738585072011D-308", 2.2250738585072011e-308, ""), "subnormal");
+
+	// Случайные мантиссы из 19 цифр против strtod (локаль "C"):
+	uint32_t state = 5;
+
+	for (unsigned i = 0; i < 20000; ++i)
+	{
+		char text[64];
+
+		unsigned long high = static_cast<unsigned long>((nextRandom(state) + 1) * 5e8);
+		unsigned long low = static_cast<unsigned long>((nextRandom(state) + 1) * 5e8);
+		int exponent = static_cast<int>(nextRandom(state) * 60);
+
+		std::sprintf(text, "0.%09lu%09lu7E%+d", high, low, exponent);
+
+		check(isParsed(text, std::strtod(text, NULL), ""), "random 19 digits");
+	}
+
+	// Локаль с десятичной запятой (если есть) не влияет на разбор:
+	const char* locales[] = { "de_DE.UTF-8", "ru_RU.UTF-8", "fr_FR.UTF-8", "German" };
+
+	for (unsigned i = 0; i < 4; ++i)
+	{
+		if (std::setlocale(LC_NUMERIC, locales[i]) != NULL &&
+			std::localeconv()->decimal_point[0] == ',')
+		{
+			check(isParsed("0.5D+00", 0.5, "") &&
+				isParsed("0.12345678901234567890123456789D+00",
+					0.12345678901234567890123456789, ""), "decimal comma locale");
+
+			break;
+		}
+	}
+
+	std::setlocale(LC_NUMERIC, "C");
+
+	// Тестовый выпуск в формате ASCII и обратно:
+	const char* filePath = "dephem_test_converter.999";
+	const char* convertedPath = "dephem_test_converter_out.999";
+	const char* headerPath = "header.999";
+	const char* dataPaths[2] = { "ascp01000.999", "ascp02000.999" };
+
+	if (writeFixture(filePath) == false)
+	{
+		return 2;
+	}
+
+	dph::EphemerisRelease reference(filePath, scalarOptions());
+
+	if (reference.isReady() == false)
+	{
+		return 2;
+	}
+
+	std::vector<char> content = readContent(filePath);
+
+	check(writeAscii(reference, content, headerPath, dataPaths, FIXTURE_BLOCKS_COUNT / 2),
+		"ASCII files written");
+
+	// Номер выпуска в файлах ASCII задаётся константой DENUM, которой в
+	// тестовом выпуске нет, поэтому в ожидаемом файле он равен нулю:
+	std::vector<char> expected(content);
+
+	std::memset(&expected[2840], 0, 4);
+
+	std::vector<std::string> dataFiles(dataPaths, dataPaths + 2);
+
+	for (unsigned threadsCount = 1; threadsCount <= 2; ++threadsCount)
+	{
+		check(dph::AsciiConverter::convert(headerPath, dataFiles, convertedPath,
+			threadsCount) && readContent(convertedPath) == expected, "ASCII round trip");
+	}
+
+	std::remove(filePath);
+	std::remove(convertedPath);
+	std::remove(headerPath);
+	std::remove(dataPaths[0]);
+	std::remove(dataPaths[1]);
+
+	return testResult("converter");
+}
@@ -0,0 +1,103 @@
+// ************************************************************************** //
+//                                   epoch                                    //
+//                                                                            //
+//          Двухчастные даты и dph::Epoch против JED одним числом             //
+// -------------------------------------------------------------------------- //
+// Моменты времени, точно представимые одним числом double, задаются          //
+// двухчастной датой (целая часть и доля суток, а также с переносом между     //
+// частями) и подготовленным моментом dph::Epoch. Результаты сравниваются     //
+// побитово с calculateBody/calculateOther скалярного выпуска по JED.         //
+// ************************************************************************** //
+
+#include <cmath>
+
+#include "common.hpp"
+
+int main()
+{
+	const char* filePath = "dephem_test_epoch.999";
+
+	if (writeFixture(filePath) == false)
+	{
+		return 2;
+	}
+
+	dph::EphemerisRelease reference(filePath, scalarOptions());
+	dph::EphemerisRelease release(filePath);
+
+	if (reference.isReady() == false || release.isReady() == false)
+	{
+		return 2;
+	}
+
+	// Моменты времени с шагом 1/64 суток (точно представимы и одним числом,
+	// и целой частью с долей суток):
+	std::vector<double> dates;
+
+	for (double date = reference.startDate(); date <= reference.endDate();
+		date += 3.078125)
+	{
+		dates.push_back(date);
+	}
+
+	dates.push_back(reference.endDate());
+
+	for (size_t i = 0; i < dates.size(); ++i)
+	{
+		double JED1 = std::floor(dates[i]);
+		double JED2 = dates[i] - JED1;
+
+		dph::Epoch epoch;
+
+		check(release.makeEpoch(JED1, JED2, epoch) && epoch.isValid() &&
+			epoch.JED() == dates[i], "epoch");
+
+		for (unsigned target = dph::Body::MERCURY; target <= dph::Body::EMBARY; ++target)
+		{
+			double expected[6], twoPart[6], swapped[6], prepared[6];
+
+			reference.calculateBody(dph::Calculate::STATE, target, dph::Body::SUN,
+				dates[i], expected);
+			release.calculateBody(dph::Calculate::STATE, target, dph::Body::SUN,
+				JED1, JED2, twoPart);
+			release.calculateBody(dph::Calculate::STATE, target, dph::Body::SUN,
+				JED2, JED1, swapped);
+			release.calculateBody(dph::Calculate::STATE, target, dph::Body::SUN,
+				epoch, prepared);
+
+			check(isSame(expected, twoPart, 6), "two-part body");
+			check(isSame(expected, swapped, 6), "swapped two-part body");
+			check(isSame(expected, prepared, 6), "epoch body");
+		}
+
+		for (unsigned item = dph::Other::EARTH_NUTATIONS; item <= dph::Other::TTmTDB;
+			++item)
+		{
+			double expected[6] = { 0 }, twoPart[6] = { 0 }, prepared[6] = { 0 };
+
+			reference.calculateOther(dph::Calculate::STATE, item, dates[i], expected);
+			release.calculateOther(dph::Calculate::STATE, item, JED1, JED2, twoPart);
+			release.calculateOther(dph::Calculate::STATE, item, epoch, prepared);
+
+			check(isSame(expected, twoPart, 6), "two-part other");
+			check(isSame(expected, prepared, 6), "epoch other");
+		}
+	}
+
+	// Моменты вне выпуска и момент по умолчанию не принимаются:
+	dph::Epoch epoch;
+
+	check(release.makeEpoch(release.endDate(), 1e-9, epoch) == false, "after end");
+	check(release.makeEpoch(release.startDate(), -1e-9, epoch) == false, "before start");
+
+	double untouched[3] = { -1, -1, -1 };
+
+	release.calculateBody(dph::Calculate::POSITION, dph::Body::MARS, dph::Body::SUN,
+		dph::Epoch(), untouched);
+
+	check(untouched[0] == -1, "default epoch");
+
+	std::remove(filePath);
+
+	return testResult("epoch");
+}
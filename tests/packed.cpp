@@ -0,0 +1,108 @@
+// ************************************************************************** //
+//                                   packed                                   //
+//                                                                            //
+//                 Упакованный формат против исходного файла JPL              //
+// -------------------------------------------------------------------------- //
+// Выпуск записывается в упакованном формате (dph::PackedWriter) и            //
+// открывается при всех способах доступа и уровнях проверки. Заголовок,       //
+// константы и результаты вычислений сравниваются побитово со скалярным       //
+// выпуском исходного файла.                                                  //
+// ************************************************************************** //
+
+#include "common.hpp"
+#include "dephem/PackedWriter.hpp"
+
+int main()
+{
+	const char* filePath = "dephem_test_packed.999";
+	const char* packedFilePath = "dephem_test_packed.pk";
+
+	if (writeFixture(filePath) == false)
+	{
+		return 2;
+	}
+
+	dph::EphemerisRelease reference(filePath, scalarOptions());
+
+	if (reference.isReady() == false ||
+		dph::PackedWriter::write(reference, packedFilePath) == false)
+	{
+		return 2;
+	}
+
+	std::vector<double> dates = testDates(reference, 400);
+	std::vector<double> expected(dates.size() * 6), result(dates.size() * 6);
+
+	for (unsigned accessMode = dph::Access::STREAM; accessMode <= dph::Access::MEMORY;
+		++accessMode)
+	{
+		for (unsigned validation = dph::Validation::HEADER;
+			validation <= dph::Validation::FULL; ++validation)
+		{
+			dph::ReleaseOptions options;
+			options.accessMode = accessMode;
+			options.validation = validation;
+
+			dph::EphemerisRelease packed(packedFilePath, options);
+
+			check(packed.isReady() && packed.isPacked(), "packed release opened");
+
+			if (packed.isReady() == false)
+			{
+				continue;
+			}
+
+			check(packed.startDate() == reference.startDate() &&
+				packed.endDate() == reference.endDate() &&
+				packed.releaseIndex() == reference.releaseIndex() &&
+				packed.releaseLabel() == reference.releaseLabel(), "packed header");
+
+			check(packed.constantsCount() == reference.constantsCount() &&
+				isSame(packed.constantsValues(), reference.constantsValues(),
+					reference.constantsCount()), "packed constants");
+
+			for (size_t i = 0; i < dates.size(); ++i)
+			{
+				for (unsigned target = dph::Body::MERCURY; target <= dph::Body::EMBARY;
+					++target)
+				{
+					double a[6], b[6];
+
+					reference.calculateBody(dph::Calculate::STATE, target,
+						dph::Body::SSBARY, dates[i], a);
+					packed.calculateBody(dph::Calculate::STATE, target,
+						dph::Body::SSBARY, dates[i], b);
+
+					check(isSame(a, b, 6), "packed body");
+				}
+
+				for (unsigned item = dph::Other::EARTH_NUTATIONS;
+					item <= dph::Other::TTmTDB; ++item)
+				{
+					double a[6] = { 0 }, b[6] = { 0 };
+
+					reference.calculateOther(dph::Calculate::STATE, item, dates[i], a);
+					packed.calculateOther(dph::Calculate::STATE, item, dates[i], b);
+
+					check(isSame(a, b, 6), "packed other");
+				}
+			}
+
+			for (size_t i = 0; i < dates.size(); ++i)
+			{
+				reference.calculateBody(dph::Calculate::STATE, dph::Body::MOON,
+					dph::Body::EARTH, dates[i], &expected[i * 6]);
+			}
+
+			packed.calculateBodySeries(dph::Calculate::STATE, dph::Body::MOON,
+				dph::Body::EARTH, &dates[0], dates.size(), &result[0]);
+
+			check(isSame(&expected[0], &result[0], dates.size() * 6), "packed series");
+		}
+	}
+
+	std::remove(filePath);
+	std::remove(packedFilePath);
+
+	return testResult("packed");
+}
@@ -0,0 +1,263 @@
+// ************************************************************************** //
+//                                  parallel                                  //
+//                                                                            //
+//          calculateBodySeriesParallel против calculateBodySeries            //
+// -------------------------------------------------------------------------- //
+// Упорядоченные и неупорядоченные ряды вычисляются на разном количестве      //
+// потоков (в том числе больше, чем частей ряда) и сравниваются побитово с    //
+// последовательным рядом скалярного выпуска. Также проверяются               //
+// одновременные вызовы из нескольких потоков (пул занят), отказ при          //
+// моменте вне выпуска или неверных датах блока (Validation::LAZY) и          //
+// результат при ошибке чтения блоков.                                        //
+// ************************************************************************** //
+
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+#include "common.hpp"
+#include "dephem/Thread.hpp"
+
+// Одновременный вызов: ряд "JEDs" и результат сравнения с "expected".
+struct ConcurrentCall
+{
+	const dph::EphemerisRelease*	release;
+	const std::vector<double>*		JEDs;
+	const std::vector<double>*		expected;
+	bool							isPassed;
+};
+
+// Функция потока одновременного вызова (аргумент - ConcurrentCall).
+static void runConcurrentCall(void* argument)
+{
+	ConcurrentCall& call = *static_cast<ConcurrentCall*>(argument);
+
+	std::vector<double> result(call.expected->size());
+
+	call.isPassed = call.release->calculateBodySeriesParallel(dph::Calculate::STATE,
+		dph::Body::MOON, dph::Body::EARTH, &(*call.JEDs)[0], call.JEDs->size(),
+			&result[0], 3) && isSame(&result[0], &(*call.expected)[0], result.size());
+}
+
+int main()
+{
+	const char* filePath = "dephem_test_parallel.999";
+
+	if (writeFixture(filePath) == false)
+	{
+		return 2;
+	}
+
+	dph::EphemerisRelease reference(filePath, scalarOptions());
+
+	if (reference.isReady() == false)
+	{
+		return 2;
+	}
+
+	const size_t count = 20000;
+
+	// Упорядоченный (по возрастанию) и неупорядоченный ряды:
+	std::vector<double> ordered(count);
+	std::vector<double> unordered = testDates(reference, count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		ordered[i] = reference.startDate() +
+			(reference.endDate() - reference.startDate()) * i / (count - 1);
+	}
+
+	const std::vector<double>* series[2] = { &ordered, &unordered };
+
+	std::vector<double> expected(count * 6), result(count * 6);
+
+	for (unsigned accessMode = dph::Access::STREAM; accessMode <= dph::Access::MEMORY;
+		++accessMode)
+	{
+		dph::ReleaseOptions options;
+		options.accessMode = accessMode;
+
+		dph::EphemerisRelease release(filePath, options);
+
+		for (unsigned s = 0; s < 2; ++s)
+		{
+			const std::vector<double>& JEDs = *series[s];
+
+			for (unsigned calc = dph::Calculate::POSITION; calc <= dph::Calculate::STATE;
+				++calc)
+			{
+				size_t n = calc == dph::Calculate::STATE ? 6 : 3;
+
+				reference.calculateBodySeries(calc, dph::Body::MARS, dph::Body::EARTH,
+					&JEDs[0], count, &expected[0]);
+
+				const unsigned threadsCounts[] = { 0, 1, 2, 3, 8, 200 };
+
+				for (unsigned t = 0; t < 6; ++t)
+				{
+					result.assign(count * 6, 0.0);
+
+					bool isCalculated = release.calculateBodySeriesParallel(calc,
+						dph::Body::MARS, dph::Body::EARTH, &JEDs[0], count, &result[0],
+							threadsCounts[t]);
+
+					check(isCalculated && isSame(&expected[0], &result[0], count * n),
+						"parallel series");
+				}
+			}
+		}
+	}
+
+	// Одновременные вызовы из нескольких потоков:
+	{
+		dph::EphemerisRelease release(filePath);
+
+		reference.calculateBodySeries(dph::Calculate::STATE, dph::Body::MOON,
+			dph::Body::EARTH, &unordered[0], count, &expected[0]);
+
+		const unsigned CALLS_COUNT = 4;
+
+		ConcurrentCall calls[CALLS_COUNT];
+		dph::Thread threads[CALLS_COUNT];
+
+		for (unsigned i = 0; i < CALLS_COUNT; ++i)
+		{
+			calls[i].release = &release;
+			calls[i].JEDs = &unordered;
+			calls[i].expected = &expected;
+			calls[i].isPassed = false;
+
+			if (threads[i].start(runConcurrentCall, &calls[i]) == false)
+			{
+				runConcurrentCall(&calls[i]);
+			}
+		}
+
+		for (unsigned i = 0; i < CALLS_COUNT; ++i)
+		{
+			threads[i].join();
+
+			check(calls[i].isPassed, "concurrent parallel series");
+		}
+	}
+
+	// Неверные параметры - значения не записываются:
+	{
+		dph::EphemerisRelease release(filePath);
+
+		std::vector<double> outside(ordered);
+		outside[count / 2] = release.endDate() + 1;
+
+		result.assign(count * 6, -1.0);
+
+		check(release.calculateBodySeriesParallel(dph::Calculate::STATE,
+			dph::Body::MARS, dph::Body::EARTH, &outside[0], count, &result[0], 4) ==
+				false && result[0] == -1.0, "rejected parallel series");
+	}
+
+	// Неверные даты последнего блока (проверяются исполнителями при 
+	// Validation::LAZY) - значения не записываются:
+	{
+		std::vector<char> content;
+
+		{
+			std::ifstream file(filePath, std::ios::binary);
+			content.assign(std::istreambuf_iterator<char>(file),
+				std::istreambuf_iterator<char>());
+		}
+
+		// Дата начала последнего блока - последнее вхождение в файл (перед ним
+		// - дата окончания предпоследнего блока):
+		double lastBlockStart = FIXTURE_START_DATE + 
+			FIXTURE_BLOCK_SPAN * (FIXTURE_BLOCKS_COUNT - 1);
+
+		size_t position = content.size();
+
+		for (size_t i = 0; i + sizeof(double) <= content.size(); ++i)
+		{
+			if (std::memcmp(&content[i], &lastBlockStart, sizeof(double)) == 0)
+			{
+				position = i;
+			}
+		}
+
+		dph::ReleaseOptions options;
+		options.validation = dph::Validation::LAZY;
+
+		std::vector<char> corrupted(content);
+		double wrongStart = lastBlockStart + 1;
+
+		if (position != content.size())
+		{
+			std::memcpy(&corrupted[position], &wrongStart, sizeof(double));
+		}
+
+		{
+			std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+			file.write(&corrupted[0], corrupted.size());
+		}
+
+		dph::EphemerisRelease release(filePath, options);
+
+		for (unsigned s = 0; s < 2; ++s)
+		{
+			result.assign(count * 6, -1.0);
+
+			check(position != content.size() && release.calculateBodySeriesParallel(
+				dph::Calculate::POSITION, dph::Body::MARS, dph::Body::EARTH, 
+					&(*series[s])[0], count, &result[0], 4) == false && 
+						result[0] == -1.0, "parallel series with wrong block dates");
+		}
+
+		{
+			std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+			file.write(&content[0], content.size());
+		}
+
+		std::vector<double> undefined(ordered);
+		undefined[count - 1] = std::numeric_limits<double>::quiet_NaN();
+
+		check(release.calculateBodySeriesParallel(dph::Calculate::POSITION,
+			dph::Body::MARS, dph::Body::EARTH, &undefined[0], count, &result[0], 4) ==
+				false && result[0] == -1.0, "parallel series with NaN");
+	}
+
+	// Ошибка чтения: файл усечён после открытия выпуска (проверка только
+	// заголовка), блоки второй половины выпуска не читаются:
+	{
+		dph::ReleaseOptions options;
+		options.validation = dph::Validation::HEADER;
+
+		dph::EphemerisRelease release(filePath, options);
+
+		std::vector<char> content;
+
+		{
+			std::ifstream file(filePath, std::ios::binary);
+			content.assign(std::istreambuf_iterator<char>(file),
+				std::istreambuf_iterator<char>());
+		}
+
+		{
+			std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+			file.write(&content[0], content.size() / 2);
+		}
+
+		check(release.calculateBodySeriesParallel(dph::Calculate::POSITION,
+			dph::Body::MARS, dph::Body::EARTH, &ordered[0], count, &result[0], 4) ==
+				false, "read failure reported");
+
+		{
+			std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+			file.write(&content[0], content.size());
+		}
+
+		check(release.calculateBodySeriesParallel(dph::Calculate::POSITION,
+			dph::Body::MARS, dph::Body::EARTH, &ordered[0], count, &result[0], 4),
+				"recovered after read failure");
+	}
+
+	std::remove(filePath);
+
+	return testResult("parallel");
+}
@@ -0,0 +1,212 @@
+// ************************************************************************** //
+//                                 releaseset                                 //
+//                                                                            //
+//                dph::ReleaseSet против исходного выпуска                    //
+// -------------------------------------------------------------------------- //
+// Тестовый выпуск обрезается (dph::ReleaseTrimmer) на части: смежные (с      //
+// общей датой на стыке), пересекающиеся и с разрывом между ними. Проверяется //
+// выбор файла по моменту времени (в том числе на общей границе и на          //
+// пересечении - файл, добавленный раньше), отказ в разрыве и совпадение      //
+// значений и рядов, проходящих через несколько файлов, с исходным выпуском   //
+// побитово.                                                                  //
+// ************************************************************************** //
+
+#include "common.hpp"
+#include "dephem/ReleaseSet.hpp"
+#include "dephem/ReleaseTrimmer.hpp"
+
+// Дата начала блока "block" тестового выпуска.
+static double blockStart(unsigned block)
+{
+	return FIXTURE_START_DATE + FIXTURE_BLOCK_SPAN * block;
+}
+
+// Обрезать выпуск "release" до блоков "firstBlock" - "lastBlock" (все
+// элементы) в файл "filePath".
+static bool trimBlocks(const dph::EphemerisRelease& release, const char* filePath,
+	unsigned firstBlock, unsigned lastBlock)
+{
+	unsigned allItems[15];
+
+	for (unsigned i = 0; i < 15; ++i)
+	{
+		allItems[i] = i;
+	}
+
+	return dph::ReleaseTrimmer::trim(release, filePath, blockStart(firstBlock) + 1,
+		blockStart(lastBlock) + 1, allItems, 15);
+}
+
+int main()
+{
+	const char* filePath = "dephem_test_releaseset.999";
+
+	// Части: блоки 0 - 9, 10 - 19 (стык с первой), 9 - 19 (пересечение с
+	// первой), 25 - 39 (разрыв после 19):
+	const char* partPaths[4] = { "dephem_test_releaseset_a.999",
+		"dephem_test_releaseset_b.999", "dephem_test_releaseset_c.999",
+			"dephem_test_releaseset_d.999" };
+
+	const unsigned partBlocks[4][2] = { { 0, 9 }, { 10, 19 }, { 9, 19 }, { 25, 39 } };
+
+	if (writeFixture(filePath) == false)
+	{
+		return 2;
+	}
+
+	dph::EphemerisRelease reference(filePath, scalarOptions());
+
+	if (reference.isReady() == false)
+	{
+		return 2;
+	}
+
+	for (unsigned p = 0; p < 4; ++p)
+	{
+		if (trimBlocks(reference, partPaths[p], partBlocks[p][0], partBlocks[p][1]) ==
+			false)
+		{
+			return 2;
+		}
+	}
+
+	// Смежные части и часть после разрыва:
+	{
+		dph::ReleaseSet set;
+
+		check(set.add("dephem_test_releaseset_missing.999") == false &&
+			set.isReady() == false, "missing file is not added");
+
+		check(set.add(partPaths[0], scalarOptions()) &&
+			set.add(partPaths[1], scalarOptions()) &&
+				set.add(partPaths[3], scalarOptions()) && set.releasesCount() == 3,
+					"parts added");
+
+		check(set.startDate() == blockStart(0) && set.endDate() == blockStart(40),
+			"set dates");
+
+		// Разрыв (блоки 20 - 24): файла нет, значения не записываются:
+		double result[6] = { -1, -1, -1, -1, -1, -1 };
+
+		set.calculateBody(dph::Calculate::STATE, dph::Body::MARS, dph::Body::EARTH,
+			blockStart(22), result);
+
+		check(set.contains(blockStart(20)) && set.contains(blockStart(20) + 1) ==
+			false && set.contains(blockStart(25) - 1) == false &&
+				set.contains(blockStart(25)) && set.releaseFor(blockStart(22)) == NULL &&
+					result[0] == -1.0, "gap between parts");
+
+		// Внутри частей и на их общей границе (файл, добавленный раньше):
+		check(set.releaseFor(blockStart(3)) == set.release(0) &&
+			set.releaseFor(blockStart(15)) == set.release(1) &&
+				set.releaseFor(blockStart(30)) == set.release(2), "part for date");
+
+		check(set.releaseFor(blockStart(10)) == set.release(0) &&
+			set.releaseFor(blockStart(25)) == set.release(2), "shared bound");
+	}
+
+	// Обратный порядок добавления - на общей границе вторая часть:
+	{
+		dph::ReleaseSet set;
+
+		set.add(partPaths[1], scalarOptions());
+		set.add(partPaths[0], scalarOptions());
+
+		check(set.releaseFor(blockStart(10)) == set.release(0) &&
+			set.releaseFor(blockStart(10) - 1) == set.release(1),
+				"shared bound in reverse order");
+	}
+
+	// Пересечение (блок 9) - файл, добавленный раньше:
+	{
+		dph::ReleaseSet set;
+
+		set.add(partPaths[2], scalarOptions());
+		set.add(partPaths[0], scalarOptions());
+
+		check(set.releaseFor(blockStart(9) + 5) == set.release(0) &&
+			set.releaseFor(blockStart(9)) == set.release(0) &&
+				set.releaseFor(blockStart(9) - 5) == set.release(1), "overlap priority");
+	}
+
+	// Значения и ряды через стык частей:
+	{
+		dph::ReleaseSet set;
+
+		set.add(partPaths[0], scalarOptions());
+		set.add(partPaths[1], scalarOptions());
+
+		// Моменты времени блоков 0 - 19 (кроме даты стыка: там выпуск
+		// использует следующий блок, а набор - последний блок первой части):
+		const size_t count = 2000;
+
+		std::vector<double> JEDs(count);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			JEDs[i] = blockStart(0) + 0.25 + (blockStart(20) - blockStart(0) - 0.5) *
+				((i * 0.618033988749895) - size_t(i * 0.618033988749895));
+		}
+
+		std::vector<double> expected(count * 6), result(count * 6);
+
+		for (unsigned calc = dph::Calculate::POSITION; calc <= dph::Calculate::STATE;
+			++calc)
+		{
+			size_t n = calc == dph::Calculate::STATE ? 6 : 3;
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				reference.calculateBody(calc, dph::Body::MOON, dph::Body::EARTH, JEDs[i],
+					&expected[i * n]);
+				set.calculateBody(calc, dph::Body::MOON, dph::Body::EARTH, JEDs[i],
+					&result[i * n]);
+			}
+
+			check(isSame(&expected[0], &result[0], count * n), "values across parts");
+
+			// Ряд по моментам времени вразброс (чередуются файлы):
+			result.assign(count * 6, 0.0);
+
+			set.calculateBodySeries(calc, dph::Body::MOON, dph::Body::EARTH, &JEDs[0],
+				count, &result[0]);
+
+			check(isSame(&expected[0], &result[0], count * n), "series across parts");
+
+			// Равномерный ряд через стык (дата стыка не попадает в ряд):
+			double startJED = blockStart(8) + 0.35;
+			double step = 0.7;
+
+			reference.calculateBodySeries(calc, dph::Body::MOON, dph::Body::EARTH,
+				startJED, step, count / 4, &expected[0]);
+
+			result.assign(count * 6, 0.0);
+
+			set.calculateBodySeries(calc, dph::Body::MOON, dph::Body::EARTH, startJED,
+				step, count / 4, &result[0]);
+
+			check(isSame(&expected[0], &result[0], count / 4 * n),
+				"uniform series across parts");
+		}
+
+		// Ряд с моментом вне набора - значения не записываются:
+		JEDs[count / 2] = blockStart(22);
+
+		result.assign(count * 6, -1.0);
+
+		set.calculateBodySeries(dph::Calculate::POSITION, dph::Body::MOON,
+			dph::Body::EARTH, &JEDs[0], count, &result[0]);
+
+		check(result[0] == -1.0 && result[count * 3 - 1] == -1.0,
+			"series outside of set");
+	}
+
+	std::remove(filePath);
+
+	for (unsigned p = 0; p < 4; ++p)
+	{
+		std::remove(partPaths[p]);
+	}
+
+	return testResult("releaseset");
+}
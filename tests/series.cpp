@@ -0,0 +1,118 @@
+// ************************************************************************** //
+//                                   series                                   //
+//                                                                            //
+//     calculateBodySeries / calculateOtherSeries против поточечных вызовов   //
+// -------------------------------------------------------------------------- //
+// Ряды моментов времени (произвольный порядок и равномерный шаг в обе        //
+// стороны) вычисляются при всех способах доступа к файлу и сравниваются      //
+// побитово с calculateBody/calculateOther скалярного выпуска.                //
+// ************************************************************************** //
+
+#include "common.hpp"
+
+int main()
+{
+	const char* filePath = "dephem_test_series.999";
+
+	if (writeFixture(filePath) == false)
+	{
+		return 2;
+	}
+
+	dph::EphemerisRelease reference(filePath, scalarOptions());
+
+	if (reference.isReady() == false)
+	{
+		return 2;
+	}
+
+	const size_t count = 1000;
+
+	std::vector<double> dates = testDates(reference, count);
+	std::vector<double> expected(count * 6), result(count * 6);
+
+	for (unsigned accessMode = dph::Access::STREAM; accessMode <= dph::Access::MEMORY;
+		++accessMode)
+	{
+		dph::ReleaseOptions options;
+		options.accessMode = accessMode;
+
+		dph::EphemerisRelease release(filePath, options);
+
+		for (unsigned calc = dph::Calculate::POSITION; calc <= dph::Calculate::STATE; ++calc)
+		{
+			size_t n = calc == dph::Calculate::STATE ? 6 : 3;
+
+			for (unsigned target = dph::Body::MERCURY; target <= dph::Body::EMBARY; ++target)
+			{
+				unsigned center = target == dph::Body::EARTH ? dph::Body::MOON :
+					dph::Body::EARTH;
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					reference.calculateBody(calc, target, center, dates[i], &expected[i * n]);
+				}
+
+				release.calculateBodySeries(calc, target, center, &dates[0], count,
+					&result[0]);
+
+				check(isSame(&expected[0], &result[0], count * n), "body series");
+
+				// Равномерный ряд вперёд и назад по времени:
+				double step = (release.endDate() - release.startDate()) / count;
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					reference.calculateBody(calc, target, center,
+						release.startDate() + i * step, &expected[i * n]);
+				}
+
+				release.calculateBodySeries(calc, target, center, release.startDate(),
+					step, count, &result[0]);
+
+				check(isSame(&expected[0], &result[0], count * n), "uniform series");
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					reference.calculateBody(calc, target, center,
+						release.endDate() - i * step, &expected[i * n]);
+				}
+
+				release.calculateBodySeries(calc, target, center, release.endDate(),
+					-step, count, &result[0]);
+
+				check(isSame(&expected[0], &result[0], count * n), "backward series");
+			}
+
+			for (unsigned item = dph::Other::EARTH_NUTATIONS; item <= dph::Other::TTmTDB;
+				++item)
+			{
+				size_t m = (item == dph::Other::EARTH_NUTATIONS ? 2 :
+					item == dph::Other::TTmTDB ? 1 : 3) * (calc + 1);
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					reference.calculateOther(calc, item, dates[i], &expected[i * m]);
+				}
+
+				release.calculateOtherSeries(calc, item, &dates[0], count, &result[0]);
+
+				check(isSame(&expected[0], &result[0], count * m), "other series");
+			}
+		}
+
+		// Момент вне выпуска - ни одного значения не записывается:
+		std::vector<double> outside(dates);
+		outside[count / 3] = release.endDate() + 1;
+
+		result.assign(count * 6, -1.0);
+		release.calculateBodySeries(dph::Calculate::STATE, dph::Body::MARS,
+			dph::Body::SUN, &outside[0], count, &result[0]);
+
+		check(result[0] == -1.0 && result[count * 6 - 1] == -1.0, "rejected series");
+	}
+
+	std::remove(filePath);
+
+	return testResult("series");
+}
@@ -0,0 +1,383 @@
+// ************************************************************************** //
+//                                 timescales                                 //
+//                                                                            //
+//                 dph::TimeScales: шкалы UTC, TAI, TT и TDB                  //
+// -------------------------------------------------------------------------- //
+// Проверяются разность TAI - UTC и переводы UTC <-> TAI на границах          //
+// дополнительных секунд (в том числе обратный перевод по таблице моментов в  //
+// шкале TAI и упорядоченные/неупорядоченные массивы), замена и добавление    //
+// дополнительной секунды, знаки переводов TDB <-> TT, выбор разности         //
+// TT - TDB (элемент выпуска внутри его промежутка, аналитическая формула вне //
+// его, без выпуска, без элемента и для моментов, которые выпуск не вычислил) //
+// и переводы UTC -> TDB -> UTC через дополнительную секунду.                 //
+// ************************************************************************** //
+
+#include <cmath>
+#include <fstream>
+#include <iterator>
+
+#include "common.hpp"
+#include "dephem/ReleaseTrimmer.hpp"
+#include "dephem/TimeScales.hpp"
+
+// Количество секунд в сутках.
+static const double SECONDS_PER_DAY = 86400.0;
+
+// Моменты времени "a" и "b" (сутки) отличаются не более чем на "seconds"?
+static bool isNear(double a, double b, double seconds)
+{
+	return std::fabs(a - b) * SECONDS_PER_DAY <= seconds;
+}
+
+// Разность TT - TDB (с) по элементу выпуска "release" на момент "JD".
+static double releaseTTmTDB(const dph::EphemerisRelease& release, double JD)
+{
+	double result = 0;
+
+	release.calculateOther(dph::Calculate::POSITION, dph::Other::TTmTDB, JD, &result);
+
+	return result;
+}
+
+int main()
+{
+	const char* filePath = "dephem_test_timescales.999";
+	const char* trimmedPath = "dephem_test_timescales_notdb.999";
+
+	if (writeFixture(filePath) == false)
+	{
+		return 2;
+	}
+
+	dph::EphemerisRelease reference(filePath, scalarOptions());
+
+	if (reference.isReady() == false)
+	{
+		return 2;
+	}
+
+	// Погрешность переводов туда и обратно (несколько единиц последнего
+	// разряда Юлианской даты, около 40 мкс), с.
+	const double roundTripError = 1e-3;
+
+	// Разность TAI - UTC и переводы UTC <-> TAI:
+	{
+		dph::TimeScales scales;
+
+		// 2017-01-01 (37 с), 1999-01-01 (32 с), до 1972 г. (10 с):
+		const double leap2017 = 2457754.5;
+		const double leap1999 = 2451179.5;
+
+		check(scales.TAImUTC(leap2017 - 1 / SECONDS_PER_DAY) == 36 &&
+			scales.TAImUTC(leap2017) == 37 && scales.TAImUTC(leap2017 + 1000) == 37 &&
+				scales.TAImUTC(leap1999) == 32 && scales.TAImUTC(2400000.5) == 10,
+					"TAI - UTC");
+
+		// UTC -> TAI на границе и обратно (по моментам в шкале TAI):
+		const double leapDates[2] = { leap1999, leap2017 };
+
+		for (unsigned l = 0; l < 2; ++l)
+		{
+			double leap = leapDates[l];
+			double before = scales.TAImUTC(leap - 1);
+			double after = scales.TAImUTC(leap);
+
+			double utc[4] = { leap - 1 / SECONDS_PER_DAY, leap - 1e-3 / SECONDS_PER_DAY,
+				leap, leap + 1 / SECONDS_PER_DAY };
+
+			double shifts[4] = { before, before, after, after };
+
+			for (unsigned i = 0; i < 4; ++i)
+			{
+				double tai = scales.convert(dph::TimeScale::UTC, dph::TimeScale::TAI,
+					utc[i]);
+
+				check(isNear(tai, utc[i] + shifts[i] / SECONDS_PER_DAY, roundTripError) &&
+					isNear(scales.convert(dph::TimeScale::TAI, dph::TimeScale::UTC, tai),
+						utc[i], roundTripError), "UTC <-> TAI at leap second");
+			}
+
+			// Момент дополнительной секунды (UTC) переходит в начало промежутка
+			// обратной таблицы:
+			check(isNear(scales.convert(dph::TimeScale::TAI, dph::TimeScale::UTC,
+				scales.convert(dph::TimeScale::UTC, dph::TimeScale::TAI, leap)), leap,
+					roundTripError), "TAI -> UTC at leap second");
+		}
+
+		// Массивы (упорядоченный и обратный) совпадают с поэлементным
+		// переводом побитово:
+		const size_t count = 2000;
+
+		std::vector<double> JDs(count), result(count);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			JDs[i] = 2441000.5 + 17000.0 * i / count;
+		}
+
+		for (unsigned order = 0; order < 2; ++order)
+		{
+			for (unsigned forward = 0; forward < 2; ++forward)
+			{
+				unsigned from = forward ? dph::TimeScale::UTC : dph::TimeScale::TAI;
+				unsigned to = forward ? dph::TimeScale::TAI : dph::TimeScale::UTC;
+
+				scales.convert(from, to, &JDs[0], count, &result[0]);
+
+				bool isPassed = true;
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					isPassed = isPassed && result[i] == scales.convert(from, to, JDs[i]);
+				}
+
+				check(isPassed, "UTC <-> TAI series");
+			}
+
+			std::reverse(JDs.begin(), JDs.end());
+		}
+
+		// Перевод на месте:
+		std::vector<double> inPlace(JDs);
+
+		scales.convert(dph::TimeScale::UTC, dph::TimeScale::TAI, &JDs[0], count,
+			&result[0]);
+		scales.convert(dph::TimeScale::UTC, dph::TimeScale::TAI, &inPlace[0], count,
+			&inPlace[0]);
+
+		check(isSame(&result[0], &inPlace[0], count), "conversion in place");
+	}
+
+	// Замена и добавление дополнительных секунд:
+	{
+		dph::TimeScales scales;
+
+		const double leap2017 = 2457754.5;
+		const double leapNew = 2460000.5;
+
+		// Замена значения (обратная таблица тоже обновляется):
+		scales.addLeapSecond(leap2017, 38);
+
+		check(scales.TAImUTC(leap2017 - 1) == 36 && scales.TAImUTC(leap2017) == 38 &&
+			isNear(scales.convert(dph::TimeScale::TAI, dph::TimeScale::UTC,
+				leap2017 + 38 / SECONDS_PER_DAY), leap2017, roundTripError) &&
+					isNear(scales.convert(dph::TimeScale::TAI, dph::TimeScale::UTC,
+						leap2017 + 37.5 / SECONDS_PER_DAY), leap2017 + 1.5 / SECONDS_PER_DAY,
+							roundTripError), "replaced leap second");
+
+		// Новая дополнительная секунда:
+		scales.addLeapSecond(leapNew, 39);
+
+		check(scales.TAImUTC(leapNew - 1) == 38 && scales.TAImUTC(leapNew) == 39 &&
+			isNear(scales.convert(dph::TimeScale::UTC, dph::TimeScale::TAI, leapNew),
+				leapNew + 39 / SECONDS_PER_DAY, roundTripError), "added leap second");
+	}
+
+	// Разность TT - TDB (моменты внутри и вне тестового выпуска):
+	const double inside = FIXTURE_START_DATE + FIXTURE_BLOCK_SPAN * 7.3;
+	const double outside = FIXTURE_START_DATE - 100;
+
+	// Без выпуска - аналитическая формула. Знаки: TDB - TT около +1.66 мс в
+	// начале апреля (2000-04-03), TT = TDB + (TT - TDB):
+	{
+		dph::TimeScales scales;
+
+		const double april = 2451637.5;
+
+		double TTmTDB = dph::TimeScales::analyticTTmTDB(april);
+
+		check(scales.usesRelease() == false && scales.TTmTDB(april) == TTmTDB &&
+			TTmTDB < -1.5e-3 && TTmTDB > -1.8e-3, "analytic TT - TDB");
+
+		check(scales.convert(dph::TimeScale::TDB, dph::TimeScale::TT, april) ==
+			april + 1 / SECONDS_PER_DAY * TTmTDB &&
+				scales.convert(dph::TimeScale::TT, dph::TimeScale::TDB, april) ==
+					april + -1 / SECONDS_PER_DAY * TTmTDB &&
+						scales.convert(dph::TimeScale::TT, dph::TimeScale::TDB, april) >
+							april, "TDB <-> TT signs");
+	}
+
+	// С выпуском - элемент выпуска внутри промежутка, формула вне его:
+	{
+		dph::TimeScales scales(&reference);
+
+		check(scales.usesRelease() && scales.release() == &reference,
+			"release TT - TDB");
+
+		check(scales.TTmTDB(inside) == releaseTTmTDB(reference, inside) &&
+			scales.TTmTDB(outside) == dph::TimeScales::analyticTTmTDB(outside) &&
+				scales.TTmTDB(inside) != dph::TimeScales::analyticTTmTDB(inside),
+					"TT - TDB source");
+
+		// Массив с моментами внутри и вне выпуска (выбор для каждого момента):
+		double JDs[4] = { outside, inside, reference.endDate() + 1, reference.startDate() };
+		double result[4];
+
+		scales.convert(dph::TimeScale::TDB, dph::TimeScale::TT, JDs, 4, result);
+
+		check(result[0] == JDs[0] + 1 / SECONDS_PER_DAY *
+			dph::TimeScales::analyticTTmTDB(JDs[0]) &&
+				result[1] == JDs[1] + 1 / SECONDS_PER_DAY * releaseTTmTDB(reference, JDs[1]) &&
+					result[2] == JDs[2] + 1 / SECONDS_PER_DAY *
+						dph::TimeScales::analyticTTmTDB(JDs[2]) &&
+							result[3] == JDs[3] + 1 / SECONDS_PER_DAY *
+								releaseTTmTDB(reference, JDs[3]), "TT - TDB per date");
+
+		// Без выпуска снова аналитическая формула:
+		scales.setRelease(NULL);
+
+		check(scales.usesRelease() == false &&
+			scales.TTmTDB(inside) == dph::TimeScales::analyticTTmTDB(inside),
+				"release removed");
+	}
+
+	// Выпуск без элемента TT - TDB:
+	{
+		unsigned items[14];
+
+		for (unsigned i = 0; i < 14; ++i)
+		{
+			items[i] = i;
+		}
+
+		bool isTrimmed = dph::ReleaseTrimmer::trim(reference, trimmedPath, 0, 1e10,
+			items, 14);
+
+		dph::EphemerisRelease trimmed(trimmedPath, scalarOptions());
+		dph::TimeScales scales(&trimmed);
+
+		check(isTrimmed && trimmed.isReady() && scales.usesRelease() == false &&
+			scales.TTmTDB(inside) == dph::TimeScales::analyticTTmTDB(inside),
+				"release without TT - TDB");
+	}
+
+	// Моменты, не вычисленные выпуском (неверные даты последнего блока при
+	// Validation::LAZY) - аналитическая формула:
+	{
+		std::vector<char> content;
+
+		{
+			std::ifstream file(filePath, std::ios::binary);
+			content.assign(std::istreambuf_iterator<char>(file),
+				std::istreambuf_iterator<char>());
+		}
+
+		double lastBlockStart = FIXTURE_START_DATE +
+			FIXTURE_BLOCK_SPAN * (FIXTURE_BLOCKS_COUNT - 1);
+
+		size_t position = content.size();
+
+		for (size_t i = 0; i + sizeof(double) <= content.size(); ++i)
+		{
+			if (std::memcmp(&content[i], &lastBlockStart, sizeof(double)) == 0)
+			{
+				position = i;
+			}
+		}
+
+		std::vector<char> corrupted(content);
+		double wrongStart = lastBlockStart + 1;
+
+		if (position != content.size())
+		{
+			std::memcpy(&corrupted[position], &wrongStart, sizeof(double));
+		}
+
+		{
+			std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+			file.write(&corrupted[0], corrupted.size());
+		}
+
+		dph::ReleaseOptions options;
+		options.validation = dph::Validation::LAZY;
+
+		dph::EphemerisRelease release(filePath, options);
+		dph::TimeScales scales(&release);
+
+		double JD = lastBlockStart + 3;
+		double result = 0;
+
+		scales.convert(dph::TimeScale::TDB, dph::TimeScale::TT, &JD, 1, &result);
+
+		check(position != content.size() && scales.usesRelease() &&
+			result == JD + 1 / SECONDS_PER_DAY * dph::TimeScales::analyticTTmTDB(JD) &&
+				scales.TTmTDB(JD) == dph::TimeScales::analyticTTmTDB(JD),
+					"analytic fallback for rejected block");
+
+		{
+			std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+			file.write(&content[0], content.size());
+		}
+	}
+
+	// UTC -> TDB по шагам через дополнительную секунду:
+	{
+		dph::TimeScales scales(&reference);
+
+		// Дополнительная секунда внутри промежутка выпуска:
+		const double leap = FIXTURE_START_DATE + FIXTURE_BLOCK_SPAN * 20;
+
+		scales.addLeapSecond(leap, 33);
+
+		double utc[4] = { leap - 1 / SECONDS_PER_DAY, leap, leap + 0.5 / SECONDS_PER_DAY,
+			2451179.5 };
+
+		for (unsigned i = 0; i < 4; ++i)
+		{
+			// По шагам: UTC -> TAI -> TT -> TDB:
+			double tai = scales.convert(dph::TimeScale::UTC, dph::TimeScale::TAI, utc[i]);
+			double tt = scales.convert(dph::TimeScale::TAI, dph::TimeScale::TT, tai);
+			double tdb = scales.convert(dph::TimeScale::TT, dph::TimeScale::TDB, tt);
+
+			check(scales.convert(dph::TimeScale::UTC, dph::TimeScale::TDB, utc[i]) == tdb &&
+				isNear(tai, utc[i] + scales.TAImUTC(utc[i]) / SECONDS_PER_DAY,
+					roundTripError) && isNear(tt, tai + 32.184 / SECONDS_PER_DAY,
+						roundTripError), "UTC -> TDB steps");
+		}
+
+		check(scales.TAImUTC(utc[0]) == 32 && scales.TAImUTC(utc[1]) == 33,
+			"leap second inside release");
+
+		// Положения тел по моментам UTC совпадают с положениями по TDB:
+		std::vector<double> tdb(4), expected(12), result(12);
+
+		scales.convert(dph::TimeScale::UTC, dph::TimeScale::TDB, utc, 3, &tdb[0]);
+
+		reference.calculateBodySeries(dph::Calculate::POSITION, dph::Body::MARS,
+			dph::Body::EARTH, &tdb[0], 3, &expected[0]);
+		scales.calculateBodySeries(dph::TimeScale::UTC, dph::Calculate::POSITION,
+			dph::Body::MARS, dph::Body::EARTH, utc, 3, &result[0]);
+
+		check(isSame(&expected[0], &result[0], 9), "body series in UTC");
+	}
+
+	// Туда и обратно по аналитической формуле (TT - TDB в тестовом выпуске не
+	// мала, и обратный перевод TT -> TDB по моменту TT для него не точен):
+	{
+		dph::TimeScales scales;
+
+		const double leapDates[2] = { 2451179.5, 2457754.5 };
+
+		for (unsigned l = 0; l < 2; ++l)
+		{
+			double utc[3] = { leapDates[l] - 1 / SECONDS_PER_DAY, leapDates[l],
+				leapDates[l] + 0.5 / SECONDS_PER_DAY };
+
+			for (unsigned i = 0; i < 3; ++i)
+			{
+				double tdb = scales.convert(dph::TimeScale::UTC, dph::TimeScale::TDB, utc[i]);
+
+				check(isNear(tdb, utc[i] + (scales.TAImUTC(utc[i]) + 32.184 -
+					dph::TimeScales::analyticTTmTDB(tdb)) / SECONDS_PER_DAY,
+						roundTripError) && isNear(scales.convert(dph::TimeScale::TDB,
+							dph::TimeScale::UTC, tdb), utc[i], roundTripError),
+								"UTC -> TDB -> UTC");
+			}
+		}
+	}
+
+	std::remove(filePath);
+	std::remove(trimmedPath);
+
+	return testResult("timescales");
+}
@@ -0,0 +1,137 @@
+// ************************************************************************** //
+//                                  trimmer                                   //
+//                                                                            //
+//                dph::ReleaseTrimmer против исходного выпуска                //
+// -------------------------------------------------------------------------- //
+// Выпуск обрезается до части блоков и одного барицентра Земля-Луна: запись   //
+// такого файла мала для заголовка, поэтому в неё добавляется                 //
+// элемент-заполнитель. Проверяется, что заполнитель не считается элементом   //
+// выпуска (hasItem(...), константа dph::BinaryWriter::FILLER_CONSTANT), что  //
+// значения по обрезанному файлу совпадают с исходными побитово и что         //
+// повторная обрезка обрезанного файла даёт тот же файл. Также сверяется      //
+// обрезка всех элементов (без заполнителя): файл совпадает с исходным, кроме //
+// строк информации о выпуске с датами.                                       //
+// ************************************************************************** //
+
+#include <fstream>
+#include <iterator>
+
+#include "common.hpp"
+#include "dephem/ReleaseTrimmer.hpp"
+
+// Содержимое файла "filePath" от байта "offset".
+static std::vector<char> readContent(const char* filePath, size_t offset = 0)
+{
+	std::ifstream file(filePath, std::ios::binary);
+
+	std::vector<char> content((std::istreambuf_iterator<char>(file)),
+		std::istreambuf_iterator<char>());
+
+	content.erase(content.begin(), content.begin() +
+		(offset < content.size() ? offset : content.size()));
+
+	return content;
+}
+
+int main()
+{
+	const char* filePath = "dephem_test_trimmer.999";
+	const char* trimmedPath = "dephem_test_trimmer_emb.999";
+	const char* retrimmedPath = "dephem_test_trimmer_emb2.999";
+	const char* fullPath = "dephem_test_trimmer_full.999";
+
+	if (writeFixture(filePath) == false)
+	{
+		return 2;
+	}
+
+	dph::EphemerisRelease reference(filePath, scalarOptions());
+
+	if (reference.isReady() == false)
+	{
+		return 2;
+	}
+
+	// Барицентр Земля-Луна (базовый элемент 2) на блоках 5 - 12:
+	double startJED = FIXTURE_START_DATE + FIXTURE_BLOCK_SPAN * 5 + 3;
+	double endJED = FIXTURE_START_DATE + FIXTURE_BLOCK_SPAN * 12 + 7;
+
+	const unsigned embItem = 2;
+
+	check(dph::ReleaseTrimmer::trim(reference, trimmedPath, startJED, endJED,
+		&embItem, 1), "trim to EMB");
+
+	dph::EphemerisRelease trimmed(trimmedPath, scalarOptions());
+
+	check(trimmed.isReady(), "trimmed release is ready");
+
+	// Из элементов выпуска есть только барицентр Земля-Луна:
+	check(trimmed.hasItem(dph::Body::EMBARY) && trimmed.hasItem(dph::Body::SSBARY),
+		"trimmed release has EMB");
+
+	for (unsigned item = dph::Body::MERCURY; item <= dph::Other::TTmTDB; ++item)
+	{
+		if (item != dph::Body::EMBARY && item != dph::Body::SSBARY)
+		{
+			check(trimmed.hasItem(item) == false, "no other items in trimmed release");
+		}
+	}
+
+	// Заполнитель отмечен константой (последней), остальные константы
+	// сохранены:
+	check(trimmed.constantsCount() == reference.constantsCount() + 1 &&
+		trimmed.constant(dph::BinaryWriter::FILLER_CONSTANT) == 12 &&
+			trimmed.constant("CLIGHT") == reference.constant("CLIGHT"),
+				"filler constant");
+
+	// Значения по обрезанному файлу:
+	check(trimmed.startDate() == FIXTURE_START_DATE + FIXTURE_BLOCK_SPAN * 5 &&
+		trimmed.endDate() == FIXTURE_START_DATE + FIXTURE_BLOCK_SPAN * 13,
+			"trimmed dates");
+
+	// Кроме даты окончания (в исходном выпуске это начало следующего блока):
+	std::vector<double> dates = testDates(trimmed, 200);
+
+	for (size_t i = 0; i + 1 < dates.size(); ++i)
+	{
+		for (unsigned calc = dph::Calculate::POSITION; calc <= dph::Calculate::STATE;
+			++calc)
+		{
+			double expected[6] = { 0 }, result[6] = { 0 };
+
+			reference.calculateBody(calc, dph::Body::EMBARY, dph::Body::SSBARY,
+				dates[i], expected);
+			trimmed.calculateBody(calc, dph::Body::EMBARY, dph::Body::SSBARY,
+				dates[i], result);
+
+			check(isSame(expected, result, 6), "trimmed EMB");
+		}
+	}
+
+	// Повторная обрезка (константа заполнителя не копируется, а добавляется
+	// заново):
+	check(dph::ReleaseTrimmer::trim(trimmed, retrimmedPath, 0, 1e10, &embItem, 1) &&
+		readContent(trimmedPath) == readContent(retrimmedPath), "retrimmed file");
+
+	// Все элементы на всём промежутке (запись достаточна, заполнителя нет):
+	unsigned allItems[15];
+
+	for (unsigned i = 0; i < 15; ++i)
+	{
+		allItems[i] = i;
+	}
+
+	// Строки информации о выпуске (3 по 84 символа) с датами пропускаются:
+	const size_t labelsSize = 3 * 84;
+
+	check(dph::ReleaseTrimmer::trim(reference, fullPath, 0, 1e10, allItems, 15) &&
+		readContent(filePath, labelsSize) == readContent(fullPath, labelsSize),
+			"full trim is identical");
+
+	std::remove(filePath);
+	std::remove(trimmedPath);
+	std::remove(retrimmedPath);
+	std::remove(fullPath);
+
+	return testResult("trimmer");
+}